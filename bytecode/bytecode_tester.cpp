@@ -485,6 +485,10 @@ Vector<Ref<GDScriptDecomp>> BytecodeTester::get_possible_decomps(Vector<String>
 	return get_possibles_from_set(bytecode_files, decomps, print_verbosely);
 }
 
+Vector<Ref<GDScriptDecomp>> BytecodeTester::get_passing_decomps(const Vector<String> &p_bytecode_files, const Vector<Ref<GDScriptDecomp>> &p_decomps, bool print_verbosely) {
+	return get_possibles_from_set(p_bytecode_files, p_decomps, print_verbosely);
+}
+
 Vector<Ref<GDScriptDecomp>> BytecodeTester::filter_decomps(const Vector<Ref<GDScriptDecomp>> &p_decomp_versions, int ver_major_hint, int ver_minor_hint) {
 	Vector<Ref<GDScriptDecomp>> candidates;
 	if (ver_major_hint > 0 && ver_minor_hint < 0) {
@@ -14,4 +14,6 @@ public:
 	static uint64_t test_files(const Vector<String> &p_paths, int ver_major_hint = -1, int ver_minor_hint = -1, bool print_verbosely = false);
 	static Vector<Ref<GDScriptDecomp>> filter_decomps(const Vector<Ref<GDScriptDecomp>> &decomps, int ver_major_hint, int ver_minor_hint);
 	static Vector<Ref<GDScriptDecomp>> get_possible_decomps(Vector<String> bytecode_files, bool include_dev = false, bool print_verbosely = false);
+	// The subset of p_decomps that pass every file in p_bytecode_files.
+	static Vector<Ref<GDScriptDecomp>> get_passing_decomps(const Vector<String> &p_bytecode_files, const Vector<Ref<GDScriptDecomp>> &p_decomps, bool print_verbosely = false);
 };
\ No newline at end of file
@@ -786,9 +786,7 @@ void FakeMesh::_set_surfaces(const Array &p_surfaces) {
 	// 	RS::get_singleton()->mesh_set_path(mesh, get_path());
 	// }
 
-	for (int i = 0; i < surface_data.size(); i++) {
-		surface_arrays.push_back(RenderingServer::get_singleton()->mesh_create_arrays_from_surface_data(surface_data[i]));
-	}
+	_reset_surface_arrays();
 
 	surfaces.clear();
 
@@ -907,8 +905,7 @@ void FakeMesh::add_surface(BitField<ArrayFormat> p_format, PrimitiveType p_primi
 	sd.uv_scale = p_uv_scale;
 
 	surface_data.push_back(sd);
-	Array arr = RenderingServer::get_singleton()->mesh_create_arrays_from_surface_data(sd);
-	surface_arrays.push_back(arr);
+	_reset_surface_arrays();
 
 	clear_cache();
 	notify_property_list_changed();
@@ -937,10 +934,45 @@ void FakeMesh::add_surface_from_arrays(PrimitiveType p_primitive, const Array &p
 	add_surface(surface.format, PrimitiveType(surface.primitive), surface.vertex_data, surface.attribute_data, surface.skin_data, surface.vertex_count, surface.index_data, surface.index_count, surface.aabb, surface.blend_shape_data, surface.bone_aabbs, surface.lods, surface.uv_scale);
 }
 
+void FakeMesh::_reset_surface_arrays() {
+	MutexLock lock(surface_arrays_mutex);
+	surface_arrays.clear();
+	surface_arrays.resize(surface_data.size());
+}
+
+const FakeMesh::SurfaceArrays &FakeMesh::surface_get_decoded_arrays(int p_surface) const {
+	static const SurfaceArrays empty;
+	MutexLock lock(surface_arrays_mutex);
+	ERR_FAIL_INDEX_V(p_surface, (int)surface_arrays.size(), empty);
+	SurfaceArrays &sa = surface_arrays[p_surface];
+	if (sa.decoded) {
+		return sa;
+	}
+	// The engine's decoder handles every surface format version and compression mode; we only keep its output typed.
+	sa.arrays = RenderingServer::get_singleton()->mesh_create_arrays_from_surface_data(surface_data[p_surface]);
+	sa.decoded = true;
+	if (sa.arrays.size() != ARRAY_MAX) {
+		return sa;
+	}
+	if (sa.arrays[ARRAY_VERTEX].get_type() == Variant::PACKED_VECTOR2_ARRAY) {
+		sa.vertices_2d = sa.arrays[ARRAY_VERTEX];
+	} else {
+		sa.vertices = sa.arrays[ARRAY_VERTEX];
+	}
+	sa.normals = sa.arrays[ARRAY_NORMAL];
+	sa.tangents = sa.arrays[ARRAY_TANGENT];
+	sa.colors = sa.arrays[ARRAY_COLOR];
+	sa.uvs = sa.arrays[ARRAY_TEX_UV];
+	sa.uv2s = sa.arrays[ARRAY_TEX_UV2];
+	sa.bones = sa.arrays[ARRAY_BONES];
+	sa.weights = sa.arrays[ARRAY_WEIGHTS];
+	sa.indices = sa.arrays[ARRAY_INDEX];
+	return sa;
+}
+
 Array FakeMesh::surface_get_arrays(int p_surface) const {
 	ERR_FAIL_INDEX_V(p_surface, surfaces.size(), Array());
-	// return RenderingServer::get_singleton()->mesh_surface_get_arrays(mesh, p_surface);
-	return surface_arrays[p_surface];
+	return surface_get_decoded_arrays(p_surface).arrays;
 }
 
 TypedArray<Array> FakeMesh::surface_get_blend_shape_arrays(int p_surface) const {
@@ -1178,6 +1210,8 @@ void FakeMesh::clear_surfaces() {
 	// }
 	// RS::get_singleton()->mesh_clear(mesh);
 	surfaces.clear();
+	surface_data.clear();
+	_reset_surface_arrays();
 	aabb = AABB();
 }
 
@@ -1186,7 +1220,10 @@ void FakeMesh::surface_remove(int p_surface) {
 	// RS::get_singleton()->mesh_surface_remove(mesh, p_surface);
 	surfaces.remove_at(p_surface);
 	surface_data.remove_at(p_surface);
-	surface_arrays.remove_at(p_surface);
+	{
+		MutexLock lock(surface_arrays_mutex);
+		surface_arrays.remove_at(p_surface);
+	}
 
 	clear_cache();
 	_recompute_aabb();
@@ -32,6 +32,8 @@
 #include "core/io/resource.h"
 #include "core/math/face3.h"
 #include "core/math/triangle_mesh.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "scene/resources/material.h"
 #include "servers/rendering_server.h"
 
@@ -80,13 +82,36 @@ private:
 
 	// fake members
 public:
+	// A surface's arrays decoded into typed buffers, laid out as in Mesh::ArrayType.
+	// Arrays the surface doesn't have are empty.
+	struct SurfaceArrays {
+		PackedVector3Array vertices;
+		PackedVector2Array vertices_2d;
+		PackedVector3Array normals;
+		PackedFloat32Array tangents;
+		PackedColorArray colors;
+		PackedVector2Array uvs;
+		PackedVector2Array uv2s;
+		PackedInt32Array bones;
+		PackedFloat32Array weights;
+		PackedInt32Array indices;
+		// The same buffers as a Mesh::surface_get_arrays() array (shared, not copied).
+		Array arrays;
+		bool decoded = false;
+	};
+
 	Vector<RS::SurfaceData> surface_data;
-	Vector<Array> surface_arrays;
 	ResourceInfo::LoadType load_type = ResourceInfo::LoadType::ERR;
 
 	_FORCE_INLINE_ void _create_if_empty() const;
 	void _recompute_aabb();
 
+private:
+	// Decoded on first use rather than on load; most fake-loaded meshes are never decoded.
+	mutable LocalVector<SurfaceArrays> surface_arrays;
+	mutable BinaryMutex surface_arrays_mutex;
+	void _reset_surface_arrays();
+
 protected:
 	virtual bool _is_generated() const { return false; }
 
@@ -105,6 +130,8 @@ public:
 	void add_surface(BitField<ArrayFormat> p_format, PrimitiveType p_primitive, const Vector<uint8_t> &p_array, const Vector<uint8_t> &p_attribute_array, const Vector<uint8_t> &p_skin_array, int p_vertex_count, const Vector<uint8_t> &p_index_array, int p_index_count, const AABB &p_aabb, const Vector<uint8_t> &p_blend_shape_data = Vector<uint8_t>(), const Vector<AABB> &p_bone_aabbs = Vector<AABB>(), const Vector<RS::SurfaceData::LOD> &p_lods = Vector<RS::SurfaceData::LOD>(), const Vector4 p_uv_scale = Vector4());
 
 	Array surface_get_arrays(int p_surface) const override;
+	// Typed, decode-once view of a surface for exporters; valid until the surfaces change.
+	const SurfaceArrays &surface_get_decoded_arrays(int p_surface) const;
 	TypedArray<Array> surface_get_blend_shape_arrays(int p_surface) const override;
 	Dictionary surface_get_lods(int p_surface) const override;
 
@@ -278,6 +278,49 @@ Vector<String> OptimizedTranslationExtractor::get_translated_message_list() cons
 	return msgs;
 }
 
+int OptimizedTranslationExtractor::get_message_count() const {
+	const uint32_t *htptr = (const uint32_t *)hash_table.ptr();
+	const uint32_t *btptr = (const uint32_t *)bucket_table.ptr();
+	int count = 0;
+	for (int i = 0; i < hash_table.size(); i++) {
+		uint32_t p = htptr[i];
+		if (p != 0xFFFFFFFF) {
+			count += ((const Bucket *)&btptr[p])->size;
+		}
+	}
+	return count;
+}
+
+bool OptimizedTranslationExtractor::MessageIterator::next(CharString &r_utf8) {
+	ERR_FAIL_COND_V(translation.is_null(), false);
+	const uint32_t *htptr = (const uint32_t *)translation->hash_table.ptr();
+	const uint32_t *btptr = (const uint32_t *)translation->bucket_table.ptr();
+	const char *sptr = (const char *)translation->strings.ptr();
+
+	for (; table_idx < translation->hash_table.size(); table_idx++, elem_idx = 0) {
+		uint32_t p = htptr[table_idx];
+		if (p == 0xFFFFFFFF) {
+			continue;
+		}
+		const Bucket &bucket = *(const Bucket *)&btptr[p];
+		if (elem_idx >= bucket.size) {
+			continue;
+		}
+		const Bucket::Elem &elem = bucket.elem[elem_idx++];
+		r_utf8.resize_uninitialized(elem.uncomp_size + 1);
+		if (elem.comp_size == elem.uncomp_size) {
+			memcpy(r_utf8.ptrw(), &sptr[elem.str_offset], elem.uncomp_size);
+		} else {
+			smaz_decompress(&sptr[elem.str_offset], elem.comp_size, r_utf8.ptrw(), elem.uncomp_size);
+		}
+		// the stored size may include the terminator
+		r_utf8.ptrw()[elem.uncomp_size] = 0;
+		r_utf8.resize_uninitialized(strlen(r_utf8.get_data()) + 1);
+		return true;
+	}
+	return false;
+}
+
 StringName OptimizedTranslationExtractor::get_plural_message(const StringName &p_src_text, const StringName &p_plural_text, int p_n, const StringName &p_context) const {
 	// The use of plurals translation is not yet supported in OptimizedTranslationExtractor.
 	return get_message(p_src_text, p_context);
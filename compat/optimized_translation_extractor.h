@@ -58,6 +58,22 @@ public:
 	String get_message_str(const String &p_src_text) const;
 	String get_message_str(const char *p_src_text) const;
 	static Ref<OptimizedTranslationExtractor> create_from(const Ref<OptimizedTranslation> &p_otr);
+	int get_message_count() const;
+
+	// Walks the messages in get_translated_message_list() order, decoding one message at a time.
+	class MessageIterator {
+		Ref<OptimizedTranslationExtractor> translation;
+		int table_idx = 0;
+		int elem_idx = 0;
+
+	public:
+		// Writes the next message to r_utf8 (null-terminated); returns false once all messages were read.
+		bool next(CharString &r_utf8);
+		MessageIterator() {}
+		MessageIterator(const Ref<OptimizedTranslationExtractor> &p_translation) :
+				translation(p_translation) {}
+	};
+
 	OptimizedTranslationExtractor() {}
 };
 static_assert(sizeof(OptimizedTranslationExtractor) == sizeof(OptimizedTranslation), "OptimizedTranslationExtractor should have the same size as OptimizedTranslation");
@@ -35,8 +35,10 @@
 #include "core/error/error_macros.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/missing_resource.h"
 #include "core/io/resource.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/version.h"
 #include "scene/resources/packed_scene.h"
 
@@ -44,6 +46,8 @@
 
 #include "compat/fake_scene_state.h"
 #include "compat/image_parser_v2.h"
+#include "utility/common.h"
+#include "utility/gdre_config.h"
 #include "utility/gdre_settings.h"
 #include "utility/resource_info.h"
 
@@ -181,7 +185,117 @@ StringName ResourceLoaderCompatBinary::_get_string() {
 	return string_map[id];
 }
 
+Variant ResourceLoaderCompatBinary::_get_internal_resource_ref(uint32_t p_index) {
+	String path;
+	if (using_named_scene_ids) { // New format.
+		path = internal_resources[p_index].path;
+	} else {
+		path += res_path + "::" + itos(p_index);
+	}
+
+	//always use internal cache for loading internal resources
+	if (!internal_index_cache.has(path)) {
+		WARN_PRINT(vformat("Couldn't load resource (no cache): %s.", path));
+		return Variant();
+	}
+	return internal_index_cache[path];
+}
+
+Variant ResourceLoaderCompatBinary::_get_external_resource_by_path(const String &p_type, const String &p_path) {
+	String path = p_path;
+	if (!path.contains("://") && path.is_relative_path()) {
+		// path is relative to file being loaded, so convert to a resource path
+		path = GDRESettings::get_singleton()->localize_path(res_path.get_base_dir().path_join(path));
+	}
+
+	if (remaps.find(path)) {
+		path = remaps[path];
+	}
+	Error err;
+	Ref<Resource> res = !is_real_load() ? CompatFormatLoader::create_missing_external_resource(path, p_type, ResourceUID::INVALID_ID) : ResourceCompatLoader::custom_load(path, p_type, load_type, &err, use_sub_threads, cache_mode_for_external);
+
+	if (res.is_null()) {
+		WARN_PRINT(vformat("Couldn't load resource: %s.", path));
+	}
+	return res;
+}
+
+Error ResourceLoaderCompatBinary::_get_external_resource_by_index(int p_index, Variant &r_v) {
+	if (p_index < 0 || p_index >= external_resources.size()) {
+		WARN_PRINT("Broken external resource! (index out of size)");
+		r_v = Variant();
+		return OK;
+	}
+	Ref<ResourceLoader::LoadToken> &load_token = external_resources.write[p_index].load_token;
+	if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
+		Error err;
+		Ref<Resource> res = finish_ext_load(load_token, &err);
+		if (res.is_null()) {
+			if (!is_real_load()) {
+				error = ERR_FILE_MISSING_DEPENDENCIES;
+				ERR_FAIL_V_MSG(error, "WE SHOULD NEVER GET HERE!!!!!!!!!!!!!!!!!!!  : Can't load dependency: " + external_resources[p_index].path + ".");
+			}
+			if (!ResourceLoader::is_cleaning_tasks()) {
+				if (!ResourceLoader::get_abort_on_missing_resources()) {
+					ResourceLoader::notify_dependency_error(local_path, external_resources[p_index].path, external_resources[p_index].type);
+				} else {
+					error = ERR_FILE_MISSING_DEPENDENCIES;
+					ERR_FAIL_V_MSG(error, vformat("Can't load dependency: '%s'.", external_resources[p_index].path));
+				}
+			}
+		} else {
+			r_v = res;
+		}
+	}
+	return OK;
+}
+
+void ResourceLoaderCompatBinary::_record_deferred_fixup(DeferredFixup::Target p_target, const Array &p_array, int p_index, const Dictionary &p_dict, const Variant &p_key) {
+	pending_fixup.target = p_target;
+	pending_fixup.array = p_array;
+	pending_fixup.dictionary = p_dict;
+	pending_fixup.key = p_key;
+	if (p_target == DeferredFixup::TARGET_ARRAY) {
+		pending_fixup.key = p_index;
+	}
+	deferred_fixups->push_back(pending_fixup);
+	last_variant_deferred = false;
+}
+
+Error ResourceLoaderCompatBinary::_resolve_deferred_fixup(const DeferredFixup &p_fixup, Variant &r_property_value) {
+	Variant v;
+	switch (p_fixup.kind) {
+		case DeferredFixup::REF_INTERNAL: {
+			v = _get_internal_resource_ref(p_fixup.index);
+		} break;
+		case DeferredFixup::REF_EXTERNAL_PATH: {
+			v = _get_external_resource_by_path(p_fixup.ext_type, p_fixup.ext_path);
+		} break;
+		case DeferredFixup::REF_EXTERNAL_INDEX: {
+			Error err = _get_external_resource_by_index((int)p_fixup.index, v);
+			if (err != OK) {
+				return err;
+			}
+		} break;
+	}
+	switch (p_fixup.target) {
+		case DeferredFixup::TARGET_PROPERTY: {
+			r_property_value = v;
+		} break;
+		case DeferredFixup::TARGET_ARRAY: {
+			Array arr = p_fixup.array;
+			arr[(int)p_fixup.key] = v;
+		} break;
+		case DeferredFixup::TARGET_DICTIONARY: {
+			Dictionary dict = p_fixup.dictionary;
+			dict[p_fixup.key] = v;
+		} break;
+	}
+	return OK;
+}
+
 Error ResourceLoaderCompatBinary::parse_variant(Variant &r_v) {
+	last_variant_deferred = false;
 	uint32_t prop_type = f->get_32();
 	print_bl("find property of type: " + itos(prop_type));
 
@@ -426,21 +540,18 @@ Error ResourceLoaderCompatBinary::parse_variant(Variant &r_v) {
 				} break;
 				case OBJECT_INTERNAL_RESOURCE: {
 					uint32_t index = f->get_32();
-					String path;
 
 					if (using_named_scene_ids) { // New format.
 						ERR_FAIL_INDEX_V((int)index, internal_resources.size(), ERR_PARSE_ERROR);
-						path = internal_resources[index].path;
-					} else {
-						path += res_path + "::" + itos(index);
 					}
-
-					//always use internal cache for loading internal resources
-					if (!internal_index_cache.has(path)) {
-						WARN_PRINT(vformat("Couldn't load resource (no cache): %s.", path));
+					if (deferring_object_refs) {
+						pending_fixup = DeferredFixup();
+						pending_fixup.kind = DeferredFixup::REF_INTERNAL;
+						pending_fixup.index = index;
+						last_variant_deferred = true;
 						r_v = Variant();
 					} else {
-						r_v = internal_index_cache[path];
+						r_v = _get_internal_resource_ref(index);
 					}
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
@@ -449,51 +560,31 @@ Error ResourceLoaderCompatBinary::parse_variant(Variant &r_v) {
 					String exttype = get_unicode_string();
 					String path = get_unicode_string();
 
-					if (!path.contains("://") && path.is_relative_path()) {
-						// path is relative to file being loaded, so convert to a resource path
-						path = GDRESettings::get_singleton()->localize_path(res_path.get_base_dir().path_join(path));
-					}
-
-					if (remaps.find(path)) {
-						path = remaps[path];
-					}
-					Error err;
-					Ref<Resource> res = !is_real_load() ? CompatFormatLoader::create_missing_external_resource(path, exttype, ResourceUID::INVALID_ID) : ResourceCompatLoader::custom_load(path, exttype, load_type, &err, use_sub_threads, cache_mode_for_external);
-
-					if (res.is_null()) {
-						WARN_PRINT(vformat("Couldn't load resource: %s.", path));
+					if (deferring_object_refs) {
+						pending_fixup = DeferredFixup();
+						pending_fixup.kind = DeferredFixup::REF_EXTERNAL_PATH;
+						pending_fixup.ext_type = exttype;
+						pending_fixup.ext_path = path;
+						last_variant_deferred = true;
+						r_v = Variant();
+					} else {
+						r_v = _get_external_resource_by_path(exttype, path);
 					}
-					r_v = res;
-
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE_INDEX: {
 					//new file format, just refers to an index in the external list
 					int erindex = f->get_32();
 
-					if (erindex < 0 || erindex >= external_resources.size()) {
-						WARN_PRINT("Broken external resource! (index out of size)");
+					if (deferring_object_refs) {
+						pending_fixup = DeferredFixup();
+						pending_fixup.kind = DeferredFixup::REF_EXTERNAL_INDEX;
+						pending_fixup.index = erindex;
+						last_variant_deferred = true;
 						r_v = Variant();
 					} else {
-						Ref<ResourceLoader::LoadToken> &load_token = external_resources.write[erindex].load_token;
-						if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
-							Error err;
-							Ref<Resource> res = finish_ext_load(load_token, &err);
-							if (res.is_null()) {
-								if (!is_real_load()) {
-									error = ERR_FILE_MISSING_DEPENDENCIES;
-									ERR_FAIL_V_MSG(error, "WE SHOULD NEVER GET HERE!!!!!!!!!!!!!!!!!!!  : Can't load dependency: " + external_resources[erindex].path + ".");
-								}
-								if (!ResourceLoader::is_cleaning_tasks()) {
-									if (!ResourceLoader::get_abort_on_missing_resources()) {
-										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
-									} else {
-										error = ERR_FILE_MISSING_DEPENDENCIES;
-										ERR_FAIL_V_MSG(error, vformat("Can't load dependency: '%s'.", external_resources[erindex].path));
-									}
-								}
-							} else {
-								r_v = res;
-							}
+						Error err = _get_external_resource_by_index(erindex, r_v);
+						if (err != OK) {
+							return err;
 						}
 					}
 				} break;
@@ -522,18 +613,27 @@ Error ResourceLoaderCompatBinary::parse_variant(Variant &r_v) {
 			for (uint32_t i = 0; i < len; i++) {
 				Variant key;
 				Error err = parse_variant(key);
-				if (err == ERR_UNAVAILABLE) {
+				if (err == ERR_UNAVAILABLE || err == ERR_SKIP) {
 					return err;
 				}
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
+				if (last_variant_deferred) {
+					// resources used as keys can't be patched in afterwards; the block will be parsed serially instead
+					deferred_unsupported = true;
+					return ERR_SKIP;
+				}
 				Variant value;
 				err = parse_variant(value);
-				if (err == ERR_UNAVAILABLE) {
+				if (err == ERR_UNAVAILABLE || err == ERR_SKIP) {
 					return err;
 				}
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
 				d[key] = value;
+				if (last_variant_deferred) {
+					_record_deferred_fixup(DeferredFixup::TARGET_DICTIONARY, Array(), 0, d, key);
+				}
 			}
+			last_variant_deferred = false;
 			r_v = d;
 		} break;
 		case VARIANT_ARRAY: {
@@ -544,12 +644,16 @@ Error ResourceLoaderCompatBinary::parse_variant(Variant &r_v) {
 			for (uint32_t i = 0; i < len; i++) {
 				Variant val;
 				Error err = parse_variant(val);
-				if (err == ERR_UNAVAILABLE) {
+				if (err == ERR_UNAVAILABLE || err == ERR_SKIP) {
 					return err;
 				}
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
 				a[i] = val;
+				if (last_variant_deferred) {
+					_record_deferred_fixup(DeferredFixup::TARGET_ARRAY, a, i, Dictionary(), Variant());
+				}
 			}
+			last_variant_deferred = false;
 			r_v = a;
 
 		} break;
@@ -754,8 +858,16 @@ Error ResourceLoaderCompatBinary::load() {
 		}
 	}
 
+	// the decoded blocks are only needed for this load; release them on every exit path, not just the successful one
+	struct DecodedResourcesReleaser {
+		Vector<DecodedResource> &decoded;
+		~DecodedResourcesReleaser() { decoded.clear(); }
+	} decoded_releaser{ decoded_resources };
+	_decode_internal_resources_parallel();
+
 	for (int i = 0; i < internal_resources.size(); i++) {
 		bool main = i == (internal_resources.size() - 1);
+		const DecodedResource *decoded = i < decoded_resources.size() && decoded_resources[i].decoded ? &decoded_resources[i] : nullptr;
 
 		//maybe it is loaded already
 		String path;
@@ -787,11 +899,13 @@ Error ResourceLoaderCompatBinary::load() {
 			}
 		}
 
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
+		String t;
+		if (decoded) {
+			t = decoded->type;
+		} else {
+			f->seek(internal_resources[i].offset);
+			t = get_unicode_string();
+		}
 
 		Ref<Resource> res;
 		Resource *r = nullptr;
@@ -891,25 +1005,37 @@ Error ResourceLoaderCompatBinary::load() {
 		res->_start_load("binary", ver_format);
 #endif
 
-		int pc = f->get_32();
+		int pc = decoded ? decoded->properties.size() : f->get_32();
 
 		//set properties
 
 		Dictionary missing_resource_properties;
 
 		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
-
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
+			StringName name;
 			Variant value;
+			if (decoded) {
+				const DecodedProperty &prop = decoded->properties[j];
+				name = prop.name;
+				value = prop.value;
+				for (const DeferredFixup &fixup : prop.fixups) {
+					error = _resolve_deferred_fixup(fixup, value);
+					if (error) {
+						return error;
+					}
+				}
+			} else {
+				name = _get_string();
+
+				if (name == StringName()) {
+					error = ERR_FILE_CORRUPT;
+					ERR_FAIL_V(ERR_FILE_CORRUPT);
+				}
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
+				error = parse_variant(value);
+				if (error) {
+					return error;
+				}
 			}
 
 			bool set_valid = true;
@@ -1050,6 +1176,109 @@ Error ResourceLoaderCompatBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+void ResourceLoaderCompatBinary::_init_block_decoder(const ResourceLoaderCompatBinary &p_parent, const uint8_t *p_data, uint64_t p_len) {
+	local_path = p_parent.local_path;
+	res_path = p_parent.res_path;
+	ver_format = p_parent.ver_format;
+	ver_major = p_parent.ver_major;
+	ver_minor = p_parent.ver_minor;
+	load_type = p_parent.load_type;
+	string_map = p_parent.string_map;
+	internal_resources = p_parent.internal_resources;
+	using_named_scene_ids = p_parent.using_named_scene_ids;
+	using_real_t_double = p_parent.using_real_t_double;
+	stored_big_endian = p_parent.stored_big_endian;
+	deferring_object_refs = true;
+
+	Ref<FileAccessMemory> fam;
+	fam.instantiate();
+	fam->open_custom(p_data, p_len);
+	fam->set_big_endian(stored_big_endian);
+	fam->real_is_double = using_real_t_double;
+	f = fam;
+}
+
+void ResourceLoaderCompatBinary::_decode_internal_resource_task(uint32_t p_index, BlockDecodeContext *p_ctx) {
+	DecodedResource &dr = p_ctx->decoded[p_index];
+	ResourceLoaderCompatBinary decoder;
+	decoder._init_block_decoder(*this, p_ctx->data + (dr.block_offset - p_ctx->data_offset), dr.block_size);
+
+	dr.type = decoder.get_unicode_string();
+	uint32_t pc = decoder.f->get_32();
+	for (uint32_t j = 0; j < pc; j++) {
+		DecodedProperty prop;
+		prop.name = decoder._get_string();
+		if (prop.name == StringName() || decoder.f->eof_reached()) {
+			// leave it to the serial path to report the error
+			return;
+		}
+		decoder.deferred_fixups = &prop.fixups;
+		Error err = decoder.parse_variant(prop.value);
+		if (err != OK || decoder.deferred_unsupported) {
+			return;
+		}
+		if (decoder.last_variant_deferred) {
+			decoder._record_deferred_fixup(DeferredFixup::TARGET_PROPERTY, Array(), 0, Dictionary(), Variant());
+		}
+		decoder.deferred_fixups = nullptr;
+		dr.properties.push_back(prop);
+	}
+	dr.decoded = true;
+}
+
+void ResourceLoaderCompatBinary::_decode_internal_resources_parallel() {
+	decoded_resources.clear();
+	parallel_decoded_count = 0;
+	if (internal_resources.size() < PARALLEL_DECODE_MIN_RESOURCES || GDREConfig::get_singleton()->get_setting("force_single_threaded", false)) {
+		return;
+	}
+	// property blocks are delimited by the next block's offset; bail if the offset table isn't in file order
+	uint64_t file_end = f->get_length();
+	if (ver_major <= 2 && importmd_ofs > internal_resources[internal_resources.size() - 1].offset) {
+		file_end = MIN(file_end, importmd_ofs);
+	}
+	for (int i = 1; i < internal_resources.size(); i++) {
+		if (internal_resources[i].offset <= internal_resources[i - 1].offset) {
+			return;
+		}
+	}
+	uint64_t start_offset = internal_resources[0].offset;
+	if (file_end <= internal_resources[internal_resources.size() - 1].offset) {
+		return;
+	}
+
+	Vector<uint8_t> data;
+	data.resize(file_end - start_offset);
+	f->seek(start_offset);
+	if (f->get_buffer(data.ptrw(), data.size()) != (uint64_t)data.size()) {
+		return;
+	}
+
+	decoded_resources.resize(internal_resources.size());
+	DecodedResource *decoded_ptr = decoded_resources.ptrw();
+	for (int i = 0; i < internal_resources.size(); i++) {
+		decoded_ptr[i].block_offset = internal_resources[i].offset;
+		uint64_t end = i + 1 < internal_resources.size() ? internal_resources[i + 1].offset : file_end;
+		decoded_ptr[i].block_size = end - internal_resources[i].offset;
+	}
+
+	BlockDecodeContext ctx;
+	ctx.data = data.ptr();
+	ctx.data_offset = start_offset;
+	ctx.decoded = decoded_ptr;
+	auto group_id = WorkerThreadPool::get_singleton()->add_template_group_task(
+			this,
+			&ResourceLoaderCompatBinary::_decode_internal_resource_task,
+			&ctx,
+			internal_resources.size(), -1, true, SNAME("ResourceLoaderCompatBinary::decode_internal_resources"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	for (int i = 0; i < decoded_resources.size(); i++) {
+		if (decoded_ptr[i].decoded) {
+			parallel_decoded_count++;
+		}
+	}
+}
+
 void ResourceLoaderCompatBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -1612,13 +1841,18 @@ Error ResourceFormatLoaderCompatBinary::rename_dependencies(const String &p_path
 	//external resources
 	uint32_t ext_resources_size = f->get_32();
 	fw->store_32(ext_resources_size);
+	// if no path or uid in the external table changes, the file is left alone
+	bool changed = false;
 	for (uint32_t i = 0; i < ext_resources_size; i++) {
 		String type = get_ustring(f);
 		String path = get_ustring(f);
+		const String original_path = path;
 
 		ResourceUID::ID uid = ResourceUID::INVALID_ID;
+		ResourceUID::ID original_uid = ResourceUID::INVALID_ID;
 		if (using_uids) {
 			uid = f->get_64();
+			original_uid = uid;
 			if (uid != ResourceUID::INVALID_ID) {
 				if (ResourceUID::get_singleton()->has_id(uid)) {
 					// If a UID is found and the path is valid, it will be used, otherwise, it falls back to the path.
@@ -1660,6 +1894,7 @@ Error ResourceFormatLoaderCompatBinary::rename_dependencies(const String &p_path
 
 		save_ustring(fw, type);
 		save_ustring(fw, path);
+		changed = changed || path != original_path;
 
 		if (using_uids) {
 			// ResourceUID::ID uid = ResourceSaver::get_resource_id_for_path(full_path)
@@ -1667,9 +1902,18 @@ Error ResourceFormatLoaderCompatBinary::rename_dependencies(const String &p_path
 				uid = GDRESettings::get_singleton()->get_uid_for_path(full_path);
 			}
 			fw->store_64(uint64_t(uid));
+			changed = changed || uid != original_uid;
 		}
 	}
 
+	if (!changed) {
+		f.unref();
+		fw.unref();
+		Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+		da->remove(p_path + ".depren");
+		return OK;
+	}
+
 	int64_t size_diff = (int64_t)fw->get_position() - (int64_t)f->get_position();
 
 	//internal resources
@@ -1683,13 +1927,10 @@ Error ResourceFormatLoaderCompatBinary::rename_dependencies(const String &p_path
 		fw->store_64(offset + size_diff);
 	}
 
-	//rest of file
-	uint8_t b = f->get_8();
-	while (!f->eof_reached()) {
-		fw->store_8(b);
-		b = f->get_8();
-	}
+	// rest of file; internal offsets were already shifted above, so the body is copied verbatim
+	Error copy_err = gdre::copy_file_contents(f, fw, f->get_length() - f->get_position());
 	f.unref();
+	ERR_FAIL_COND_V_MSG(copy_err != OK, ERR_CANT_CREATE, vformat("Failed to copy resource body to '%s.depren'.", p_path));
 
 	bool all_ok = fw->get_error() == OK;
 
@@ -113,6 +113,68 @@ class ResourceLoaderCompatBinary {
 
 	Error parse_variant(Variant &r_v);
 
+	// Internal resource property blocks can be decoded in parallel; object references inside them are
+	// recorded as fixups and resolved in file order on the loading thread, so the result matches a serial load.
+	struct DeferredFixup {
+		enum Kind {
+			REF_INTERNAL,
+			REF_EXTERNAL_INDEX,
+			REF_EXTERNAL_PATH,
+		};
+		enum Target {
+			TARGET_PROPERTY,
+			TARGET_ARRAY,
+			TARGET_DICTIONARY,
+		};
+		Kind kind = REF_INTERNAL;
+		Target target = TARGET_PROPERTY;
+		uint32_t index = 0;
+		String ext_type;
+		String ext_path;
+		Array array;
+		Dictionary dictionary;
+		Variant key;
+	};
+
+	struct DecodedProperty {
+		StringName name;
+		Variant value;
+		Vector<DeferredFixup> fixups;
+	};
+
+	struct DecodedResource {
+		String type;
+		Vector<DecodedProperty> properties;
+		uint64_t block_offset = 0;
+		uint64_t block_size = 0;
+		bool decoded = false;
+	};
+
+	struct BlockDecodeContext {
+		const uint8_t *data = nullptr;
+		uint64_t data_offset = 0;
+		DecodedResource *decoded = nullptr;
+	};
+
+	static constexpr int PARALLEL_DECODE_MIN_RESOURCES = 32;
+
+	bool deferring_object_refs = false;
+	bool last_variant_deferred = false;
+	bool deferred_unsupported = false;
+	DeferredFixup pending_fixup;
+	Vector<DeferredFixup> *deferred_fixups = nullptr;
+	Vector<DecodedResource> decoded_resources;
+	int parallel_decoded_count = 0;
+
+	void _record_deferred_fixup(DeferredFixup::Target p_target, const Array &p_array, int p_index, const Dictionary &p_dict, const Variant &p_key);
+	Variant _get_internal_resource_ref(uint32_t p_index);
+	Variant _get_external_resource_by_path(const String &p_type, const String &p_path);
+	Error _get_external_resource_by_index(int p_index, Variant &r_v);
+	Error _resolve_deferred_fixup(const DeferredFixup &p_fixup, Variant &r_property_value);
+	void _init_block_decoder(const ResourceLoaderCompatBinary &p_parent, const uint8_t *p_data, uint64_t p_len);
+	void _decode_internal_resource_task(uint32_t p_index, BlockDecodeContext *p_ctx);
+	void _decode_internal_resources_parallel();
+
 	HashMap<String, Ref<Resource>> dependency_cache;
 	void _set_main_resource_info(Ref<ResourceInfo> &r_info);
 	void set_internal_resource_compat_meta(const String &p_path, const String &p_scene_id, const String &p_type, Ref<Resource> &r_res);
@@ -133,6 +195,8 @@ public:
 	Ref<Resource> get_resource();
 	Error load();
 	void set_translation_remapped(bool p_remapped);
+	// Number of internal resources whose property blocks were decoded on the worker pool during the last load().
+	int get_parallel_decoded_count() const { return parallel_decoded_count; }
 
 	void set_remaps(const HashMap<String, String> &p_remaps) { remaps = p_remaps; }
 	void open(Ref<FileAccess> p_f, bool p_no_resources = false, bool p_keep_uuid_paths = false);
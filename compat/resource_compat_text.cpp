@@ -36,6 +36,7 @@
 #include "core/io/missing_resource.h"
 
 #include "compat/variant_writer_compat.h"
+#include "utility/common.h"
 #include "utility/gdre_settings.h"
 
 #include "core/io/dir_access.h"
@@ -1111,7 +1112,11 @@ Error ResourceLoaderCompatText::rename_dependencies(Ref<FileAccess> p_f, const S
 	ignore_resource_parsing = true;
 	//FileAccess
 
-	Ref<FileAccess> fw;
+	// The header and ext_resource tags are rebuilt in memory; the .depren file is only written
+	// (and the body copied) if one of them actually changed.
+	String header_text;
+	bool has_ext_resources = false;
+	bool changed = false;
 
 	String base_path = local_path.get_base_dir();
 
@@ -1127,18 +1132,19 @@ Error ResourceLoaderCompatText::rename_dependencies(Ref<FileAccess> p_f, const S
 
 		if (next_tag.name != "ext_resource") {
 			//nothing was done
-			if (fw.is_null()) {
+			if (!has_ext_resources) {
 				return OK;
 			}
 
 			break;
 
 		} else {
-			if (fw.is_null()) {
-				fw = FileAccess::open(p_path + ".depren", FileAccess::WRITE);
+			if (!has_ext_resources) {
+				has_ext_resources = true;
 
 				if (res_uid == ResourceUID::INVALID_ID && format_version >= 3) {
 					res_uid = GDRESettings::get_singleton()->get_uid_for_path(p_path);
+					changed = changed || res_uid != ResourceUID::INVALID_ID;
 				}
 
 				String uid_text = "";
@@ -1147,13 +1153,13 @@ Error ResourceLoaderCompatText::rename_dependencies(Ref<FileAccess> p_f, const S
 				}
 
 				if (is_scene) {
-					fw->store_line("[gd_scene load_steps=" + itos(resources_total) + " format=" + itos(format_version) + uid_text + "]\n");
+					header_text += "[gd_scene load_steps=" + itos(resources_total) + " format=" + itos(format_version) + uid_text + "]\n\n";
 				} else {
 					String script_res_text;
 					if (!script_class.is_empty()) {
 						script_res_text = "script_class=\"" + script_class + "\" ";
 					}
-					fw->store_line("[gd_resource type=\"" + res_type + "\" " + script_res_text + "load_steps=" + itos(resources_total) + " format=" + itos(format_version) + uid_text + "]\n");
+					header_text += "[gd_resource type=\"" + res_type + "\" " + script_res_text + "load_steps=" + itos(resources_total) + " format=" + itos(format_version) + uid_text + "]\n\n";
 				}
 			}
 
@@ -1163,12 +1169,15 @@ Error ResourceLoaderCompatText::rename_dependencies(Ref<FileAccess> p_f, const S
 			}
 
 			String path = next_tag.fields["path"];
+			const String original_path = path;
 			String id = next_tag.fields["id"];
 			String type = next_tag.fields["type"];
 			ResourceUID::ID uid = ResourceUID::INVALID_ID;
+			ResourceUID::ID original_uid = ResourceUID::INVALID_ID;
 			if (next_tag.fields.has("uid")) {
 				String uidt = next_tag.fields["uid"];
 				uid = ResourceUID::get_singleton()->text_to_id(uidt);
+				original_uid = uid;
 				if (uid != ResourceUID::INVALID_ID && ResourceUID::get_singleton()->has_id(uid)) {
 					// If a UID is found and the path is valid, it will be used, otherwise, it falls back to the path.
 					String old_path = path;
@@ -1213,39 +1222,34 @@ Error ResourceLoaderCompatText::rename_dependencies(Ref<FileAccess> p_f, const S
 			}
 			// clang-format on
 			s += " path=\"" + path + "\" id=" + get_id_string(id, format_version) + "]";
-			fw->store_line(s); // Bundled.
+			header_text += s + "\n"; // Bundled.
+			changed = changed || path != original_path || uid != original_uid;
 
 			tag_end = f->get_position();
 		}
 	}
 
-	f->seek(tag_end);
+	if (!changed) {
+		return OK;
+	}
 
-	const uint32_t buffer_size = 2048;
-	uint8_t *buffer = (uint8_t *)alloca(buffer_size);
-	uint32_t num_read;
+	Ref<FileAccess> fw = FileAccess::open(p_path + ".depren", FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(fw.is_null(), ERR_CANT_CREATE, "Cannot create file '" + p_path + ".depren'.");
+	fw->store_string(header_text);
 
-	num_read = f->get_buffer(buffer, buffer_size);
-	ERR_FAIL_COND_V_MSG(num_read == UINT32_MAX, ERR_CANT_CREATE, "Failed to allocate memory for buffer.");
-	ERR_FAIL_COND_V(num_read == 0, ERR_FILE_CORRUPT);
+	f->seek(tag_end);
 
-	if (*buffer == '\n') {
-		// Skip first newline character since we added one.
-		if (num_read > 1) {
-			fw->store_buffer(buffer + 1, num_read - 1);
-		}
+	// Skip first newline character since we added one.
+	uint64_t remaining = f->get_length() - tag_end;
+	ERR_FAIL_COND_V(remaining == 0, ERR_FILE_CORRUPT);
+	if (f->get_8() != '\n') {
+		f->seek(tag_end);
 	} else {
-		fw->store_buffer(buffer, num_read);
+		remaining--;
 	}
 
-	while (!f->eof_reached()) {
-		num_read = f->get_buffer(buffer, buffer_size);
-		fw->store_buffer(buffer, num_read);
-	}
-
-	bool all_ok = fw->get_error() == OK;
-
-	if (!all_ok) {
+	Error copy_err = gdre::copy_file_contents(f, fw, remaining);
+	if (copy_err != OK || fw->get_error() != OK) {
 		return ERR_CANT_CREATE;
 	}
 
@@ -1,6 +1,7 @@
 #include "resource_loader_compat.h"
 #include "compat/resource_compat_binary.h"
 #include "compat/resource_compat_text.h"
+#include "compat/resource_resolution_context.h"
 #include "core/error/error_list.h"
 #include "core/error/error_macros.h"
 #include "core/io/resource_loader.h"
@@ -219,6 +220,16 @@ Ref<Resource> ResourceCompatLoader::custom_load(const String &p_path, const Stri
 	String res_path = GDRESettings::get_singleton()->get_mapped_path(p_path);
 	auto loader = get_loader_for_path(res_path, p_type_hint);
 	bool is_real_load = p_type == ResourceInfo::LoadType::REAL_LOAD || p_type == ResourceInfo::LoadType::GLTF_LOAD;
+	if (is_real_load && ResourceResolutionContext::is_active() && p_cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && p_cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE_DEEP) {
+		// scoped substitutions take precedence over both the global cache and the file itself
+		auto res = ResourceResolutionContext::resolve(local_path);
+		if (res.is_valid()) {
+			if (r_error) {
+				*r_error = OK;
+			}
+			return res;
+		}
+	}
 	if (loader.is_null() && is_real_load) {
 		return load_with_real_resource_loader(local_path, p_type_hint, r_error, use_threads, p_cache_mode);
 	}
@@ -0,0 +1,83 @@
+#include "resource_resolution_context.h"
+
+#include "utility/gdre_config.h"
+
+thread_local ResourceResolutionContext *ResourceResolutionContext::current = nullptr;
+
+Mutex ResourceResolutionContext::shared_mutex;
+LRUCache<String, Ref<Resource>> ResourceResolutionContext::shared_cache;
+std::atomic<uint64_t> ResourceResolutionContext::shared_hits = 0;
+std::atomic<uint64_t> ResourceResolutionContext::shared_misses = 0;
+std::atomic<uint64_t> ResourceResolutionContext::shared_evictions = 0;
+
+ResourceResolutionContext::ResourceResolutionContext() {
+	previous = current;
+	current = this;
+}
+
+ResourceResolutionContext::~ResourceResolutionContext() {
+	ERR_FAIL_COND_MSG(current != this, "Resource resolution contexts must be destroyed in the reverse order of creation.");
+	current = previous;
+}
+
+void ResourceResolutionContext::add(const String &p_path, const Ref<Resource> &p_resource) {
+	ERR_FAIL_COND(p_resource.is_null());
+	resources[p_path] = p_resource;
+}
+
+bool ResourceResolutionContext::has(const String &p_path) const {
+	return resources.has(p_path);
+}
+
+Ref<Resource> ResourceResolutionContext::resolve(const String &p_path) {
+	for (ResourceResolutionContext *ctx = current; ctx; ctx = ctx->previous) {
+		auto it = ctx->resources.find(p_path);
+		if (it != ctx->resources.end()) {
+			return it->value;
+		}
+	}
+	return Ref<Resource>();
+}
+
+Ref<Resource> ResourceResolutionContext::get_shared(const String &p_key) {
+	MutexLock lock(shared_mutex);
+	const Ref<Resource> *res = shared_cache.getptr(p_key);
+	if (res) {
+		shared_hits++;
+		return *res;
+	}
+	shared_misses++;
+	return Ref<Resource>();
+}
+
+void ResourceResolutionContext::add_shared(const String &p_key, const Ref<Resource> &p_resource) {
+	ERR_FAIL_COND(p_resource.is_null());
+	int64_t capacity = GDREConfig::get_singleton()->get_setting("Exporter/Scene/shared_resource_cache_size", 128);
+	MutexLock lock(shared_mutex);
+	if (capacity <= 0) {
+		shared_evictions += shared_cache.get_size();
+		shared_cache.clear();
+		return;
+	}
+	if ((size_t)capacity != shared_cache.get_capacity()) {
+		size_t before = shared_cache.get_size();
+		shared_cache.set_capacity(capacity);
+		shared_evictions += before - shared_cache.get_size();
+	}
+	bool evicts = !shared_cache.has(p_key) && shared_cache.get_size() >= shared_cache.get_capacity();
+	shared_cache.insert(p_key, p_resource);
+	if (evicts) {
+		shared_evictions++;
+	}
+}
+
+void ResourceResolutionContext::clear_shared() {
+	MutexLock lock(shared_mutex);
+	shared_cache.clear();
+}
+
+void ResourceResolutionContext::reset_shared_stats() {
+	shared_hits = 0;
+	shared_misses = 0;
+	shared_evictions = 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/lru.h"
+
+#include <atomic>
+
+// Scoped, per-thread table of resources that the compat loaders return for an external resource path
+// instead of loading it, so that exporters can substitute preloaded or placeholder dependencies without
+// touching the global ResourceCache.
+// Contexts nest; the innermost one on the current thread is consulted first.
+//
+// Alongside it is a bounded LRU shared by every thread, for dependencies that are expensive to load and
+// are reused across exports (e.g. textures shared by many scenes). It is only filled explicitly.
+// Resources in it are handed to several exports at once without being duplicated, so they are read-only:
+// set them up completely before add_shared, and never modify what get_shared returns.
+class ResourceResolutionContext {
+	HashMap<String, Ref<Resource>> resources;
+	ResourceResolutionContext *previous = nullptr;
+
+	static thread_local ResourceResolutionContext *current;
+
+	static Mutex shared_mutex;
+	static LRUCache<String, Ref<Resource>> shared_cache;
+	static std::atomic<uint64_t> shared_hits;
+	static std::atomic<uint64_t> shared_misses;
+	static std::atomic<uint64_t> shared_evictions;
+
+public:
+	// Registers p_resource to be returned for p_path while this context is active.
+	void add(const String &p_path, const Ref<Resource> &p_resource);
+	bool has(const String &p_path) const;
+
+	// Returns the resource registered for p_path in the innermost context that has it, or null.
+	static Ref<Resource> resolve(const String &p_path);
+	static bool is_active() { return current != nullptr; }
+
+	// Shared LRU; get_shared counts a hit or a miss.
+	static Ref<Resource> get_shared(const String &p_key);
+	static void add_shared(const String &p_key, const Ref<Resource> &p_resource);
+	static void clear_shared();
+	static void reset_shared_stats();
+	static uint64_t get_shared_hits() { return shared_hits; }
+	static uint64_t get_shared_misses() { return shared_misses; }
+	static uint64_t get_shared_evictions() { return shared_evictions; }
+
+	ResourceResolutionContext();
+	~ResourceResolutionContext();
+};
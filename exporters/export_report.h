@@ -1,4 +1,5 @@
 #pragma once
+#include "core/io/resource_uid.h"
 #include "core/object/ref_counted.h"
 #include "utility/import_info.h"
 #include "utility/task_manager.h"
@@ -39,9 +40,14 @@ public:
 	String actual_type;
 	String script_class;
 	Vector<String> dependencies;
+	// Set by exporters that already parsed the exported resource, so the metadata pass doesn't have to re-open it.
+	Ref<ResourceInfo> resource_info;
+	bool dependencies_collected = false;
 	int64_t modified_time = -1;
 	int64_t import_modified_time = -1;
 	String import_md5;
+	// parsed from the import info's uid during the metadata pass, for the filesystem cache
+	ResourceUID::ID uid = ResourceUID::INVALID_ID;
 
 	// setters and getters
 	void set_message(const String &p_message) { message = p_message; }
@@ -9,6 +9,7 @@
 #include "utility/common.h"
 #include "utility/gdre_logger.h"
 #include "utility/import_info.h"
+#include "utility/png_encoder.h"
 
 #include <filesystem>
 
@@ -149,12 +150,28 @@ Error ObjExporter::_write_meshes_to_obj(const Vector<Ref<Mesh>> &p_meshes, const
 		r_mesh_info.has_shadow_meshes = r_mesh_info.has_shadow_meshes || has_shadow_mesh(p_mesh);
 		auto surface_count = get_surface_count(p_mesh);
 		for (int surf_idx = 0; surf_idx < surface_count; surf_idx++) {
-			Array arrays = surface_get_arrays(p_mesh, surf_idx);
-			Vector<Vector3> surface_vertices = arrays[Mesh::ARRAY_VERTEX];
-			Vector<Vector2> surface_uvs = arrays[Mesh::ARRAY_TEX_UV];
-			Vector<Vector3> surface_normals = arrays[Mesh::ARRAY_NORMAL];
-			Vector<Color> surface_colors = arrays[Mesh::ARRAY_COLOR];
-			Vector<int> indices = arrays[Mesh::ARRAY_INDEX];
+			Vector<Vector3> surface_vertices;
+			Vector<Vector2> surface_uvs;
+			Vector<Vector3> surface_normals;
+			Vector<Color> surface_colors;
+			Vector<int> indices;
+			Ref<FakeMesh> fake_mesh = p_mesh;
+			if (fake_mesh.is_valid()) {
+				// typed buffers, no Variant conversion
+				const FakeMesh::SurfaceArrays &arrays = fake_mesh->surface_get_decoded_arrays(surf_idx);
+				surface_vertices = arrays.vertices;
+				surface_uvs = arrays.uvs;
+				surface_normals = arrays.normals;
+				surface_colors = arrays.colors;
+				indices = arrays.indices;
+			} else {
+				Array arrays = surface_get_arrays(p_mesh, surf_idx);
+				surface_vertices = arrays[Mesh::ARRAY_VERTEX];
+				surface_uvs = arrays[Mesh::ARRAY_TEX_UV];
+				surface_normals = arrays[Mesh::ARRAY_NORMAL];
+				surface_colors = arrays[Mesh::ARRAY_COLOR];
+				indices = arrays[Mesh::ARRAY_INDEX];
+			}
 			auto format = get_surface_format(p_mesh, surf_idx);
 			r_mesh_info.has_tangents = r_mesh_info.has_tangents || ((format & Mesh::ARRAY_FORMAT_TANGENT) != 0);
 			r_mesh_info.has_lods = r_mesh_info.has_lods || surface_has_lods(p_mesh, surf_idx);
@@ -352,7 +369,7 @@ Error ObjExporter::write_materials_to_mtl(const HashMap<String, Ref<Material>> &
 					name = filebasename + "_" + suffix + ".png";
 				}
 				gdre::ensure_dir(base_dir);
-				tex->get_image()->save_png(base_dir.path_join(name));
+				gdre::PNGEncoder::save_image_as_png(base_dir.path_join(name), tex->get_image());
 				path = name;
 			}
 			return path;
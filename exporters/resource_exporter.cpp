@@ -1,6 +1,7 @@
 #include "resource_exporter.h"
 #include "compat/resource_loader_compat.h"
 #include "utility/common.h"
+#include "utility/output_dedup.h"
 
 #include "core/error/error_list.h"
 #include "core/error/error_macros.h"
@@ -9,13 +10,7 @@ Ref<ResourceExporter> Exporter::exporters[MAX_EXPORTERS];
 int Exporter::exporter_count = 0;
 
 Error ResourceExporter::write_to_file(const String &path, const Vector<uint8_t> &data) {
-	Error err = gdre::ensure_dir(path.get_base_dir());
-	ERR_FAIL_COND_V_MSG(err, err, "Failed to create directory for " + path);
-	Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE, &err);
-	ERR_FAIL_COND_V_MSG(file.is_null(), !err ? ERR_FILE_CANT_WRITE : err, "Cannot open file '" + path + "' for writing.");
-	file->store_buffer(data.ptr(), data.size());
-	file->flush();
-	return OK;
+	return gdre::OutputDeduplicator::write_file(path, data.ptr(), data.size());
 }
 
 int ResourceExporter::get_ver_major(const String &res_path) {
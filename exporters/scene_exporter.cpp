@@ -1,6 +1,7 @@
 #include "scene_exporter.h"
 
 #include "compat/resource_loader_compat.h"
+#include "compat/resource_resolution_context.h"
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "exporters/export_report.h"
@@ -670,6 +671,12 @@ Error SceneExporter::_export_file(const String &p_dest_path, const String &p_src
 		get_deps_recursive(p_src_path, get_deps_map);
 
 		Vector<Ref<Resource>> textures;
+		// The scene load below only goes through ResourceLoader (and thus the global cache) when it is threaded;
+		// otherwise the compat loaders resolve dependencies through this context.
+		const bool use_global_cache = ResourceCompatLoader::is_globally_available() && using_threaded_load();
+		ResourceResolutionContext resolution_context;
+		uint64_t shared_cache_hits = 0;
+		uint64_t shared_cache_misses = 0;
 
 		for (auto &E : get_deps_map) {
 			dep_info &info = E.value;
@@ -706,8 +713,20 @@ Error SceneExporter::_export_file(const String &p_dest_path, const String &p_src
 		// 	// if it has a shader, we have to set gltf_load to false and do a real load on the textures, otherwise shaders will not be applied to the textures
 		// 	ResourceCompatLoader::set_default_gltf_load(false);
 		// }
+		auto is_dep_resolved = [&](const dep_info &info) {
+			return resolution_context.has(info.dep) || ResourceCache::has(info.dep);
+		};
 		auto set_cache_res = [&](const dep_info &info, const Ref<Resource> &texture, bool force_replace) {
-			if (texture.is_null() || (!force_replace && ResourceCache::get_ref(info.dep).is_valid())) {
+			if (texture.is_null()) {
+				return;
+			}
+			if (!use_global_cache) {
+				if (force_replace || !is_dep_resolved(info)) {
+					resolution_context.add(info.dep, texture);
+				}
+				return;
+			}
+			if (!force_replace && ResourceCache::get_ref(info.dep).is_valid()) {
 				return;
 			}
 #ifdef TOOLS_ENABLED
@@ -718,6 +737,39 @@ Error SceneExporter::_export_file(const String &p_dest_path, const String &p_src
 			texture->set_path(info.dep, true);
 			textures.push_back(texture);
 		};
+		// Loads a dependency that isn't where the scene expects it, reusing a copy from an earlier export if there is one.
+		// Shared copies are only read by the GLTF writer (e.g. Texture2D::get_image), never modified; see ResourceResolutionContext.
+		auto load_dep = [&](const dep_info &info) -> Ref<Resource> {
+			String shared_key = info.dep + "::" + info.remap;
+			Ref<Resource> texture;
+			if (!use_global_cache) {
+				texture = ResourceResolutionContext::get_shared(shared_key);
+				if (texture.is_valid()) {
+					shared_cache_hits++;
+					err = OK;
+					return texture;
+				}
+				shared_cache_misses++;
+			}
+			texture = ResourceCompatLoader::custom_load(
+					info.remap, "",
+					ResourceCompatLoader::get_default_load_type(),
+					&err,
+					using_threaded_load(),
+					ResourceFormatLoader::CACHE_MODE_IGNORE); // not ignore deep, we want to reuse dependencies if they exist
+			if (err || texture.is_null()) {
+				return Ref<Resource>();
+			}
+			if (!use_global_cache) {
+				// set up before sharing it, so that other threads never see it change
+#ifdef TOOLS_ENABLED
+				texture->set_import_path(info.remap);
+#endif
+				texture->set_path_cache(info.dep);
+				ResourceResolutionContext::add_shared(shared_key, texture);
+			}
+			return texture;
+		};
 		for (auto &E : get_deps_map) {
 			dep_info &info = E.value;
 			// Never set Script or Shader, they're not used by the GLTF writer and cause errors
@@ -749,20 +801,13 @@ Error SceneExporter::_export_file(const String &p_dest_path, const String &p_src
 				String our_path = GDRESettings::get_singleton()->get_mapped_path(info.dep);
 				if (our_path != info.remap) {
 					WARN_PRINT(vformat("Dependency %s:%s is not mapped to the same path: %s", info.dep, info.remap, our_path));
-					if (!ResourceCache::has(info.dep)) {
-						auto texture = ResourceCompatLoader::custom_load(
-								info.remap, "",
-								ResourceCompatLoader::get_default_load_type(),
-								&err,
-								using_threaded_load(),
-								ResourceFormatLoader::CACHE_MODE_IGNORE); // not ignore deep, we want to reuse dependencies if they exist
-						if (err || texture.is_null()) {
+					if (!is_dep_resolved(info)) {
+						auto texture = load_dep(info);
+						if (texture.is_null()) {
 							GDRE_SCN_EXP_FAIL_V_MSG(ERR_FILE_MISSING_DEPENDENCIES,
 									vformat("Dependency %s:%s failed to load.", info.dep, info.remap));
 						}
-						if (!ResourceCache::has(info.dep)) {
-							set_cache_res(info, texture, false);
-						}
+						set_cache_res(info, texture, false);
 					}
 				} else { // if mapped_path logic changes, we have to set this to true
 					// no_threaded_load = true;
@@ -1467,6 +1512,10 @@ Error SceneExporter::_export_file(const String &p_dest_path, const String &p_src
 			iinfo->set_param("_subresources", _subresources_dict);
 			Dictionary extra_info;
 			extra_info["image_path_to_data_hash"] = image_path_to_data_hash;
+			if (shared_cache_hits + shared_cache_misses > 0) {
+				extra_info["shared_resource_cache_hits"] = shared_cache_hits;
+				extra_info["shared_resource_cache_misses"] = shared_cache_misses;
+			}
 			p_report->set_extra_info(extra_info);
 		}
 		textures.clear();
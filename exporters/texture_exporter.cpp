@@ -3,6 +3,7 @@
 #include "compat/resource_compat_binary.h"
 #include "compat/resource_loader_compat.h"
 #include "utility/common.h"
+#include "utility/png_encoder.h"
 
 #include "core/error/error_list.h"
 #include "core/io/file_access.h"
@@ -105,7 +106,7 @@ Error TextureExporter::save_image(const String &dest_path, const Ref<Image> &img
 	} else if (dest_ext == "webp") {
 		err = img->save_webp(dest_path, lossy, 1.0);
 	} else if (dest_ext == "png") {
-		err = img->save_png(dest_path);
+		err = gdre::PNGEncoder::save_image_as_png(dest_path, img);
 	} else if (dest_ext == "tga") {
 		err = gdre::save_image_as_tga(dest_path, img);
 	} else if (dest_ext == "svg") {
@@ -415,6 +416,11 @@ Error TextureExporter::_convert_tex(const String &p_path, const String &dest_pat
 		auto iinfo = report->get_import_info();
 		if (iinfo.is_valid()) {
 			set_tex_params(iinfo, tex, img, iinfo->get_ver_major(), TEXTURE_2D);
+			if (iinfo->get_path() == p_path && ResourceInfo::resource_has_info(tex)) {
+				// textures never have external dependencies
+				report->resource_info = ResourceInfo::get_info_from_resource(tex);
+				report->dependencies_collected = true;
+			}
 		}
 	}
 	image_format = Image::get_format_name(img->get_format());
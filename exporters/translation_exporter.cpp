@@ -5,14 +5,16 @@
 #include "exporters/export_report.h"
 #include "utility/common.h"
 #include "utility/gd_parallel_hashmap.h"
+#include "utility/gdre_config.h"
 #include "utility/gdre_settings.h"
+#include "utility/word_scanner.h"
 
 #include "core/error/error_list.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
 #include "core/string/ustring.h"
-#include "modules/regex/regex.h"
+#include "core/templates/local_vector.h"
 
 Error TranslationExporter::export_file(const String &out_path, const String &res_path) {
 	// Implementation for exporting translation files
@@ -155,7 +157,7 @@ struct KeyWorker {
 	ParallelFlatHashSet<String> successful_suffixes;
 	ParallelFlatHashSet<String> successful_prefixes;
 
-	Ref<RegEx> word_regex;
+	gdre::WordScanner word_scanner;
 	std::atomic<uint64_t> current_keys_found = 0;
 	Vector<uint64_t> times;
 	Vector<uint64_t> keys_found;
@@ -235,101 +237,211 @@ struct KeyWorker {
 		}
 	};
 
-	template <typename T>
-	void find_common_prefixes_and_suffixes(const Vector<T> &res_strings, int count_threshold = 3, bool clear = false) {
-		HashMap<String, int> prefix_counts;
-		HashMap<String, int> suffix_counts;
+	// Open-addressing counter for substrings keyed by (hash, byte length). Only the location of the
+	// first occurrence is stored, so nothing is allocated per substring.
+	struct PartCounter {
+		struct Slot {
+			uint64_t hash = 0;
+			uint32_t len = 0; // 0 marks an empty slot
+			uint32_t count = 0;
+			uint32_t str_idx = 0;
+			uint32_t ofs = 0;
+		};
+		LocalVector<Slot> slots;
+		uint32_t used = 0;
 
-		if (clear) {
-			common_prefixes.clear();
-			common_suffixes.clear();
-		}
-		auto inc_counts = [&](HashMap<String, int> &counts, const String &part) {
-			if (part.is_empty()) {
-				return;
+		void add(uint64_t p_hash, uint32_t p_len, uint32_t p_str_idx, uint32_t p_ofs, uint32_t p_count = 1) {
+			if ((used + 1) * 4 > slots.size() * 3) {
+				_grow();
 			}
-			if (counts.has(part)) {
-				counts[part] += 1;
-			} else {
-				counts[part] = 1;
+			uint32_t mask = slots.size() - 1;
+			uint32_t idx = hash_fmix32((uint32_t)(p_hash ^ (p_hash >> 32))) & mask;
+			while (true) {
+				Slot &slot = slots[idx];
+				if (slot.len == 0) {
+					slot = { p_hash, p_len, p_count, p_str_idx, p_ofs };
+					used++;
+					return;
+				}
+				if (slot.hash == p_hash && slot.len == p_len) {
+					slot.count += p_count;
+					return;
+				}
+				idx = (idx + 1) & mask;
 			}
-		};
+		}
 
-		for (const auto &res_s : res_strings) {
-			if (res_s.is_empty()) {
-				continue;
+		void merge(const PartCounter &p_other) {
+			for (const Slot &slot : p_other.slots) {
+				if (slot.len != 0) {
+					add(slot.hash, slot.len, slot.str_idx, slot.ofs, slot.count);
+				}
 			}
-			auto parts = gdre::split_multichar(res_s, punctuation, false, 0);
-			String prefix = parts.size() > 0 ? parts[0] : "";
-			inc_counts(prefix_counts, prefix);
-			for (int i = 1; i < parts.size() - 1; i++) {
-				auto &part = parts[i];
-				int part_start_idx = prefix.length();
-				while (part_start_idx < res_s.length()) {
-					auto chr = res_s[part_start_idx];
-					if (punctuation.has(chr)) {
-						prefix += chr;
-					} else {
-						break;
-					}
-					part_start_idx++;
+		}
+
+		void _grow() {
+			LocalVector<Slot> old = slots;
+			slots.clear();
+			slots.resize(MAX(64U, old.size() * 2));
+			used = 0;
+			for (const Slot &slot : old) {
+				if (slot.len != 0) {
+					add(slot.hash, slot.len, slot.str_idx, slot.ofs, slot.count);
 				}
-				prefix += part;
-				inc_counts(prefix_counts, prefix);
 			}
-			auto suffix_parts = gdre::split_multichar(res_s, punctuation, false, 0);
-			String suffix = suffix_parts.size() > 0 ? suffix_parts[suffix_parts.size() - 1] : "";
-			inc_counts(suffix_counts, suffix);
-			// check if the suffix ends with a number
-			if (suffix.is_empty()) {
-				continue;
+		}
+	};
+
+	struct PrefixSuffixShard {
+		PartCounter prefixes;
+		PartCounter suffixes;
+	};
+
+	static constexpr uint64_t FNV64_BASIS = 0xcbf29ce484222325ULL;
+	static constexpr uint64_t FNV64_PRIME = 0x100000001b3ULL;
+	static constexpr int PREFIX_SUFFIX_SHARD_SIZE = 4096;
+
+	Vector<CharString> prefix_suffix_strings;
+	Vector<PrefixSuffixShard> prefix_suffix_shards;
+	bool punct_bytes[256] = {};
+
+	// Prefixes are the string up to the end of each part (bar the last); suffixes run from the start
+	// of each part (bar the first) to the end, with trailing digits also stripped off as a variant.
+	// Parts are the runs between punctuation, as with split_multichar.
+	void count_prefixes_and_suffixes(const CharString &p_str, uint32_t p_str_idx, PrefixSuffixShard &r_shard) {
+		const uint8_t *s = (const uint8_t *)p_str.get_data();
+		int64_t len = p_str.length();
+		int64_t first = 0;
+		while (first < len && punct_bytes[s[first]]) {
+			first++;
+		}
+		int64_t end = len;
+		while (end > first && punct_bytes[s[end - 1]]) {
+			end--;
+		}
+		if (first >= end) {
+			return;
+		}
+
+		// prefixes: hash forward from the first part, recording each part end once another part follows
+		uint64_t h = FNV64_BASIS;
+		uint64_t h_at_part_end = FNV64_BASIS;
+		int64_t part_end = -1;
+		bool multiple_parts = false;
+		for (int64_t i = first; i < end; i++) {
+			if (!punct_bytes[s[i]] && i > first && punct_bytes[s[i - 1]]) {
+				// a new part starts, so the previous one wasn't the last
+				r_shard.prefixes.add(h_at_part_end, part_end - first, p_str_idx, first);
+				multiple_parts = true;
 			}
-			int end_pad = 0;
-			char32_t last_char = suffix[suffix.length() - 1];
-			if (last_char >= '0' && last_char <= '9') {
-				// strip the trailing numbers
-				while (suffix.length() > 0) {
-					last_char = suffix[suffix.length() - 1];
-					if ((last_char >= '0' && last_char <= '9') || (punctuation.has(last_char))) {
-						suffix = suffix.substr(0, suffix.length() - 1);
-						end_pad++;
-					} else {
-						break;
-					}
-				}
-				inc_counts(suffix_counts, suffix);
+			h = (h ^ s[i]) * FNV64_PRIME;
+			if (!punct_bytes[s[i]] && (i + 1 == end || punct_bytes[s[i + 1]])) {
+				part_end = i + 1;
+				h_at_part_end = h;
 			}
+		}
+		if (!multiple_parts) {
+			r_shard.prefixes.add(h, end - first, p_str_idx, first);
+		}
 
-			for (int i = suffix_parts.size() - 2; i > 0; i--) {
-				auto &part = suffix_parts[i];
-				int part_end_idx = res_s.length() - (suffix.length() + end_pad) - 1;
-				while (part_end_idx > 0) {
-					auto chr = res_s[part_end_idx];
-					if (punctuation.has(chr)) {
-						suffix = chr + suffix;
-					} else {
-						break;
-					}
-					part_end_idx--;
+		// suffixes: hash backward, recording at part starts
+		int64_t last_start = end;
+		while (last_start > first && !punct_bytes[s[last_start - 1]]) {
+			last_start--;
+		}
+		auto scan_back = [&](int64_t p_from, int64_t p_to, bool p_all_parts) {
+			uint64_t bh = FNV64_BASIS;
+			for (int64_t j = p_from - 1; j >= p_to; j--) {
+				bh = (bh ^ s[j]) * FNV64_PRIME;
+				bool part_start = !punct_bytes[s[j]] && (j == first || punct_bytes[s[j - 1]]);
+				if (part_start && (j == last_start || (p_all_parts && j != first))) {
+					r_shard.suffixes.add(bh, p_from - j, p_str_idx, j);
 				}
-				suffix = part + suffix;
-				inc_counts(suffix_counts, suffix);
+			}
+		};
+		int64_t stripped_end = end;
+		while (stripped_end > last_start && s[stripped_end - 1] >= '0' && s[stripped_end - 1] <= '9') {
+			stripped_end--;
+		}
+		if (stripped_end == end) {
+			scan_back(end, first, true);
+		} else {
+			// the whole last part, then everything again without its trailing number
+			scan_back(end, last_start, false);
+			scan_back(stripped_end, first, true);
+		}
+	}
+
+	void prefix_suffix_shard_task(uint32_t p_shard, PrefixSuffixShard *p_shards) {
+		int64_t start = (int64_t)p_shard * PREFIX_SUFFIX_SHARD_SIZE;
+		int64_t stop = MIN(start + PREFIX_SUFFIX_SHARD_SIZE, prefix_suffix_strings.size());
+		PrefixSuffixShard &shard = p_shards[p_shard];
+		for (int64_t i = start; i < stop; i++) {
+			count_prefixes_and_suffixes(prefix_suffix_strings[i], i, shard);
+		}
+	}
+
+	void _add_common_parts(const PartCounter &p_counter, int p_count_threshold, Vector<String> &r_parts) {
+		HashSet<String> existing = gdre::vector_to_hashset(r_parts);
+		for (const PartCounter::Slot &slot : p_counter.slots) {
+			if (slot.len == 0 || (int)slot.count < p_count_threshold) {
+				continue;
+			}
+			String part = String::utf8(prefix_suffix_strings[slot.str_idx].get_data() + slot.ofs, slot.len);
+			if (!existing.has(part)) {
+				existing.insert(part);
+				r_parts.push_back(part);
 			}
 		}
-		for (const auto &E : prefix_counts) {
-			if (get_value(E) >= count_threshold && !common_prefixes.has(get_key(E))) {
-				common_prefixes.push_back(get_key(E));
+	}
+
+	Error find_common_prefixes_and_suffixes(const Vector<String> &res_strings, int count_threshold = 3, bool clear = false) {
+		if (clear) {
+			common_prefixes.clear();
+			common_suffixes.clear();
+		}
+		memset(punct_bytes, 0, sizeof(punct_bytes));
+		for (char32_t p : punctuation) {
+			if (p < 256) {
+				punct_bytes[p] = true;
 			}
 		}
-		for (const auto &E : suffix_counts) {
-			if (get_value(E) >= count_threshold && !common_suffixes.has(get_key(E))) {
-				common_suffixes.push_back(get_key(E));
+
+		prefix_suffix_strings.resize(res_strings.size());
+		for (int64_t i = 0; i < res_strings.size(); i++) {
+			prefix_suffix_strings.write[i] = res_strings[i].utf8();
+		}
+		int64_t shard_count = (res_strings.size() + PREFIX_SUFFIX_SHARD_SIZE - 1) / PREFIX_SUFFIX_SHARD_SIZE;
+		prefix_suffix_shards.clear();
+		prefix_suffix_shards.resize(shard_count);
+		Error err = OK;
+		if (shard_count > 0) {
+			err = TaskManager::get_singleton()->run_multithreaded_group_task(
+					this,
+					&KeyWorker::prefix_suffix_shard_task,
+					prefix_suffix_shards.ptrw(),
+					shard_count,
+					&KeyWorker::get_step_desc,
+					"KeyWorker::find_common_prefixes_and_suffixes",
+					"Counting key prefixes and suffixes", true, shard_count > 1 && use_multithread ? -1 : 1, true);
+		}
+
+		if (err == OK && shard_count > 0) {
+			PrefixSuffixShard &merged = prefix_suffix_shards.write[0];
+			for (int64_t i = 1; i < shard_count; i++) {
+				merged.prefixes.merge(prefix_suffix_shards[i].prefixes);
+				merged.suffixes.merge(prefix_suffix_shards[i].suffixes);
 			}
+			_add_common_parts(merged.prefixes, count_threshold, common_prefixes);
+			_add_common_parts(merged.suffixes, count_threshold, common_suffixes);
 		}
-		// sort the prefixes and suffixes by length
+		prefix_suffix_shards.clear();
+		prefix_suffix_strings.clear();
 
+		// sort the prefixes and suffixes by length
 		common_prefixes.sort_custom<StringLengthCompare<true>>();
 		common_suffixes.sort_custom<StringLengthCompare<true>>();
+		return err;
 	}
 
 	_FORCE_INLINE_ void _set_key_stuff(const String &key) {
@@ -379,12 +491,9 @@ struct KeyWorker {
 		return false;
 	}
 
-	_FORCE_INLINE_ bool try_key(const char *key) {
-		auto msg = default_translation->get_message_str(key);
-		if (!msg.is_empty()) {
-			return _set_key(key, msg);
-		}
-		return false;
+	// p_match is a UTF-8 span from the word scanner; the key may contain non-ASCII characters from the prefix
+	_FORCE_INLINE_ bool try_key(const char *p_match, int64_t p_len) {
+		return try_key(String::utf8(p_match, p_len));
 	}
 
 	constexpr bool is_empty_or_null(const char *str) {
@@ -698,19 +807,14 @@ struct KeyWorker {
 		last_completed++;
 	}
 
-	void partial_task(uint32_t i, String *res_strings) {
+	void partial_task(uint32_t i, CharString *res_strings) {
 		if (unlikely(cancel)) {
 			return;
 		}
-		const String &res_s = res_strings[i];
-		if (!has_common_prefix || res_s.contains(common_to_all_prefix)) {
-			auto matches = word_regex->search_all(res_s);
-			for (const Ref<RegExMatch> match : matches) {
-				for (const String &key : match->get_strings()) {
-					try_key(key);
-				}
-			}
-		}
+		const CharString &res_s = res_strings[i];
+		word_scanner.scan(res_s.get_data(), res_s.length(), [&](const char *p_match, int64_t p_len) {
+			try_key(p_match, p_len);
+		});
 		last_completed++;
 	}
 
@@ -1073,21 +1177,15 @@ struct KeyWorker {
 		// look for keys in every PART of the resource strings
 		// Only do this if no keys have spaces or punctuation is only one character, otherwise it's practically useless
 		if (key_to_message.size() != default_messages.size() && (!keys_have_whitespace || punctuation.size() == 1)) {
-			Ref<RegEx> re;
-			word_regex.instantiate();
-
-			String char_re = "[\\w\\d";
-			for (char32_t p : punctuation) {
-				char_re += "\\" + String::chr(p);
-			}
-			char_re += "]";
-			if (!keys_have_whitespace) {
-				word_regex->compile(common_to_all_prefix + char_re + "+");
-			} else {
-				word_regex->compile("\\b" + common_to_all_prefix + char_re + "+" + "\\b");
+			// equivalent to searching for `<common prefix>[\w\d<key punctuation>]+`, with \b anchors if keys have whitespace
+			word_scanner = gdre::WordScanner(common_to_all_prefix, punctuation, keys_have_whitespace);
+			Vector<CharString> resource_strings_t;
+			resource_strings_t.resize(resource_strings.size());
+			for (int64_t i = 0; i < resource_strings.size(); i++) {
+				resource_strings_t.write[i] = resource_strings[i].utf8();
 			}
 
-			err = run_stage(&KeyWorker::partial_task, resource_strings, "Stage 2");
+			err = run_stage(&KeyWorker::partial_task, resource_strings_t, "Stage 2");
 			if (err != OK) {
 				return pop_keys();
 			}
@@ -1159,7 +1257,10 @@ struct KeyWorker {
 		do_stage_4 = do_stage_4 && key_to_message.size() != default_messages.size();
 		if (do_stage_4 && key_to_message.size() != default_messages.size()) {
 			auto curr_keys = get_keys(key_to_message);
-			find_common_prefixes_and_suffixes(curr_keys);
+			err = find_common_prefixes_and_suffixes(curr_keys);
+			if (err != OK) {
+				return pop_keys();
+			}
 
 			Vector<String> middle_candidates;
 			extract_middles(filtered_resource_strings, middle_candidates);
@@ -1232,6 +1333,84 @@ struct KeyWorker {
 	}
 };
 
+void TranslationExporter::find_common_prefixes_and_suffixes(const Vector<String> &p_keys, const HashSet<char32_t> &p_punctuation, int p_count_threshold, Vector<String> &r_prefixes, Vector<String> &r_suffixes) {
+	Ref<OptimizedTranslation> empty_translation;
+	empty_translation.instantiate();
+	KeyWorker kw(empty_translation, {});
+	kw.punctuation = p_punctuation;
+	kw.find_common_prefixes_and_suffixes(p_keys, p_count_threshold);
+	r_prefixes = kw.common_prefixes;
+	r_suffixes = kw.common_suffixes;
+}
+
+namespace {
+constexpr uint32_t CSV_WRITE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// Same quoting rules as FileAccess::store_csv_line with a "," delimiter, applied to UTF-8 bytes.
+void append_csv_field(LocalVector<uint8_t> &r_buf, const char *p_data, int64_t p_len) {
+	bool needs_quotes = false;
+	for (int64_t i = 0; i < p_len; i++) {
+		if (p_data[i] == '"' || p_data[i] == ',' || p_data[i] == '\n') {
+			needs_quotes = true;
+			break;
+		}
+	}
+	if (!needs_quotes) {
+		uint32_t ofs = r_buf.size();
+		r_buf.resize(ofs + p_len);
+		memcpy(r_buf.ptr() + ofs, p_data, p_len);
+		return;
+	}
+	r_buf.push_back('"');
+	for (int64_t i = 0; i < p_len; i++) {
+		if (p_data[i] == '"') {
+			r_buf.push_back('"');
+		}
+		r_buf.push_back(p_data[i]);
+	}
+	r_buf.push_back('"');
+}
+
+// Yields one locale's messages in get_translated_message_list() order.
+struct LocaleMessages {
+	// Plain translations hand out their StringName data, so this list doesn't copy the message text.
+	Vector<String> messages;
+	// Optimized translations would have to decompress every message up front; read them one at a time instead.
+	OptimizedTranslationExtractor::MessageIterator iterator;
+	bool optimized = false;
+	int64_t count = 0;
+	int64_t next_index = 0;
+
+	LocaleMessages() {}
+	LocaleMessages(const Ref<Translation> &p_translation) {
+		Ref<OptimizedTranslation> otr = p_translation;
+		if (otr.is_valid()) {
+			Ref<OptimizedTranslationExtractor> extractor = OptimizedTranslationExtractor::create_from(otr);
+			iterator = OptimizedTranslationExtractor::MessageIterator(extractor);
+			count = extractor->get_message_count();
+			optimized = true;
+		} else {
+			messages = p_translation->get_translated_message_list();
+			count = messages.size();
+		}
+	}
+
+	// Rows are written in order, so p_index only ever advances by one.
+	bool next(int64_t p_index, CharString &r_utf8) {
+		if (p_index >= count) {
+			return false;
+		}
+		DEV_ASSERT(p_index == next_index);
+		next_index++;
+		if (optimized) {
+			return iterator.next(r_utf8);
+		}
+		r_utf8 = messages[p_index].utf8();
+		return true;
+	}
+};
+} //namespace
+
 Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir, Ref<ImportInfo> iinfo) {
 	// Implementation for exporting resources related to translations
 	Error err = OK;
@@ -1257,9 +1436,9 @@ Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir,
 	}
 	bl_debug("Exporting translation file " + iinfo->get_export_dest());
 	Vector<Ref<Translation>> translations;
-	Vector<Vector<String>> translation_messages;
+	Vector<LocaleMessages> translation_messages;
 	Ref<Translation> default_translation;
-	Vector<String> default_messages;
+	int64_t default_message_count = 0;
 	String header = "key";
 	Vector<String> keys;
 	Ref<ExportReport> report = memnew(ExportReport(iinfo));
@@ -1281,9 +1460,9 @@ Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir,
 				}
 			}
 		}
-		Vector<String> messages = tr->get_translated_message_list();
+		LocaleMessages messages(tr);
 		if (locale.to_lower() == default_locale.to_lower()) {
-			default_messages = messages;
+			default_message_count = messages.count;
 			default_translation = tr;
 		}
 		translation_messages.push_back(messages);
@@ -1293,7 +1472,7 @@ Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir,
 	if (default_translation.is_null()) {
 		if (!has_default_translation) {
 			default_translation = translations[0];
-			default_messages = translation_messages[0];
+			default_message_count = translation_messages[0].count;
 		} else {
 			report->set_error(ERR_FILE_MISSING_DEPENDENCIES);
 			ERR_FAIL_V_MSG(report, "No default translation found for " + iinfo->get_path());
@@ -1317,7 +1496,7 @@ Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir,
 	String export_dest = iinfo->get_export_dest();
 	// If greater than 15% of the keys are missing, we save the file to the export directory.
 	// The reason for this threshold is that the translations may contain keys that are not currently in use in the project.
-	bool resave = missing_keys > (default_messages.size() * threshold);
+	bool resave = missing_keys > (default_message_count * threshold);
 	if (resave) {
 		iinfo->set_export_dest("res://.assets/" + iinfo->get_export_dest().replace("res://", ""));
 	}
@@ -1332,24 +1511,33 @@ Ref<ExportReport> TranslationExporter::export_resource(const String &output_dir,
 	f->store_8(0xbb);
 	f->store_8(0xbf);
 	f->store_string(header);
+	// Rows are built as UTF-8 straight into a large buffer; messages are pulled one row at a time
+	// instead of holding every locale's full message list as Strings.
+	LocalVector<uint8_t> buf;
+	buf.reserve(CSV_WRITE_BUFFER_SIZE + 4096);
+	CharString message;
 	for (int i = 0; i < keys.size(); i++) {
-		Vector<String> line_values;
-		line_values.push_back(keys[i]);
-		for (auto messages : translation_messages) {
-			if (i >= messages.size()) {
-				line_values.push_back("");
-			} else {
-				line_values.push_back(messages[i]);
+		CharString key = keys[i].utf8();
+		append_csv_field(buf, key.get_data(), key.length());
+		for (LocaleMessages &messages : translation_messages) {
+			buf.push_back(',');
+			if (messages.next(i, message)) {
+				append_csv_field(buf, message.get_data(), message.length());
 			}
 		}
-		f->store_csv_line(line_values, ",");
+		buf.push_back('\n');
+		if (buf.size() >= CSV_WRITE_BUFFER_SIZE) {
+			f->store_buffer(buf.ptr(), buf.size());
+			buf.clear();
+		}
 	}
+	f->store_buffer(buf.ptr(), buf.size());
 	f->flush();
 	f->close();
 	report->set_error(OK);
 	Dictionary extra_info;
 	extra_info["missing_keys"] = missing_keys;
-	extra_info["total_keys"] = default_messages.size();
+	extra_info["total_keys"] = default_message_count;
 	report->set_extra_info(extra_info);
 	if (missing_keys) {
 		String translation_export_message = "WARNING: Could not recover " + itos(missing_keys) + " keys for " + iinfo->get_source_file() + "\n";
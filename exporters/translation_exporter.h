@@ -9,6 +9,9 @@ class TranslationExporter : public ResourceExporter {
 public:
 	static constexpr float threshold = 0.15; // TODO: put this in the project configuration
 
+	// The prefixes and suffixes shared by at least p_count_threshold of p_keys, as found by the missing key search.
+	static void find_common_prefixes_and_suffixes(const Vector<String> &p_keys, const HashSet<char32_t> &p_punctuation, int p_count_threshold, Vector<String> &r_prefixes, Vector<String> &r_suffixes);
+
 	virtual Error export_file(const String &out_path, const String &res_path) override;
 	virtual Ref<ExportReport> export_resource(const String &output_dir, Ref<ImportInfo> import_infos) override;
 	virtual void get_handled_types(List<String> *out) const override;
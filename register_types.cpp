@@ -5,6 +5,7 @@
 #include "register_types.h"
 #include "compat/fake_script.h"
 #include "core/object/class_db.h"
+#include "core/os/os.h"
 #include "modules/regex/regex.h"
 #include "utility/file_access_gdre.h"
 #include "utility/gdre_audio_stream_preview.h"
@@ -22,6 +23,7 @@
 #include "compat/resource_compat_binary.h"
 #include "compat/resource_compat_text.h"
 #include "compat/resource_loader_compat.h"
+#include "compat/resource_resolution_context.h"
 #include "compat/sample_loader_compat.h"
 #include "compat/script_loader.h"
 #include "compat/texture_loader_compat.h"
@@ -42,6 +44,7 @@
 #include "utility/common.h"
 #include "utility/gdre_config.h"
 #include "utility/gdre_settings.h"
+#include "utility/export_report_model.h"
 #include "utility/github_source.h"
 #include "utility/gitlab_source.h"
 #include "utility/glob.h"
@@ -52,6 +55,9 @@
 #include "utility/pck_creator.h"
 #include "utility/pck_dumper.h"
 #include "utility/plugin_manager.h"
+#include "utility/png_encoder.h"
+#include "utility/project_loader.h"
+#include "utility/report_log.h"
 #include "utility/task_manager.h"
 
 #include "module_etc_decompress/register_types.h"
@@ -102,6 +108,35 @@ static Ref<GitHubSource> github_source = nullptr;
 static Ref<AssetLibrarySource> asset_library_source = nullptr;
 static Ref<GitLabSource> gitlab_source = nullptr;
 
+// Set GDRE_STARTUP_TIMINGS in the environment to print how long each phase of module initialization took.
+// This only measures startup: class, loader and exporter registration below is still eager.
+struct StartupTimer {
+	bool enabled = false;
+	uint64_t start = 0;
+	uint64_t last = 0;
+
+	StartupTimer() {
+		enabled = OS::get_singleton()->has_environment("GDRE_STARTUP_TIMINGS");
+		start = OS::get_singleton()->get_ticks_usec();
+		last = start;
+	}
+
+	void phase(const char *p_name) {
+		if (!enabled) {
+			return;
+		}
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		print_line(vformat("[startup] %s: %.2fms", p_name, (now - last) / 1000.0));
+		last = now;
+	}
+
+	void total() {
+		if (enabled) {
+			print_line(vformat("[startup] gdsdecomp total: %.2fms (engine ticks at end: %dms)", (OS::get_singleton()->get_ticks_usec() - start) / 1000.0, OS::get_singleton()->get_ticks_msec()));
+		}
+	}
+};
+
 void init_ver_regex() {
 	SemVer::strict_regex = RegEx::create_from_string(GodotVer::strict_regex_str);
 	GodotVer::non_strict_regex = RegEx::create_from_string(GodotVer::non_strict_regex_str);
@@ -298,6 +333,7 @@ void initialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+	StartupTimer timer;
 #ifdef TOOLS_ENABLED
 	ClassDB::register_class<PackDialog>();
 	ClassDB::register_class<NewPackDialog>();
@@ -311,8 +347,11 @@ void initialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 	ClassDB::register_class<Glob>();
 	init_ver_regex();
 
+	timer.phase("version regexes");
+
 	ClassDB::register_abstract_class<GDScriptDecomp>();
 	register_decomp_versions();
+	timer.phase("bytecode classes");
 
 	ClassDB::register_class<FileAccessGDRE>();
 
@@ -363,6 +402,9 @@ void initialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 	ClassDB::register_class<ImportInfoGDExt>();
 	ClassDB::register_class<ImportExporter>();
 	ClassDB::register_class<ImportExporterReport>();
+	ClassDB::register_class<ReportLogReader>();
+	ClassDB::register_class<ExportReportModel>();
+	ClassDB::register_class<ProjectLoader>();
 	ClassDB::register_class<GDRESettings>();
 
 	ClassDB::register_class<PackedFileInfo>();
@@ -385,12 +427,15 @@ void initialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 
 	ClassDB::register_class<GDREConfig>();
 	ClassDB::register_class<GDREConfigSetting>();
+	timer.phase("class registration");
 
 	init_plugin_manager_sources();
 	gdre_singleton = memnew(GDRESettings);
 	Engine::get_singleton()->add_singleton(Engine::Singleton("GDRESettings", GDRESettings::get_singleton()));
+	timer.phase("GDRESettings");
 	gdre_config = memnew(GDREConfig);
 	Engine::get_singleton()->add_singleton(Engine::Singleton("GDREConfig", GDREConfig::get_singleton()));
+	timer.phase("GDREConfig");
 	audio_stream_preview_generator = memnew(GDREAudioStreamPreviewGenerator);
 	Engine::get_singleton()->add_singleton(Engine::Singleton("GDREAudioStreamPreviewGenerator", GDREAudioStreamPreviewGenerator::get_singleton()));
 	task_manager = memnew(TaskManager);
@@ -400,12 +445,18 @@ void initialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 #endif
 	init_loaders();
 	init_exporters();
+	timer.phase("loaders and exporters");
+	gdre::PNGEncoder::install_image_hooks();
 	initialize_etcpak_decompress_module(p_level);
+	timer.phase("etcpak");
+	timer.total();
 }
 
 void uninitialize_gdsdecomp_module(ModuleInitializationLevel p_level) {
 	uninitialize_etcpak_decompress_module(p_level);
+	gdre::PNGEncoder::uninstall_image_hooks();
 	deinit_exporters();
+	ResourceResolutionContext::clear_shared();
 	deinit_loaders();
 	if (gdre_singleton) {
 		memdelete(gdre_singleton);
@@ -21,6 +21,12 @@ var num_broken:int = 0
 var num_malformed:int = 0
 var _is_test:bool = false
 var report: ImportExporterReport = null
+var model: ExportReportModel = null
+var FILTER_EDIT: LineEdit = null
+
+# Files are only added to the tree when their section is expanded, a page at a time
+const ROWS_PER_PAGE: int = 500
+const SHOW_MORE_META: String = "__show_more__"
 
 const skippable_keys: PackedStringArray = ["rewrote_metadata", "failed_rewrite_md5"]
 
@@ -33,6 +39,7 @@ signal report_done()
 func _ready():
 	NOTE_TREE = 	 %NoteTree
 	TOTALS_TREE =    %TotalsTree
+	FILTER_EDIT = %FilterEdit
 	EDITOR_MESSAGE_LABEL = %EditorMessageLabel
 	LOG_FILE_LABEL = %LogFileLabel
 	editor_message_default_text = EDITOR_MESSAGE_LABEL.text
@@ -144,7 +151,6 @@ func add_report(rep: ImportExporterReport) -> int:
 	add_ver_string(report.get_ver())
 	add_log_file(report.get_log_file_location())
 	var notes = report.get_session_notes()
-	var report_sections: Dictionary = report.get_report_sections()
 	var report_labels: Dictionary = report.get_section_labels()
 	# iterate over all the keys in the notes
 	# add fake root
@@ -160,40 +166,87 @@ func add_report(rep: ImportExporterReport) -> int:
 			for item in note_dict["details"]:
 				var subitem = NOTE_TREE.create_item(header_item)
 				subitem.set_text(0, item)
-	for key in report_sections.keys():
+	model = ExportReportModel.new()
+	model.set_report(report)
+	for key in model.get_sections():
 		if skippable_keys.has(key):
 			continue
-		var section:Variant = report_sections[key]
 		var header_item = TOTALS_TREE.create_item(report_root)
 		header_item.set_text(0, report_labels.get(key, key))
-		# check that section is actually a dictionary
-		if typeof(section) == TYPE_DICTIONARY:
-			var dict :Dictionary = section
-			header_item.set_text(1, String.num_uint64(dict.keys().size()))
-			# iterate over all the keys in the section
-			for subkey in dict.keys():
-				var subitem = TOTALS_TREE.create_item(header_item)
-				subitem.set_text(1, subkey)
-				subitem.set_text(0, dict[subkey])
-		elif typeof(section) == TYPE_PACKED_STRING_ARRAY:
-			var arr: PackedStringArray = section
-			header_item.set_text(1, String.num_uint64(arr.size()))
-			for i in range(arr.size()):
-				var subitem = TOTALS_TREE.create_item(header_item)
-				subitem.set_text(0, arr[i])
-				subitem.set_text(1, "")
-		else:
-			print("Unknown type for section: " + String.num(typeof(section)))
-			continue
-		header_item.set_collapsed_recursive(true)
+		header_item.set_metadata(0, key)
+		_update_section_header(header_item)
+		header_item.set_collapsed(true)
 
 
 	return OK
 
 
+func _update_section_header(header_item: TreeItem):
+	var key: String = header_item.get_metadata(0)
+	var total = model.get_section_size(key)
+	var shown = model.get_view_size(key)
+	if shown == total:
+		header_item.set_text(1, String.num_uint64(total))
+	else:
+		header_item.set_text(1, String.num_uint64(shown) + " / " + String.num_uint64(total))
+	for child in header_item.get_children():
+		child.free()
+	# placeholder so the section can be expanded; the rows are created on expand
+	if shown > 0:
+		TOTALS_TREE.create_item(header_item)
+
+
+func _populate_section(header_item: TreeItem, from: int):
+	var key: String = header_item.get_metadata(0)
+	if from == 0:
+		for child in header_item.get_children():
+			child.free()
+	var rows: Array = model.get_rows(key, from, ROWS_PER_PAGE)
+	for row in rows:
+		var subitem = TOTALS_TREE.create_item(header_item)
+		subitem.set_text(0, row[0])
+		subitem.set_text(1, row[1])
+	var next = from + rows.size()
+	var remaining = model.get_view_size(key) - next
+	if remaining > 0:
+		var more_item = TOTALS_TREE.create_item(header_item)
+		more_item.set_text(0, "Show more... (" + String.num_uint64(remaining) + " remaining)")
+		more_item.set_metadata(0, SHOW_MORE_META)
+		more_item.set_metadata(1, next)
+
+
+func _on_totals_item_collapsed(item: TreeItem):
+	if item.collapsed or item.get_parent() != TOTALS_TREE.get_root() or model == null:
+		return
+	_populate_section(item, 0)
+
+
+func _on_totals_item_activated():
+	var item = TOTALS_TREE.get_selected()
+	if item == null or item.get_metadata(0) != SHOW_MORE_META:
+		return
+	var header_item = item.get_parent()
+	var next: int = item.get_metadata(1)
+	item.free()
+	_populate_section(header_item, next)
+
+
+func _on_filter_changed(new_text: String):
+	if model == null:
+		return
+	for header_item in TOTALS_TREE.get_root().get_children():
+		var key: String = header_item.get_metadata(0)
+		model.set_filter(key, new_text)
+		_update_section_header(header_item)
+		if not header_item.collapsed:
+			_populate_section(header_item, 0)
+
+
 func clear():
 	NOTE_TREE.clear()
 	TOTALS_TREE.clear()
+	FILTER_EDIT.text = ""
+	model = null
 	EDITOR_MESSAGE_LABEL.text = editor_message_default_text
 	LOG_FILE_LABEL.text = log_file_default_text
 	report = null
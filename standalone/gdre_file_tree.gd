@@ -60,13 +60,18 @@ enum ColType {
 		var items = get_all_file_items()
 		if items.is_empty():
 			return
+		# the folders are freed going into flat mode and recreated coming out of it
+		_folder_items.clear()
 		for item in items:
 			var size = item.get_metadata(_size_col) if _size_col_exists else -1
 			var info = item.get_text(_info_col) if _info_col_exists else ""
 			var error_str = ""
 			if item.get_icon(_name_col) == file_broken:
 				error_str = item.get_tooltip_text(_name_col)
-			add_file_tree_item(item.get_metadata(_name_col), item.get_icon(_name_col), size or -1, error_str, info)
+			var path = item.get_metadata(_name_col)
+			var new_item = add_file_tree_item(path, item.get_icon(_name_col), size or -1, error_str, info)
+			if _file_items.has(path):
+				_file_items[path] = new_item
 			item.get_parent().remove_child(item)
 		if flat_mode:
 			for item in get_all_folder_items(get_root()):
@@ -126,6 +131,10 @@ var userroot: TreeItem = null
 var num_files:int = 0
 var num_broken:int = 0
 var num_malformed:int = 0
+# Only filled in by add_loader_batch, which has to find files again when they are republished.
+var _file_items: Dictionary[String, TreeItem] = {}
+var _folder_items: Dictionary[String, TreeItem] = {}
+var collapse_new_folders: bool = false
 var right_click_menu: PopupMenu = null
 var right_clicked_item: TreeItem = null
 
@@ -518,6 +527,15 @@ func set_fold_all(item: TreeItem, collapsed: bool = true, recursive: bool = fals
 
 # creating and adding items
 
+func _get_size_text(p_size: int) -> String:
+	if (p_size < (1024)):
+		return String.num_int64(p_size) + " B"
+	elif (p_size < (1024 * 1024)):
+		return String.num(float(p_size) / 1024, 2) + " KiB"
+	elif (p_size < (1024 * 1024 * 1024)):
+		return String.num(float(p_size) / (1024 * 1024), 2) + " MiB"
+	return String.num(float(p_size) / (1024 * 1024 * 1024), 2) + " GiB"
+
 func create_file_item(p_parent_item: TreeItem, p_fullname: String, p_name: String, p_icon: Texture2D, p_size: int = -1, p_error: String = "", p_info: String = "", p_idx: int = -1) -> TreeItem:
 	var item: TreeItem = p_parent_item.create_child(p_idx)
 	if check_mode:
@@ -529,14 +547,7 @@ func create_file_item(p_parent_item: TreeItem, p_fullname: String, p_name: Strin
 	item.set_metadata(_name_col, p_fullname)
 	if _size_col_exists:
 		if p_size > -1:
-			if (p_size < (1024)):
-				item.set_text(_size_col, String.num_int64(p_size) + " B")
-			elif (p_size < (1024 * 1024)):
-				item.set_text(_size_col, String.num(float(p_size) / 1024, 2) + " KiB")
-			elif (p_size < (1024 * 1024 * 1024)):
-				item.set_text(_size_col, String.num(float(p_size) / (1024 * 1024), 2) + " MiB")
-			else:
-				item.set_text(_size_col, String.num(float(p_size) / (1024 * 1024 * 1024), 2) + " GiB")
+			item.set_text(_size_col, _get_size_text(p_size))
 		else:
 			p_size = 0
 		item.set_metadata(_size_col, p_size)
@@ -553,7 +564,53 @@ func add_files_from_packed_infos(infos: Array, skipped_md5_check: bool = false):
 	sort_entire_tree()
 	set_fold_all_children(root, true, true)
 
-func _add_file_from_packed_info(info: PackedFileInfo, skipped_md5_check: bool = false):
+# Adds a batch popped off a ProjectLoader. Files are published again when a later pack replaces them and once their
+# MD5 has been checked, so those update the existing item instead of adding a second one.
+func add_loader_batch(batch: Dictionary):
+	for path in batch.get("removed", PackedStringArray()):
+		remove_file_item(path)
+	var md5_checked: bool = batch.get("md5_checked", false)
+	for info: PackedFileInfo in batch.get("files", []):
+		var item: TreeItem = _file_items.get(info.get_path())
+		if item == null:
+			_file_items[info.get_path()] = _add_file_from_packed_info(info, true)
+		elif md5_checked:
+			_update_file_item_md5(item, info)
+		else:
+			_update_file_item_size(item, info.get_size())
+
+func _update_file_item_md5(item: TreeItem, info: PackedFileInfo):
+	if info.is_malformed():
+		return
+	if info.is_checksum_validated():
+		item.set_icon(_name_col, file_ok)
+	elif info.has_md5() and item.get_icon(_name_col) != file_broken:
+		item.set_icon(_name_col, file_broken)
+		if _size_col_exists:
+			item.set_tooltip_text(_size_col, "Checksum mismatch")
+		num_broken += 1
+
+func _update_file_item_size(item: TreeItem, file_size: int):
+	if not _size_col_exists:
+		return
+	item.set_text(_size_col, _get_size_text(file_size))
+	item.set_metadata(_size_col, file_size)
+
+func remove_file_item(path: String):
+	var item: TreeItem = _file_items.get(path)
+	if item == null:
+		return
+	_file_items.erase(path)
+	if item.get_icon(_name_col) == file_broken:
+		if _size_col_exists and item.get_tooltip_text(_size_col) == "Malformed path":
+			num_malformed -= 1
+		else:
+			num_broken -= 1
+	num_files -= 1
+	item.get_parent().remove_child(item)
+	item.free()
+
+func _add_file_from_packed_info(info: PackedFileInfo, skipped_md5_check: bool = false) -> TreeItem:
 	num_files += 1
 	var file_size = info.get_size()
 	var path = info.get_path()
@@ -575,11 +632,10 @@ func _add_file_from_packed_info(info: PackedFileInfo, skipped_md5_check: bool =
 		icon = file_broken
 		errstr = "Checksum mismatch"
 		num_broken += 1
-	var item
-
-	add_file_tree_item(path, icon, file_size, errstr, p_info)
+	var item = add_file_tree_item(path, icon, file_size, errstr, p_info)
 	if (num_files > LARGE_PCK):
 		FILTER_DELAY = 0.5
+	return item
 
 func add_file_tree_item(path: String, icon: Texture2D, file_size: int = -1, errstr: String = "", p_info: String = ""):
 	var root_name = root.get_text(_name_col) if root else ""
@@ -621,14 +677,13 @@ func add_file_to_item_node_mode(p_item: TreeItem, p_fullname: String, p_name: St
 	else:
 		var fld_name: String = p_name.substr(_name_col, pp);
 		var path: String = p_name.substr(pp + 1, p_name.length());
-		# Add folder if any
-		var it: TreeItem = p_item.get_first_child();
-		while (it) :
-			if (it.get_text(_name_col) == fld_name) :
-				return add_file_to_item_node_mode(it, p_fullname, path, p_icon, p_size, p_error, p_info);
-			it = it.get_next()
-
-		var folder_item:TreeItem = create_file_item(p_item, "", fld_name, folder_icon, -1, "", "")
+		# Add folder if any; scanning the children is quadratic in the folder size, so look it up instead
+		var folder_key: String = str(p_item.get_instance_id()) + "/" + fld_name
+		var folder_item: TreeItem = _folder_items.get(folder_key)
+		if folder_item == null:
+			folder_item = create_file_item(p_item, "", fld_name, folder_icon, -1, "", "")
+			folder_item.collapsed = collapse_new_folders
+			_folder_items[folder_key] = folder_item
 		return add_file_to_item_node_mode(folder_item, p_fullname, path, p_icon, p_size, p_error, p_info);
 
 # filtering
@@ -716,6 +771,8 @@ func _clear():
 	if (userroot != null):
 		userroot = null
 	self.clear()
+	_file_items.clear()
+	_folder_items.clear()
 	num_files = 0
 	num_broken = 0
 	num_malformed = 0
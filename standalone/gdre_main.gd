@@ -192,19 +192,23 @@ func launch_recovery_window(paths: PackedStringArray):
 	#RECOVERY_DIALOG.set_root_window(REAL_ROOT_WINDOW)
 	#REAL_ROOT_WINDOW.add_child(RECOVERY_DIALOG)
 	#REAL_ROOT_WINDOW.move_child(RECOVERY_DIALOG, self.get_index() -1)
+	# the project loads in the background while the dialog is up; a failure is reported through project_load_failed
 	var err = RECOVERY_DIALOG.add_project(paths)
 	if err != OK:
-		var errors = (GDRESettings.get_errors())
-		var error_msg = ""
-		for error in errors:
-			error_msg += error.strip_edges() + "\n"
-		if error_msg.to_lower().contains("encrypt"):
-			error_msg = "Incorrect encryption key. Please set the correct key and try again."
-		popup_error_box("Error: failed to open " + str(paths) + ":\n" + error_msg, "Error")
+		_on_project_load_failed(paths)
 		return
 
 	RECOVERY_DIALOG.show_win()
 
+func _on_project_load_failed(paths: PackedStringArray):
+	var errors = (GDRESettings.get_errors())
+	var error_msg = ""
+	for error in errors:
+		error_msg += error.strip_edges() + "\n"
+	if error_msg.to_lower().contains("encrypt"):
+		error_msg = "Incorrect encryption key. Please set the correct key and try again."
+	popup_error_box("Error: failed to open " + str(paths) + ":\n" + error_msg, "Error")
+
 func setup_new_pck_window():
 	pass
 
@@ -612,9 +616,13 @@ func _process(_delta):
 
 func _ready():
 	$version_lbl.text = GDRESettings.get_gdre_version()
+	if OS.has_environment("GDRE_STARTUP_TIMINGS"):
+		print("[startup] main scene ready: %dms" % Time.get_ticks_msec())
 	# If CLI arguments were passed in, just quit
 	var args = get_sanitized_args()
 	if handle_cli(args):
+		if OS.has_environment("GDRE_STARTUP_TIMINGS"):
+			print("[startup] command finished: %dms" % Time.get_ticks_msec())
 		get_tree().quit()
 		return
 	var show_disclaimer = should_show_disclaimer()
@@ -634,6 +642,7 @@ func _ready():
 	$LegalNoticeWindow/OkButton.connect("pressed", $LegalNoticeWindow.hide)
 	$LegalNoticeWindow.connect("close_requested", $LegalNoticeWindow.hide)
 	%GdreRecover.connect("recovery_confirmed", self._on_recovery_confirmed)
+	%GdreRecover.connect("project_load_failed", self._on_project_load_failed)
 	# check if the current screen is hidpi
 	if isHiDPI:
 		# set the content scaling factor to 2x
@@ -747,6 +756,7 @@ var RECOVER_OPTS_NOTES = """Recover/Extract Options:
 --key=<KEY>                 The Key to use if project is encrypted as a 64-character hex string,
 							e.g.: '000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F'
 --output=<DIR>              Output directory, defaults to <NAME_extracted>, or the project directory if one of specified
+							A path ending in .zip, .tar or .tar.zst writes the output straight into that archive
 --scripts-only              Only extract/recover scripts
 --include=<GLOB>            Include files matching the glob pattern (can be repeated)
 --exclude=<GLOB>            Exclude files matching the glob pattern (can be repeated)
@@ -862,6 +872,9 @@ func recovery(  input_files:PackedStringArray,
 			output_dir += "_recovery"
 	else:
 		output_dir = get_cli_abs_path(output_dir)
+	var output_archive = ""
+	if GDRECommon.is_archive_path(output_dir):
+		output_archive = output_dir
 
 	da = DirAccess.open(input_file.get_base_dir())
 
@@ -891,7 +904,8 @@ func recovery(  input_files:PackedStringArray,
 		print("Error: failed to locate " + input_file)
 		return
 
-	GDRESettings.open_log_file(output_dir)
+	# the log can't go in the archive, it's written to as we go
+	GDRESettings.open_log_file(output_dir if output_archive == "" else output_archive.get_base_dir())
 	if (enc_key != ""):
 		err = GDRESettings.set_encryption_key_string(enc_key)
 		if (err != OK):
@@ -960,35 +974,51 @@ func recovery(  input_files:PackedStringArray,
 			print(GLOB_NOTES)
 			return
 
-	if output_dir != input_file and not is_dir:
+	if output_dir != input_file and not is_dir and output_archive == "":
 		if (da.file_exists(output_dir)):
 			print("Error: output dir appears to be a file, not extracting...")
 			return
+	if is_dir and extract_only:
+		print("Why did you open a folder to extract it??? What's wrong with you?!!?")
+		return
+	# everything written under the archive path from here on goes into the archive
+	if output_archive != "" and GDRECommon.begin_archive_output(output_archive) != OK:
+		print("Error: failed to open " + output_archive + " for writing")
+		return
 	if is_dir:
-		if extract_only:
-			print("Why did you open a folder to extract it??? What's wrong with you?!!?")
-			return
 		if output_dir.simplify_path() != input_file.simplify_path() and GDRECommon.copy_dir(input_file, output_dir) != OK:
 			print("Error: failed to copy " + input_file + " to " + output_dir)
+			end_output_archive(output_archive)
 			return
 	else:
 		err = dump_files(output_dir, files, ignore_checksum_errors)
 		if (err != OK):
 			print("Error: failed to extract PAK file, not exporting assets")
+			end_output_archive(output_archive)
 			return
 	var end_time;
 	var secs_taken;
 	if (extract_only):
+		end_output_archive(output_archive)
 		end_time = Time.get_ticks_msec()
 		secs_taken = (end_time - start_time) / 1000
 		print("Extraction operation complete in %02dm%02ds" % [(secs_taken) / 60, (secs_taken) % 60])
 		return
 	export_imports(output_dir, files)
+	end_output_archive(output_archive)
 	end_time = Time.get_ticks_msec()
 	secs_taken = (end_time - start_time) / 1000
 	print("Recovery complete in %02dm%02ds" % [(secs_taken) / 60, (secs_taken) % 60])
 
 
+func end_output_archive(output_archive: String):
+	if output_archive == "":
+		return
+	print("Finishing " + output_archive + "...")
+	if GDRECommon.end_archive_output() != OK:
+		print("Error: failed to finish writing " + output_archive)
+
+
 func load_pck(input_files: PackedStringArray, extract_only: bool, includes, excludes, enc_key: String = ""):
 	var _new_files = []
 	for file in input_files:
@@ -22,9 +22,23 @@ var num_files:int = 0
 var num_broken:int = 0
 var num_malformed:int = 0
 var _file_dialog: FileDialog = null
+var EXTRACT_BUTTON: Button = null
+var STOP_LOADING_BUTTON: Button = null
+
+# Time spent adding loaded files to the tree each frame
+const LOAD_BUDGET_USEC = 8000
+var _loader: ProjectLoader = null
+var _loading_paths: PackedStringArray = []
+var _project_ready: bool = false
+var _files_sorted: bool = false
+# Set while confirm() waits for the MD5 check to stop
+var _confirm_pending: bool = false
 
 signal recovery_done()
 signal recovery_confirmed(files_to_extract: PackedStringArray, output_dir: String, extract_only: bool)
+signal project_load_failed(paths: PackedStringArray)
+# Emitted once the loader is gone, whether it finished or was stopped
+signal loading_finished()
 
 func _propagate_check(item: TreeItem, checked: bool):
 	item.set_checked(0, checked)
@@ -61,6 +75,8 @@ func _ready():
 	RESOURCE_PREVIEW = %GdreResourcePreview
 	HSPLIT_CONTAINER = %HSplitContainer
 	SHOW_PREVIEW_BUTTON = %ShowResourcePreview
+	EXTRACT_BUTTON = %ExtractButton
+	STOP_LOADING_BUTTON = %StopLoadingButton
 
 	if isHiDPI:
 		# get_viewport().size *= 2.0
@@ -79,27 +95,114 @@ func _ready():
 	DIRECTORY.text = DESKTOP_DIR
 	# load_test()
 
+# Starts loading the project in the background; the file tree fills in as the packs are read.
+# If the load fails later on, project_load_failed is emitted.
 func add_project(paths: PackedStringArray) -> int:
+	stop_loading()
 	if GDRESettings.is_pack_loaded():
 		GDRESettings.unload_project()
 	clear()
-	var err = GDRESettings.load_project(paths)
+	_loader = ProjectLoader.new()
+	var err = _loader.start(paths)
 	if (err != OK):
+		_loader = null
 		return err
-	var pckdump = PckDumper.new()
-	var skipped = false
-	err = pckdump.check_md5_all_files()
-	if ERR_SKIP == err:
-		skipped = true
-		err = OK
-	VERSION_TEXT.text = GDRESettings.get_version_string()
-	var arr: Array = GDRESettings.get_file_info_array()
-	FILE_TREE.add_files_from_packed_infos(arr, skipped)
+	_loading_paths = paths
+	_project_ready = false
+	_files_sorted = false
+	FILE_TREE.collapse_new_folders = true
+	VERSION_TEXT.text = "Loading..."
+	_set_loading(true)
+	_update_info_text()
+	DIRECTORY.text = DESKTOP_DIR.path_join(paths[0].get_file().get_basename())
+	return OK
+
+func _set_loading(loading: bool):
+	EXTRACT_BUTTON.disabled = loading and not _project_ready
+	STOP_LOADING_BUTTON.visible = loading
+	STOP_LOADING_BUTTON.disabled = false
+	STOP_LOADING_BUTTON.text = "Skip MD5 Check" if _project_ready else "Stop Loading"
+
+func _update_info_text():
 	INFO_TEXT.text = "Total files: " + String.num_int64(FILE_TREE.num_files)# +
 	if FILE_TREE.num_broken > 0 or FILE_TREE.num_malformed > 0:
 		INFO_TEXT.text += "   Broken files: " + String.num_int64(FILE_TREE.num_broken) + "    Malformed paths: " + String.num_int64(FILE_TREE.num_malformed)
-	DIRECTORY.text = DESKTOP_DIR.path_join(paths[0].get_file().get_basename())
-	return OK
+	if _loader == null:
+		return
+	match _loader.get_status():
+		ProjectLoader.STATUS_LOADING_FILES:
+			INFO_TEXT.text += "\nReading packs..."
+		ProjectLoader.STATUS_LOADING_PROJECT:
+			INFO_TEXT.text += "\nLoading project..."
+		ProjectLoader.STATUS_CHECKING_MD5:
+			INFO_TEXT.text += "\nVerifying MD5: %d/%d" % [_loader.get_md5_checked_count(), _loader.get_md5_total()]
+
+func _process(_delta: float):
+	if _loader == null:
+		return
+	# read before draining, so an empty queue below means every batch from before this status has been added
+	var status = _loader.get_status()
+	var deadline = Time.get_ticks_usec() + LOAD_BUDGET_USEC
+	var drained = false
+	while Time.get_ticks_usec() < deadline:
+		var batch: Dictionary = _loader.pop_batch()
+		if batch.is_empty():
+			drained = true
+			break
+		FILE_TREE.add_loader_batch(batch)
+		if not batch.get("md5_checked", false):
+			_files_sorted = false
+	if drained and status > ProjectLoader.STATUS_LOADING_FILES and not _files_sorted:
+		FILE_TREE.sort_entire_tree()
+		_files_sorted = true
+	if not _project_ready and status >= ProjectLoader.STATUS_CHECKING_MD5 and status != ProjectLoader.STATUS_CANCELED and status != ProjectLoader.STATUS_FAILED:
+		# load_project is done with GDRESettings; it's safe to read it and preview resources from here on
+		_project_ready = true
+		VERSION_TEXT.text = GDRESettings.get_version_string()
+		_set_loading(true)
+		_on_file_tree_item_selected()
+	_update_info_text()
+	if drained and _loader.is_finished():
+		_finish_loading()
+
+func _finish_loading():
+	var status = _loader.get_status()
+	_loader.wait()
+	var md5_skipped = not _loader.is_md5_check_complete() and _loader.get_md5_total() > 0
+	_loader = null
+	FILE_TREE.collapse_new_folders = false
+	_set_loading(false)
+	_update_info_text()
+	if status != ProjectLoader.STATUS_DONE:
+		_confirm_pending = false
+	if status == ProjectLoader.STATUS_FAILED:
+		hide_win()
+		project_load_failed.emit(_loading_paths)
+	elif status == ProjectLoader.STATUS_CANCELED:
+		close()
+	elif md5_skipped:
+		INFO_TEXT.text += "\nMD5 check skipped"
+	loading_finished.emit()
+
+# Stops a load that is still running. Blocks until the loader is at its next phase; that is usually quick, but the
+# phases themselves (e.g. reading the import files) aren't interrupted.
+func stop_loading():
+	if _loader == null:
+		return
+	_loader.cancel()
+	_loader.wait()
+	_loader = null
+	_confirm_pending = false
+	FILE_TREE.collapse_new_folders = false
+	_set_loading(false)
+	loading_finished.emit()
+
+func _on_stop_loading_button_pressed() -> void:
+	if _loader == null:
+		return
+	# before the project is loaded this unloads it, which _finish_loading handles by closing the window
+	_loader.cancel()
+	STOP_LOADING_BUTTON.disabled = true
 
 func load_test():
 	#const path = "/Users/nikita/Workspace/godot-ws/godot-test-bins/satryn.apk"
@@ -144,6 +247,7 @@ func _on_uncheck_all_pressed() -> void:
 
 
 func close():
+	stop_loading()
 	if GDRESettings.is_pack_loaded():
 		GDRESettings.unload_project()
 	RESOURCE_PREVIEW.reset()
@@ -159,6 +263,19 @@ func _go():
 
 
 func confirm():
+	if _loader != null:
+		if not _project_ready:
+			return
+		# the project is loaded; don't wait for the rest of the MD5 check, but let _process add the files it has checked
+		_loader.cancel()
+		_confirm_pending = true
+		EXTRACT_BUTTON.disabled = true
+		STOP_LOADING_BUTTON.disabled = true
+		await loading_finished
+		# stop_loading() or close() got there first
+		if not _confirm_pending:
+			return
+		_confirm_pending = false
 	RESOURCE_PREVIEW.reset()
 	if (not EXTRACT_ONLY.is_pressed() and GDREConfig.get_setting("ask_for_download", true)):
 		for file in FILE_TREE.get_checked_files():
@@ -178,6 +295,9 @@ func _on_directory_button_pressed() -> void:
 func _on_file_tree_item_selected() -> void:
 	if not RESOURCE_PREVIEW.is_visible_in_tree():
 		return
+	# the loader thread is still changing GDRESettings until the project is ready
+	if _loader != null and not _project_ready:
+		return
 	var item = FILE_TREE.get_selected()
 	if item:
 		var path = item.get_metadata(0)
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "core/io/compression.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "modules/zip/zip_reader.h"
+#include "tests/test_common.h"
+#include "tests/test_macros.h"
+#include "utility/file_access_archive.h"
+
+namespace TestArchiveWriter {
+
+struct ArchiveTestWriter {
+	String archive_path;
+	Vector<String> names;
+	HashMap<String, Vector<uint8_t>> contents;
+
+	void write_file(uint32_t i, void *p_userdata) {
+		String path = archive_path.path_join(names[i]);
+		gdre::ensure_dir(path.get_base_dir());
+		Ref<FileAccess> fa = FileAccess::open(path, FileAccess::WRITE);
+		if (fa.is_valid()) {
+			fa->store_buffer(contents.get(names[i]));
+		}
+	}
+};
+
+// Writes files into p_archive_path through FileAccess/DirAccess from worker threads, then renames, removes and
+// overwrites some of them. Returns what the archive should contain once it's closed.
+HashMap<String, Vector<uint8_t>> write_test_archive(const String &p_archive_path) {
+	if (FileAccess::exists(p_archive_path)) {
+		DirAccess::remove_absolute(p_archive_path);
+	}
+	ArchiveTestWriter writer;
+	writer.archive_path = p_archive_path;
+	for (int i = 0; i < 200; i++) {
+		String rel = vformat("dir%d/file%d.txt", i % 7, i);
+		if (i % 50 == 0) {
+			rel = ".godot/imported/" + rel;
+		}
+		if (i == 3) {
+			// longer than the 100 byte ustar name field
+			rel = String("long_").repeat(30) + "name.txt";
+		}
+		Vector<uint8_t> data;
+		// mix of compressible and incompressible data
+		for (int j = 0; j < i * 37; j++) {
+			data.push_back(i % 2 == 0 ? (uint8_t)(j % 13) : (uint8_t)((j * 2654435761u) >> 13));
+		}
+		writer.names.push_back(rel);
+		writer.contents[rel] = data;
+	}
+
+	REQUIRE(ArchiveOutput::begin(p_archive_path) == OK);
+	WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(&writer, &ArchiveTestWriter::write_file, (void *)nullptr, writer.names.size(), -1, true, SNAME("TestArchiveWriter::write_test_archive"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+
+	HashMap<String, Vector<uint8_t>> expected = writer.contents;
+	// reads come back out of the archive, whether or not the appender got to them yet
+	for (const KeyValue<String, Vector<uint8_t>> &E : expected) {
+		CHECK(FileAccess::get_file_as_bytes(p_archive_path.path_join(E.key)) == E.value);
+	}
+	CHECK(DirAccess::dir_exists_absolute(p_archive_path.path_join("dir3")));
+	CHECK(!FileAccess::exists(p_archive_path.path_join("missing.txt")));
+
+	Ref<DirAccess> da = DirAccess::open(p_archive_path);
+	REQUIRE(da.is_valid());
+	String renamed_from = writer.names[10];
+	String renamed_to = "renamed/" + renamed_from.get_file();
+	CHECK(da->make_dir("renamed") == OK);
+	CHECK(da->rename(renamed_from, renamed_to) == OK);
+	expected[renamed_to] = expected[renamed_from];
+	expected.erase(renamed_from);
+	CHECK(!FileAccess::exists(p_archive_path.path_join(renamed_from)));
+	CHECK(FileAccess::get_file_as_bytes(p_archive_path.path_join(renamed_to)) == expected[renamed_to]);
+
+	String removed = writer.names[11];
+	CHECK(da->remove(removed) == OK);
+	expected.erase(removed);
+	CHECK(!FileAccess::exists(p_archive_path.path_join(removed)));
+
+	String overwritten = writer.names[12];
+	Ref<FileAccess> fa = FileAccess::open(p_archive_path.path_join(overwritten), FileAccess::WRITE);
+	REQUIRE(fa.is_valid());
+	fa->store_string("overwritten");
+	fa->close();
+	expected[overwritten] = String("overwritten").to_utf8_buffer();
+	CHECK(FileAccess::get_file_as_bytes(p_archive_path.path_join(overwritten)) == expected[overwritten]);
+
+	REQUIRE(ArchiveOutput::end() == OK);
+	CHECK(FileAccess::exists(p_archive_path));
+	CHECK(!DirAccess::dir_exists_absolute(p_archive_path));
+	return expected;
+}
+
+uint64_t tar_padded(uint64_t p_size) {
+	return (p_size + 511) / 512 * 512;
+}
+
+HashMap<String, Vector<uint8_t>> read_tar(const Vector<uint8_t> &p_tar) {
+	HashMap<String, Vector<uint8_t>> files;
+	int64_t pos = 0;
+	String long_name;
+	while (pos + 512 <= p_tar.size() && p_tar[pos] != 0) {
+		const char *header = (const char *)p_tar.ptr() + pos;
+		uint64_t size = 0;
+		for (int i = 124; i < 135; i++) {
+			size = size * 8 + (header[i] - '0');
+		}
+		const uint8_t *data = p_tar.ptr() + pos + 512;
+		if (header[156] == 'L') {
+			long_name = String::utf8((const char *)data, size - 1);
+		} else {
+			String name = long_name.is_empty() ? String::utf8(header, strnlen(header, 100)) : long_name;
+			long_name = "";
+			Vector<uint8_t> contents;
+			contents.resize(size);
+			memcpy(contents.ptrw(), data, size);
+			CHECK_MESSAGE(!files.has(name), name.utf8().get_data());
+			files[name] = contents;
+		}
+		pos += 512 + tar_padded(size);
+	}
+	// the archive ends right after the two zero blocks
+	CHECK(p_tar.size() - pos == 1024);
+	return files;
+}
+
+// Decompresses every frame of a .tar.zst and skips skippable frames, like the zstd CLI does.
+Vector<uint8_t> decompress_zstd_frames(const Vector<uint8_t> &p_data) {
+	Vector<uint8_t> out;
+	int64_t pos = 0;
+	while (pos < p_data.size()) {
+		uint32_t magic = decode_uint32(p_data.ptr() + pos);
+		if ((magic & 0xFFFFFFF0) == 0x184D2A50) {
+			pos += 8 + decode_uint32(p_data.ptr() + pos + 4);
+			continue;
+		}
+		REQUIRE(magic == 0xFD2FB528);
+		int64_t start = pos;
+		uint8_t descriptor = p_data[pos + 4];
+		pos += 5;
+		bool single_segment = descriptor & 0x20;
+		const int dict_id_sizes[] = { 0, 1, 2, 4 };
+		const int content_size_sizes[] = { single_segment ? 1 : 0, 2, 4, 8 };
+		int content_size_size = content_size_sizes[descriptor >> 6];
+		// every frame records its content size
+		REQUIRE(content_size_size > 0);
+		pos += (single_segment ? 0 : 1) + dict_id_sizes[descriptor & 3];
+		uint64_t content_size = 0;
+		for (int i = 0; i < content_size_size; i++) {
+			content_size |= (uint64_t)p_data[pos + i] << (8 * i);
+		}
+		if (content_size_size == 2) {
+			content_size += 256;
+		}
+		pos += content_size_size;
+		bool last_block = false;
+		while (!last_block) {
+			uint32_t block_header = p_data[pos] | (p_data[pos + 1] << 8) | (p_data[pos + 2] << 16);
+			last_block = block_header & 1;
+			bool rle = ((block_header >> 1) & 3) == 1;
+			pos += 3 + (rle ? 1 : (block_header >> 3));
+		}
+		if (descriptor & 0x04) {
+			pos += 4; // checksum
+		}
+		int64_t out_pos = out.size();
+		out.resize(out_pos + content_size);
+		REQUIRE(Compression::decompress(out.ptrw() + out_pos, content_size, p_data.ptr() + start, pos - start, Compression::MODE_ZSTD) == (int64_t)content_size);
+	}
+	return out;
+}
+
+TEST_CASE("[GDSDecomp][ArchiveWriter] Files written under a .zip output path end up in the archive") {
+	String zip_path = get_tmp_path().path_join("archive_writer_test.zip");
+	HashMap<String, Vector<uint8_t>> expected = write_test_archive(zip_path);
+
+	Ref<ZIPReader> zip;
+	zip.instantiate();
+	REQUIRE(zip->open(zip_path) == OK);
+	PackedStringArray files = zip->get_files();
+	CHECK(files.size() == expected.size());
+	for (const KeyValue<String, Vector<uint8_t>> &E : expected) {
+		CHECK_MESSAGE(files.has(E.key), E.key.utf8().get_data());
+		CHECK(zip->read_file(E.key, true) == E.value);
+	}
+	zip->close();
+	DirAccess::remove_absolute(zip_path);
+}
+
+TEST_CASE("[GDSDecomp][ArchiveWriter] Removed tar entries are compacted away") {
+	String tar_path = get_tmp_path().path_join("archive_writer_test.tar");
+	HashMap<String, Vector<uint8_t>> expected = write_test_archive(tar_path);
+
+	HashMap<String, Vector<uint8_t>> files = read_tar(FileAccess::get_file_as_bytes(tar_path));
+	CHECK(files.size() == expected.size());
+	for (const KeyValue<String, Vector<uint8_t>> &E : expected) {
+		REQUIRE_MESSAGE(files.has(E.key), E.key.utf8().get_data());
+		CHECK(files[E.key] == E.value);
+	}
+	DirAccess::remove_absolute(tar_path);
+}
+
+TEST_CASE("[GDSDecomp][ArchiveWriter] .tar.zst output decompresses to a tar without removed entries") {
+	String tzst_path = get_tmp_path().path_join("archive_writer_test.tar.zst");
+	HashMap<String, Vector<uint8_t>> expected = write_test_archive(tzst_path);
+
+	HashMap<String, Vector<uint8_t>> files = read_tar(decompress_zstd_frames(FileAccess::get_file_as_bytes(tzst_path)));
+	CHECK(files.size() == expected.size());
+	for (const KeyValue<String, Vector<uint8_t>> &E : expected) {
+		REQUIRE_MESSAGE(files.has(E.key), E.key.utf8().get_data());
+		CHECK(files[E.key] == E.value);
+	}
+	DirAccess::remove_absolute(tzst_path);
+}
+
+} // namespace TestArchiveWriter
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "tests/test_macros.h"
+#include "utility/export_report_model.h"
+
+namespace TestExportReportModel {
+
+TEST_CASE("[GDSDecomp][ExportReportModel] Counts, filters and sorts rows per section") {
+	Ref<ExportReportModel> model;
+	model.instantiate();
+	for (int i = 0; i < 1000; i++) {
+		String importer = i % 4 == 0 ? "texture" : "scene";
+		model->add_entry("success", vformat("res://.godot/imported/file_%d.ctex", i), vformat("res://assets/File_%d.png", i), importer);
+	}
+	model->add_entry("failed", "res://broken.scn", "res://broken.glb", "scene");
+
+	CHECK(model->get_sections() == PackedStringArray({ "success", "failed" }));
+	CHECK(model->get_section_size("success") == 1000);
+	Dictionary counts = model->get_importer_counts("success");
+	CHECK(int(counts["texture"]) == 250);
+	CHECK(int(counts["scene"]) == 750);
+
+	// unsorted views keep insertion order
+	Array rows = model->get_rows("success", 0, 2);
+	REQUIRE(rows.size() == 2);
+	CHECK(PackedStringArray(rows[1])[0] == "res://assets/File_1.png");
+
+	model->set_filter("success", "FILE_99");
+	CHECK(model->get_view_size("success") == 11); // 99 and 990-999
+	model->set_filter("success", "file_99", "texture");
+	CHECK(model->get_view_size("success") == 2); // 992 and 996
+	model->set_filter("success", "");
+	CHECK(model->get_view_size("success") == 1000);
+
+	// natural order, so File_10 comes after File_9
+	model->sort("success", ExportReportModel::COLUMN_TARGET, true);
+	rows = model->get_rows("success", 9, 2);
+	CHECK(PackedStringArray(rows[0])[0] == "res://assets/File_9.png");
+	CHECK(PackedStringArray(rows[1])[0] == "res://assets/File_10.png");
+	model->sort("success", ExportReportModel::COLUMN_TARGET, false);
+	CHECK(PackedStringArray(model->get_rows("success", 0, 1)[0])[0] == "res://assets/File_999.png");
+
+	// the sort survives a filter change
+	model->set_filter("success", "file_1");
+	CHECK(PackedStringArray(model->get_rows("success", 0, 1)[0])[0] == "res://assets/File_199.png");
+	CHECK(model->get_rows("success", 0, 10000).size() == model->get_view_size("success"));
+}
+
+} // namespace TestExportReportModel
@@ -8,6 +8,7 @@
 
 #include <core/io/pck_packer.h>
 #include <core/io/resource_format_binary.h>
+#include <core/io/resource_saver.h>
 #include <modules/gdscript/gdscript_tokenizer_buffer.h>
 #include <scene/resources/resource_format_text.h>
 
@@ -15,6 +16,7 @@
 #include <utility/file_access_gdre.h>
 #include <utility/import_exporter.h>
 #include <utility/pck_dumper.h>
+#include <utility/project_loader.h>
 
 inline Error create_test_pck(const String &pck_path, const HashMap<String, String> &paths) {
 	PCKPacker pck;
@@ -173,6 +175,282 @@ TEST_CASE("[GDSDecomp] FileAccessGDRE tests") {
 	gdre::rimraf(tmp_pck_path);
 }
 
+TEST_CASE("[GDSDecomp] GDREPackedData file table") {
+	CHECK(gdre::ensure_dir(get_tmp_path()) == OK);
+	auto tmp_pck_path = get_tmp_path().path_join("FileTableTest.pck");
+	HashMap<String, String> files;
+	for (int i = 0; i < 3; i++) {
+		auto tmp_file = get_tmp_path().path_join(vformat("file_table_%d.txt", i));
+		CHECK(store_file_as_string(tmp_file, String("content ").repeat(i + 1)) == OK);
+		files[vformat("res://dir%d/file_table_%d.txt", i, i)] = tmp_file;
+	}
+	CHECK(create_test_pck(tmp_pck_path, files) == OK);
+
+	auto settings = GDRESettings::get_singleton();
+	CHECK(settings->load_project({ tmp_pck_path }, false) == OK);
+
+	Vector<String> listed = settings->get_file_list();
+	CHECK(listed.size() == files.size());
+	CHECK(settings->get_file_list({ "*_1.txt" }) == Vector<String>{ "res://dir1/file_table_1.txt" });
+	Vector<Ref<PackedFileInfo>> infos = settings->get_file_info_list();
+	CHECK(infos.size() == files.size());
+	for (const Ref<PackedFileInfo> &info : infos) {
+		REQUIRE(files.has(info->get_path()));
+		CHECK(listed.has(info->get_path()));
+		CHECK(info->get_raw_path() == info->get_path());
+		CHECK(!info->is_malformed());
+		CHECK(info->has_md5());
+		CHECK(info->get_size() == (uint64_t)FileAccess::get_file_as_bytes(files[info->get_path()]).size());
+		CHECK(!info->is_checksum_validated());
+	}
+	test_pck_files(files);
+
+	// the list is cached until the table changes
+	Vector<Ref<PackedFileInfo>> infos_again = settings->get_file_info_list();
+	REQUIRE(infos_again.size() == infos.size());
+	for (int i = 0; i < infos.size(); i++) {
+		CHECK(infos_again[i] == infos[i]);
+	}
+
+	// verification results are kept in the table, keyed by record, and reach every info made from it
+	Ref<PckDumper> dumper;
+	dumper.instantiate();
+	CHECK(dumper->check_md5_all_files() == OK);
+	for (const Ref<PackedFileInfo> &info : settings->get_file_info_list()) {
+		CHECK(info->is_checksum_validated());
+	}
+
+	CHECK(settings->unload_project() == OK);
+	CHECK(settings->get_file_info_list().is_empty());
+	for (const auto &file : files) {
+		gdre::rimraf(file.value);
+	}
+	gdre::rimraf(tmp_pck_path);
+}
+
+TEST_CASE("[GDSDecomp] GDREPackedData merges concurrently read packs in load order") {
+	CHECK(gdre::ensure_dir(get_tmp_path()) == OK);
+	// every pack overrides some files from the packs before it and adds some of its own
+	const int pack_count = 6;
+	Vector<String> pck_paths;
+	Vector<String> tmp_files;
+	for (int p = 0; p < pack_count; p++) {
+		HashMap<String, String> files;
+		for (int i = 0; i < 40; i++) {
+			if (i % pack_count < p) {
+				continue;
+			}
+			auto tmp_file = get_tmp_path().path_join(vformat("multi_pack_%d_%d.txt", p, i));
+			CHECK(store_file_as_string(tmp_file, vformat("pack %d file %d ", p, i).repeat(p + 1)) == OK);
+			tmp_files.push_back(tmp_file);
+			files[vformat("res://shared/file_%d.txt", i)] = tmp_file;
+		}
+		auto own_file = get_tmp_path().path_join(vformat("multi_pack_own_%d.txt", p));
+		CHECK(store_file_as_string(own_file, vformat("only in pack %d", p)) == OK);
+		tmp_files.push_back(own_file);
+		files[vformat("res://pack_%d/own.txt", p)] = own_file;
+		auto pck_path = get_tmp_path().path_join(vformat("MultiPackTest_%d.pck", p));
+		CHECK(create_test_pck(pck_path, files) == OK);
+		pck_paths.push_back(pck_path);
+	}
+
+	auto table_snapshot = []() {
+		HashMap<String, String> snapshot;
+		for (const Ref<PackedFileInfo> &info : GDRESettings::get_singleton()->get_file_info_list()) {
+			snapshot[info->get_path()] = vformat("%s %d %d %s", info->get_pack(), (int64_t)info->get_offset(), (int64_t)info->get_size(), info->get_md5());
+		}
+		return snapshot;
+	};
+
+	auto settings = GDRESettings::get_singleton();
+	// one pack at a time through add_pack
+	REQUIRE(settings->load_project({ pck_paths[0] }, false) == OK);
+	for (int p = 1; p < pack_count; p++) {
+		CHECK(settings->load_pck(pck_paths[p]) == OK);
+	}
+	HashMap<String, String> serial = table_snapshot();
+	Vector<String> serial_list = settings->get_file_list();
+	CHECK(settings->unload_project() == OK);
+
+	REQUIRE(settings->load_project(pck_paths, false) == OK);
+	HashMap<String, String> merged = table_snapshot();
+	CHECK(settings->get_file_list() == serial_list);
+	CHECK(settings->get_pack_path() == pck_paths[0]);
+	CHECK(merged.size() == serial.size());
+	for (const auto &E : serial) {
+		REQUIRE(merged.has(E.key));
+		CHECK_MESSAGE(merged[E.key] == E.value, E.key.utf8().get_data());
+	}
+	// the last pack that has a file wins
+	CHECK(FileAccess::get_file_as_string("res://shared/file_0.txt").begins_with("pack 0 file 0"));
+	CHECK(FileAccess::get_file_as_string("res://shared/file_5.txt").begins_with(vformat("pack %d file 5", pack_count - 1)));
+	CHECK(FileAccess::get_file_as_string("res://pack_3/own.txt") == "only in pack 3");
+	CHECK(settings->unload_project() == OK);
+
+	for (const String &file : tmp_files) {
+		gdre::rimraf(file);
+	}
+	for (const String &pck_path : pck_paths) {
+		gdre::rimraf(pck_path);
+	}
+}
+
+TEST_CASE("[GDSDecomp] GDREPackedData serves project folder queries from the table") {
+	auto dir = get_tmp_path().path_join("DirSourceTest");
+	gdre::rimraf(dir);
+	HashMap<String, String> files;
+	for (int i = 0; i < 3; i++) {
+		auto rel = vformat("sub%d/file_%d.txt", i % 2, i);
+		CHECK(store_file_as_string(dir.path_join(rel), String("dir source ").repeat(i + 1)) == OK);
+		files["res://" + rel] = dir.path_join(rel);
+	}
+
+	auto settings = GDRESettings::get_singleton();
+	REQUIRE(settings->load_project({ dir }, false) == OK);
+	CHECK(settings->get_file_list().size() == files.size());
+	for (const auto &E : files) {
+		CHECK(FileAccess::exists(E.key));
+		CHECK(FileAccess::get_size(E.key) == FileAccess::get_file_as_bytes(E.value).size());
+	}
+	// sizes aren't read during the snapshot; infos stat them on first use
+	for (const auto &info : GDREPackedData::get_singleton()->get_file_info_list()) {
+		REQUIRE(files.has(info->get_path()));
+		CHECK(info->get_size() == (uint64_t)FileAccess::get_file_as_bytes(files[info->get_path()]).size());
+	}
+	CHECK(DirAccess::exists("res://sub1"));
+	CHECK(!FileAccess::exists("res://sub1/missing.txt"));
+	CHECK(settings->unload_project() == OK);
+	gdre::rimraf(dir);
+}
+
+TEST_CASE("[GDSDecomp] GDRESettings takes the newest resource version from a mixed-version folder") {
+	// Enough resources that only a sample of the headers is read first; all but one claim the previous minor
+	// version, so a sample that misses the newer one must not decide the version on its own.
+	REQUIRE(GODOT_VERSION_MINOR > 0);
+	constexpr int RESOURCE_COUNT = 200;
+	auto dir = get_tmp_path().path_join("MixedVersionTest");
+	gdre::rimraf(dir);
+	REQUIRE(gdre::ensure_dir(dir) == OK);
+	Ref<Resource> res;
+	res.instantiate();
+	for (int i = 0; i < RESOURCE_COUNT; i++) {
+		String path = dir.path_join(vformat("res_%d.res", i));
+		REQUIRE(ResourceSaver::save(res, path) == OK);
+		if (i == RESOURCE_COUNT / 2) {
+			continue;
+		}
+		// RSRC, big endian flag, real64 flag, major, minor
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ_WRITE);
+		REQUIRE(f.is_valid());
+		f->seek(16);
+		f->store_32(GODOT_VERSION_MINOR - 1);
+	}
+
+	auto settings = GDRESettings::get_singleton();
+	REQUIRE(settings->load_project({ dir }, false) == OK);
+	CHECK(settings->get_ver_major() == GODOT_VERSION_MAJOR);
+	CHECK(settings->get_ver_minor() == GODOT_VERSION_MINOR);
+	CHECK(settings->unload_project() == OK);
+	gdre::rimraf(dir);
+}
+
+TEST_CASE("[GDSDecomp] GDRESettings lets a consistent sample decide an older resource version") {
+	// every header claims the previous minor version; the sample agrees and nothing newer is found by the header pass
+	REQUIRE(GODOT_VERSION_MINOR > 0);
+	constexpr int RESOURCE_COUNT = 200;
+	auto dir = get_tmp_path().path_join("OlderVersionTest");
+	gdre::rimraf(dir);
+	REQUIRE(gdre::ensure_dir(dir) == OK);
+	Ref<Resource> res;
+	res.instantiate();
+	for (int i = 0; i < RESOURCE_COUNT; i++) {
+		String path = dir.path_join(vformat("res_%d.res", i));
+		REQUIRE(ResourceSaver::save(res, path) == OK);
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ_WRITE);
+		REQUIRE(f.is_valid());
+		f->seek(16);
+		f->store_32(GODOT_VERSION_MINOR - 1);
+	}
+
+	auto settings = GDRESettings::get_singleton();
+	REQUIRE(settings->load_project({ dir }, false) == OK);
+	CHECK(settings->get_ver_major() == GODOT_VERSION_MAJOR);
+	CHECK(settings->get_ver_minor() == GODOT_VERSION_MINOR - 1);
+	CHECK(settings->unload_project() == OK);
+	gdre::rimraf(dir);
+}
+
+TEST_CASE("[GDSDecomp][ProjectLoader] Streams the file table and MD5 results while loading") {
+	CHECK(gdre::ensure_dir(get_tmp_path()) == OK);
+	auto tmp_project_path = get_tmp_path().path_join("project.binary");
+	ProjectSettings::get_singleton()->save_custom(tmp_project_path);
+	HashMap<String, String> files = { { "res://project.binary", tmp_project_path } };
+	Vector<String> tmp_files;
+	for (int i = 0; i < 600; i++) {
+		auto tmp_file = get_tmp_path().path_join(vformat("loader_file_%d.txt", i));
+		CHECK(store_file_as_string(tmp_file, vformat("loader file %d", i)) == OK);
+		tmp_files.push_back(tmp_file);
+		files[vformat("res://dir_%d/file_%d.txt", i % 7, i)] = tmp_file;
+	}
+	auto pck_path = get_tmp_path().path_join("ProjectLoaderTest.pck");
+	CHECK(create_test_pck(pck_path, files) == OK);
+
+	Ref<ProjectLoader> loader;
+	loader.instantiate();
+	REQUIRE(loader->start({ pck_path }) == OK);
+	HashSet<String> listed;
+	HashSet<String> checked;
+	// the same loop the GUI runs every frame, just without the frame budget
+	while (!loader->is_finished() || loader->has_pending_batches()) {
+		Dictionary batch = loader->pop_batch();
+		if (batch.is_empty()) {
+			OS::get_singleton()->delay_usec(1000);
+			continue;
+		}
+		Array batch_files = batch["files"];
+		for (int i = 0; i < batch_files.size(); i++) {
+			Ref<PackedFileInfo> info = batch_files[i];
+			if (bool(batch["md5_checked"])) {
+				CHECK(listed.has(info->get_path()));
+				CHECK(info->is_checksum_validated());
+				checked.insert(info->get_path());
+			} else {
+				listed.insert(info->get_path());
+			}
+		}
+	}
+	REQUIRE(loader->wait() == OK);
+	CHECK(loader->get_status() == ProjectLoader::STATUS_DONE);
+	CHECK(loader->is_md5_check_complete());
+	CHECK(loader->get_md5_broken_count() == 0);
+	auto settings = GDRESettings::get_singleton();
+	CHECK(settings->is_project_config_loaded());
+	CHECK(listed.size() == files.size());
+	CHECK(checked.size() == loader->get_md5_total());
+	for (const String &path : settings->get_file_list()) {
+		CHECK(listed.has(path));
+	}
+
+	// canceling right away unloads whatever got loaded
+	REQUIRE(loader->start({ pck_path }) == OK);
+	loader->cancel();
+	Error err = loader->wait();
+	if (loader->get_status() == ProjectLoader::STATUS_CANCELED) {
+		CHECK(err == ERR_SKIP);
+		CHECK(!settings->is_pack_loaded());
+	} else {
+		// the load got past the last check before the cancel; only the MD5 check was stopped
+		CHECK(loader->get_status() == ProjectLoader::STATUS_DONE);
+		CHECK(settings->unload_project() == OK);
+	}
+
+	for (const String &file : tmp_files) {
+		gdre::rimraf(file);
+	}
+	gdre::rimraf(tmp_project_path);
+	gdre::rimraf(pck_path);
+}
+
 // Disabling this for now; fragile and kind of redundant.
 #if 0
 static constexpr const char *const export_presets =
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/io/file_access.h"
+#include "tests/test_common.h"
+#include "tests/test_macros.h"
+#include "utility/gdre_config.h"
+#include "utility/output_dedup.h"
+
+namespace TestOutputDedup {
+
+TEST_CASE("[GDSDecomp][OutputDedup] Identical outputs are linked, different ones are written") {
+	bool was_enabled = GDREConfig::get_singleton()->get_setting("Exporter/deduplicate_output_files", false);
+	GDREConfig::get_singleton()->set_setting("Exporter/deduplicate_output_files", true);
+	gdre::OutputDeduplicator::reset();
+
+	String dir = get_tmp_path().path_join("output_dedup_test");
+	gdre::rimraf(dir);
+	Vector<uint8_t> data;
+	for (int i = 0; i < 10000; i++) {
+		data.push_back(i % 251);
+	}
+	Vector<uint8_t> other = data;
+	other.write[0] = 7;
+
+	CHECK(gdre::OutputDeduplicator::write_file(dir.path_join("a/first.bin"), data.ptr(), data.size()) == OK);
+	CHECK(gdre::OutputDeduplicator::write_file(dir.path_join("b/second.bin"), data.ptr(), data.size()) == OK);
+	CHECK(gdre::OutputDeduplicator::write_file(dir.path_join("c/other.bin"), other.ptr(), other.size()) == OK);
+
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("a/first.bin")) == data);
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("b/second.bin")) == data);
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("c/other.bin")) == other);
+	CHECK(!FileAccess::exists(dir.path_join("b/second.bin.dedup_tmp")));
+	// hardlinks are available on every filesystem the tests run on
+	CHECK(gdre::OutputDeduplicator::get_files_deduplicated() == 1);
+	CHECK(gdre::OutputDeduplicator::get_bytes_saved() == (uint64_t)data.size());
+
+	// rewriting a linked output must not change the copy it is linked to
+	gdre::OutputDeduplicator::reset();
+	CHECK(gdre::OutputDeduplicator::write_file(dir.path_join("b/second.bin"), other.ptr(), other.size()) == OK);
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("b/second.bin")) == other);
+	CHECK(FileAccess::get_file_as_bytes(dir.path_join("a/first.bin")) == data);
+
+	gdre::rimraf(dir);
+	gdre::OutputDeduplicator::reset();
+	GDREConfig::get_singleton()->set_setting("Exporter/deduplicate_output_files", was_enabled);
+}
+
+} // namespace TestOutputDedup
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/object/worker_thread_pool.h"
+#include "tests/test_common.h"
+#include "tests/test_macros.h"
+#include "utility/import_exporter.h"
+#include "utility/report_log.h"
+
+namespace TestReportLog {
+
+struct ReportLogAppendTask {
+	gdre::ReportLogWriter *writer;
+	Vector<Vector<String>> categories;
+
+	void append(uint32_t i, Vector<Ref<ExportReport>> *p_reports) {
+		writer->append((*p_reports)[i], categories[i]);
+	}
+};
+
+TEST_CASE("[GDSDecomp][ReportLog] Records appended from worker threads are indexed and totalled") {
+	String path = get_tmp_path().path_join("report_log_test").path_join("export_report.jsonl");
+	Vector<Ref<ExportReport>> reports;
+	const int count = 5000;
+	for (int i = 0; i < count; i++) {
+		Ref<ExportReport> report;
+		report.instantiate();
+		report->set_source_path(vformat("res://dir/file_%d.png", i));
+		report->set_message(i % 3 == 0 ? String("line one\nline \"two\" ü") : String());
+		if (i % 10 == 0) {
+			report->set_error(ERR_FILE_CORRUPT);
+		} else if (i % 7 == 0) {
+			report->set_error(ERR_SKIP);
+		} else if (i % 5 == 0) {
+			report->set_loss_type(ImportInfo::STORED_LOSSY);
+		}
+		if (i % 4 == 0) {
+			report->set_rewrote_metadata(ExportReport::REWRITTEN);
+		}
+		reports.push_back(report);
+	}
+
+	// sort the results into sections the way export_imports does, including GDExtension copies that fail
+	// after the export itself succeeded
+	Ref<ImportExporterReport> export_report;
+	export_report.instantiate();
+	gdre::ReportLogWriter writer;
+	REQUIRE(writer.open(path) == OK);
+	ReportLogAppendTask task{ &writer };
+	for (int i = 0; i < count; i++) {
+		String gdnative_copy_error = i % 11 == 0 ? vformat("res://addons/lib_%d.zip", i) : String();
+		task.categories.push_back(export_report->add_export_result(Ref<ImportInfo>(), reports[i], gdnative_copy_error, i % 22 == 0));
+	}
+	WorkerThreadPool::GroupID gid = WorkerThreadPool::get_singleton()->add_template_group_task(&task, &ReportLogAppendTask::append, &reports, count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(gid);
+	Dictionary writer_totals = writer.get_totals();
+	Dictionary export_totals = export_report->get_totals();
+	for (const Variant &key : export_totals.keys()) {
+		CHECK_MESSAGE(int64_t(writer_totals.get(key, 0)) == int64_t(export_totals[key]), String(key).utf8().get_data());
+	}
+	writer.close();
+
+	Ref<ReportLogReader> reader;
+	reader.instantiate();
+	REQUIRE(reader->open(path) == OK);
+	CHECK(reader->get_record_count() == count);
+
+	int failed = 0, not_converted = 0, lossy = 0;
+	HashSet<String> seen;
+	for (int i = 0; i < count; i++) {
+		Dictionary record = reader->get_record(i);
+		seen.insert(record["path"]);
+		PackedStringArray categories = record["categories"];
+		failed += categories.has("failed");
+		not_converted += categories.has("not_converted");
+		lossy += categories.has("lossy_imports");
+		if (String(record["path"]) == "res://dir/file_0.png") {
+			CHECK(String(record["message"]) == "line one\nline \"two\" ü");
+		}
+	}
+	CHECK(seen.size() == count);
+	Dictionary totals = reader->get_totals();
+	CHECK(totals.size() == writer_totals.size());
+	for (const Variant &key : writer_totals.keys()) {
+		CHECK(int64_t(totals.get(key, -1)) == int64_t(writer_totals[key]));
+	}
+	CHECK(int(totals["failed"]) == failed);
+	CHECK(int(totals.get("not_converted", 0)) == not_converted);
+	CHECK(int(totals.get("lossy_imports", 0)) == lossy);
+	CHECK(reader->get_records(count - 10, 100).size() == 10);
+
+	gdre::rimraf(path.get_base_dir());
+}
+
+} // namespace TestReportLog
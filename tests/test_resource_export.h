@@ -6,6 +6,8 @@
 #include <compat/resource_compat_text.h>
 #include <compat/resource_loader_compat.h>
 #include <modules/gdsdecomp/exporters/resource_exporter.h>
+#include <modules/gdsdecomp/utility/gdre_config.h>
+#include <modules/gdsdecomp/utility/png_encoder.h>
 #include <scene/resources/audio_stream_wav.h>
 namespace TestResourceExport {
 // oggvorbisstr
@@ -115,4 +117,148 @@ TEST_CASE("[GDSDecomp][ResourceExport] Export texture") {
 	}
 }
 
+TEST_CASE("[GDSDecomp][ResourceExport] Fast PNG encoder matches engine encoder") {
+	Vector<String> versions = get_test_versions();
+	CHECK(versions.size() > 0);
+
+	const int efforts[] = { 0, 1, 2, 6, 9 };
+	constexpr int effort_count = sizeof(efforts) / sizeof(efforts[0]);
+	uint64_t engine_size = 0;
+	uint64_t engine_usec = 0;
+	uint64_t fast_size[effort_count] = {};
+	uint64_t fast_usec[effort_count] = {};
+	for (const String &version : versions) {
+		String test_dir = get_test_resources_path().path_join(version).path_join("texture");
+		Vector<String> files = gdre::get_recursive_dir_list(test_dir, { "*.ctex" });
+		for (const String &file : files) {
+			Ref<Texture2D> texture = ResourceCompatLoader::non_global_load(file);
+			CHECK(texture.is_valid());
+			Ref<Image> image = texture->get_image();
+			CHECK(image.is_valid());
+			image = image->duplicate();
+			gdre::decompress_image(image);
+
+			uint64_t start = OS::get_singleton()->get_ticks_usec();
+			Vector<uint8_t> engine_png = gdre::PNGEncoder::encode_with_engine_saver(image);
+			engine_usec += OS::get_singleton()->get_ticks_usec() - start;
+			engine_size += engine_png.size();
+			CHECK(engine_png.size() > 0);
+			Ref<Image> engine_image;
+			engine_image.instantiate();
+			CHECK(engine_image->load_png_from_buffer(engine_png) == OK);
+
+			for (int i = 0; i < effort_count; i++) {
+				Error err;
+				start = OS::get_singleton()->get_ticks_usec();
+				Vector<uint8_t> png = gdre::PNGEncoder::encode(image, efforts[i], &err);
+				fast_usec[i] += OS::get_singleton()->get_ticks_usec() - start;
+				fast_size[i] += png.size();
+				CHECK(err == OK);
+				Ref<Image> decoded;
+				decoded.instantiate();
+				CHECK(decoded->load_png_from_buffer(png) == OK);
+				CHECK(decoded->get_format() == engine_image->get_format());
+				CHECK(decoded->get_data() == engine_image->get_data());
+			}
+		}
+	}
+
+	// size and speed against the engine's saver over all the test textures; run with --verbose to see the numbers
+	print_verbose(vformat("Engine PNG saver: %d bytes, %d us", engine_size, engine_usec));
+	for (int i = 0; i < effort_count; i++) {
+		print_verbose(vformat("Fast PNG encoder, effort %d: %d bytes (%.1f%% of engine), %d us", efforts[i], fast_size[i], engine_size ? 100.0 * fast_size[i] / engine_size : 0.0, fast_usec[i]));
+		if (efforts[i] >= 6) {
+			// the adaptive-filter efforts do what libpng does, so they shouldn't come out noticeably larger
+			CHECK(fast_size[i] <= engine_size + engine_size / 10);
+		}
+	}
+}
+
+TEST_CASE("[GDSDecomp][ResourceExport] Fast PNG encoder deflates large images in parallel bands") {
+	// 1200x1200 RGBA is over PARALLEL_DEFLATE_THRESHOLD once filtered
+	const int size = 1200;
+	Vector<uint8_t> data;
+	data.resize(size * size * 4);
+	uint8_t *w = data.ptrw();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			uint8_t *px = w + (y * size + x) * 4;
+			// gradients plus some noise, so every filter type gets picked somewhere
+			px[0] = x & 0xFF;
+			px[1] = y & 0xFF;
+			px[2] = ((x * 7) ^ (y * 13)) & 0xFF;
+			px[3] = (x / 64 + y / 64) % 2 ? 255 : 128;
+		}
+	}
+	Ref<Image> image = Image::create_from_data(size, size, false, Image::FORMAT_RGBA8, data);
+	REQUIRE(image.is_valid());
+	const bool can_run_multithreaded = !GDREConfig::get_singleton()->get_setting("force_single_threaded", false) && OS::get_singleton()->get_processor_count() > 1;
+
+	for (int effort : { 1, 2, 9 }) {
+		Error err;
+		gdre::PNGEncodeStats stats;
+		Vector<uint8_t> png = gdre::PNGEncoder::encode(image, effort, &err, &stats);
+		REQUIRE(err == OK);
+		if (can_run_multithreaded) {
+			CHECK(stats.bands > 1);
+		}
+		Ref<Image> decoded;
+		decoded.instantiate();
+		REQUIRE(decoded->load_png_from_buffer(png) == OK);
+		CHECK(decoded->get_format() == Image::FORMAT_RGBA8);
+		CHECK(decoded->get_width() == size);
+		CHECK(decoded->get_height() == size);
+		CHECK(decoded->get_data() == data);
+	}
+}
+
+TEST_CASE("[GDSDecomp][ResourceExport] Pixel run SVG merges runs into one element per color") {
+	const Color red(1, 0, 0, 1);
+	const Color blue(0, 0, 1, 128.0 / 255.0);
+	const Color green(0, 1, 0, 1);
+	const Color clear(0, 0, 0, 0);
+	const Color pixels[3][4] = {
+		{ red, red, blue, blue },
+		{ red, red, blue, blue },
+		{ green, clear, green, green },
+	};
+	Ref<Image> image = Image::create_empty(4, 3, false, Image::FORMAT_RGBA8);
+	for (int y = 0; y < 3; y++) {
+		for (int x = 0; x < 4; x++) {
+			image->set_pixel(x, y, pixels[y][x]);
+		}
+	}
+	String path = get_tmp_path().path_join("pixel_runs.svg");
+	REQUIRE(gdre::ensure_dir(path.get_base_dir()) == OK);
+	REQUIRE(gdre::save_image_as_svg_pixel_runs(path, image) == OK);
+	String svg = FileAccess::get_file_as_string(path);
+	// the red and blue runs extend down into squares, the two green runs share a path and the transparent pixel is dropped
+	CHECK(svg ==
+			"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" width=\"4\" height=\"3\" viewBox=\"0 0 4 3\" shape-rendering=\"crispEdges\">\n"
+			"<rect x=\"0\" y=\"0\" width=\"2\" height=\"2\" fill=\"#ff0000\"/>\n"
+			"<rect x=\"2\" y=\"0\" width=\"2\" height=\"2\" fill=\"#0000ff\" fill-opacity=\"0.502\"/>\n"
+			"<path d=\"M0 2h1v1h-1zM2 2h2v1h-2z\" fill=\"#00ff00\"/>\n"
+			"</svg>\n");
+
+	Ref<Image> loaded;
+	loaded.instantiate();
+	REQUIRE(loaded->load_svg_from_string(svg) == OK);
+	REQUIRE(loaded->get_width() == 4);
+	REQUIRE(loaded->get_height() == 3);
+	loaded->convert(Image::FORMAT_RGBA8);
+	for (int y = 0; y < 3; y++) {
+		for (int x = 0; x < 4; x++) {
+			// the rasterizer premultiplies, so the translucent pixels can be off by a step
+			Color expected = pixels[y][x];
+			Color actual = loaded->get_pixel(x, y);
+			CHECK_MESSAGE(Math::abs(actual.a - expected.a) < 2.0 / 255.0, vformat("alpha at %d, %d", x, y));
+			if (expected.a > 0) {
+				CHECK_MESSAGE((Math::abs(actual.r - expected.r) < 2.0 / 255.0 && Math::abs(actual.g - expected.g) < 2.0 / 255.0 && Math::abs(actual.b - expected.b) < 2.0 / 255.0), vformat("color at %d, %d", x, y));
+			}
+		}
+	}
+	gdre::rimraf(path);
+}
+
 } // namespace TestResourceExport
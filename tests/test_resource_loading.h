@@ -1,8 +1,11 @@
 #ifndef TEST_RESOURCE_LOADING_H
 #define TEST_RESOURCE_LOADING_H
 
+#include <compat/resource_compat_binary.h>
 #include <compat/resource_compat_text.h>
 #include <compat/resource_loader_compat.h>
+#include <compat/resource_resolution_context.h>
+#include <core/io/resource_saver.h>
 #include <modules/gdscript/gdscript_tokenizer_buffer.h>
 #include <utility/common.h>
 #include <utility/glob.h>
@@ -10,6 +13,7 @@
 #include "test_common.h"
 #include "tests/test_macros.h"
 #include "utility/file_access_gdre.h"
+#include "utility/gdre_config.h"
 
 namespace TestResourceLoading {
 
@@ -164,6 +168,195 @@ TEST_CASE("[GDSDecomp][ResourceLoading] Resource loading modes") {
 	}
 }
 
+TEST_CASE("[GDSDecomp][ResourceLoading] Parallel internal resource decoding matches serial load") {
+	// mesh-like payload: many sub-resources with vertex/index buffers, each linked to the previous one
+	constexpr int SUB_RESOURCE_COUNT = 2000;
+	constexpr int VERTEX_COUNT = 512;
+	Ref<Resource> root;
+	root.instantiate();
+	Array subresources;
+	Ref<Resource> prev;
+	for (int i = 0; i < SUB_RESOURCE_COUNT; i++) {
+		Ref<Resource> sub;
+		sub.instantiate();
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		vertices.resize(VERTEX_COUNT);
+		indices.resize(VERTEX_COUNT);
+		for (int v = 0; v < VERTEX_COUNT; v++) {
+			vertices.set(v, Vector3(i, v, i * v));
+			indices.set(v, VERTEX_COUNT - v - 1);
+		}
+		sub->set_meta("vertices", vertices);
+		sub->set_meta("indices", indices);
+		sub->set_meta("name", vformat("surface_%d", i));
+		if (prev.is_valid()) {
+			Array prev_arr;
+			prev_arr.push_back(prev);
+			sub->set_meta("prev", prev_arr);
+		}
+		subresources.push_back(sub);
+		prev = sub;
+	}
+	root->set_meta("surfaces", subresources);
+	String path = get_tmp_path().path_join("parallel_decode_test.res");
+	gdre::ensure_dir(path.get_base_dir());
+	CHECK(ResourceSaver::save(root, path) == OK);
+
+	auto load_timed = [&](bool p_single_threaded, uint64_t &r_usec) {
+		GDREConfig::get_singleton()->set_setting("force_single_threaded", p_single_threaded);
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
+		Error err;
+		Ref<Resource> res = ResourceCompatLoader::non_global_load(path, "", &err);
+		r_usec = OS::get_singleton()->get_ticks_usec() - start;
+		CHECK(err == OK);
+		return res;
+	};
+	bool was_single_threaded = GDREConfig::get_singleton()->get_setting("force_single_threaded", false);
+	uint64_t serial_time = 0;
+	uint64_t parallel_time = 0;
+	Ref<Resource> serial = load_timed(true, serial_time);
+	Ref<Resource> parallel = load_timed(false, parallel_time);
+	GDREConfig::get_singleton()->set_setting("force_single_threaded", was_single_threaded);
+	print_line(vformat("Loaded %d sub-resources: serial %dus, parallel %dus", SUB_RESOURCE_COUNT, serial_time, parallel_time));
+
+	REQUIRE(serial.is_valid());
+	REQUIRE(parallel.is_valid());
+	Array serial_surfaces = serial->get_meta("surfaces");
+	Array parallel_surfaces = parallel->get_meta("surfaces");
+	REQUIRE(serial_surfaces.size() == SUB_RESOURCE_COUNT);
+	REQUIRE(parallel_surfaces.size() == SUB_RESOURCE_COUNT);
+	for (int i = 0; i < SUB_RESOURCE_COUNT; i++) {
+		Ref<Resource> a = serial_surfaces[i];
+		Ref<Resource> b = parallel_surfaces[i];
+		REQUIRE(a.is_valid());
+		REQUIRE(b.is_valid());
+		CHECK(a->get_meta("vertices") == b->get_meta("vertices"));
+		CHECK(a->get_meta("indices") == b->get_meta("indices"));
+		CHECK(a->get_meta("name") == b->get_meta("name"));
+		CHECK(a->get_path() == b->get_path());
+		if (i > 0) {
+			Array prev_ref = b->get_meta("prev");
+			CHECK(prev_ref.size() == 1);
+			CHECK(Ref<Resource>(prev_ref[0]) == Ref<Resource>(parallel_surfaces[i - 1]));
+		}
+	}
+
+	// make sure the parallel path was actually taken rather than falling back to the serial parse
+	auto decoded_count = [&](bool p_single_threaded) {
+		GDREConfig::get_singleton()->set_setting("force_single_threaded", p_single_threaded);
+		ResourceLoaderCompatBinary loader;
+		loader.open(FileAccess::open(path, FileAccess::READ));
+		CHECK(loader.load() == OK);
+		CHECK(loader.get_resource().is_valid());
+		return loader.get_parallel_decoded_count();
+	};
+	CHECK(decoded_count(true) == 0);
+	// the sub-resources plus the main resource
+	CHECK(decoded_count(false) == SUB_RESOURCE_COUNT + 1);
+	GDREConfig::get_singleton()->set_setting("force_single_threaded", was_single_threaded);
+}
+
+TEST_CASE("[GDSDecomp][ResourceLoading] rename_dependencies rewrites only the dependency table") {
+	String test_dir = get_test_resources_path().path_join("4.4");
+	String tmp_dir = get_tmp_path().path_join("rename_deps_test");
+	gdre::ensure_dir(tmp_dir);
+	Ref<ResourceFormatLoaderCompatBinary> binary_loader;
+	binary_loader.instantiate();
+	for (const String &ext : Vector<String>({ "tres", "res" })) {
+		SUBCASE((String("Rename dependency: ") + ext).utf8().get_data()) {
+			String src = test_dir.path_join("resource_with_deps." + ext);
+			String path = tmp_dir.path_join("resource_with_deps." + ext);
+			CHECK(DirAccess::copy_absolute(src, path) == OK);
+			ResourceFormatLoader *loader = ext == "tres" ? (ResourceFormatLoader *)ResourceFormatLoaderCompatText::singleton : (ResourceFormatLoader *)binary_loader.ptr();
+			REQUIRE(loader != nullptr);
+
+			List<String> deps;
+			loader->get_dependencies(path, &deps);
+			REQUIRE(deps.size() == 1);
+			String old_dep = deps.front()->get();
+			Vector<uint8_t> before = FileAccess::get_file_as_bytes(path);
+
+			// an empty map leaves the file untouched
+			CHECK(loader->rename_dependencies(path, HashMap<String, String>()) == OK);
+			CHECK(FileAccess::get_file_as_bytes(path) == before);
+			CHECK(!FileAccess::exists(path + ".depren"));
+
+			HashMap<String, String> map;
+			map[old_dep.get_slice("::", old_dep.get_slice_count("::") - 1)] = "res://renamed_resource.tres";
+			uint64_t start = OS::get_singleton()->get_ticks_usec();
+			CHECK(loader->rename_dependencies(path, map) == OK);
+			print_line(vformat("rename_dependencies (%s): %dus", ext, OS::get_singleton()->get_ticks_usec() - start));
+			CHECK(!FileAccess::exists(path + ".depren"));
+
+			deps.clear();
+			loader->get_dependencies(path, &deps);
+			REQUIRE(deps.size() == 1);
+			CHECK(deps.front()->get().ends_with("res://renamed_resource.tres"));
+
+			// the body must survive verbatim: the sub-resource is still readable
+			Error err;
+			Ref<Resource> res = ResourceCompatLoader::fake_load(path, "", &err);
+			CHECK(err == OK);
+			REQUIRE(res.is_valid());
+			Ref<Resource> sub = res->get("metadata/test");
+			CHECK(sub.is_valid());
+			if (ext == "tres") {
+				String old_text = String::utf8((const char *)before.ptr(), before.size());
+				String new_text = FileAccess::get_file_as_string(path);
+				CHECK(new_text.substr(new_text.find("[sub_resource")) == old_text.substr(old_text.find("[sub_resource")));
+			}
+		}
+	}
+}
+
+TEST_CASE("[GDSDecomp][ResourceLoading] Resolution contexts substitute external resources without the global cache") {
+	const String path = "res://resolution_context_test/missing_texture.png";
+	Ref<Resource> outer_res = memnew(Resource);
+	Ref<Resource> inner_res = memnew(Resource);
+	{
+		ResourceResolutionContext outer;
+		outer.add(path, outer_res);
+		Error err = FAILED;
+		CHECK(ResourceCompatLoader::custom_load(path, "", ResourceInfo::REAL_LOAD, &err, false, ResourceFormatLoader::CACHE_MODE_REUSE) == outer_res);
+		CHECK(err == OK);
+		{
+			ResourceResolutionContext inner;
+			inner.add(path, inner_res);
+			CHECK(ResourceResolutionContext::resolve(path) == inner_res);
+		}
+		CHECK(ResourceResolutionContext::resolve(path) == outer_res);
+		CHECK(!ResourceCache::has(path));
+	}
+	CHECK(!ResourceResolutionContext::is_active());
+	CHECK(ResourceResolutionContext::resolve(path).is_null());
+}
+
+TEST_CASE("[GDSDecomp][ResourceLoading] Shared resource cache is bounded") {
+	Variant old_size = GDREConfig::get_singleton()->get_setting("Exporter/Scene/shared_resource_cache_size", 128);
+	GDREConfig::get_singleton()->set_setting("Exporter/Scene/shared_resource_cache_size", 2);
+	ResourceResolutionContext::clear_shared();
+	ResourceResolutionContext::reset_shared_stats();
+
+	Ref<Resource> a = memnew(Resource);
+	Ref<Resource> b = memnew(Resource);
+	Ref<Resource> c = memnew(Resource);
+	ResourceResolutionContext::add_shared("a", a);
+	ResourceResolutionContext::add_shared("b", b);
+	CHECK(ResourceResolutionContext::get_shared("a") == a); // a is now the most recently used
+	ResourceResolutionContext::add_shared("c", c);
+	CHECK(ResourceResolutionContext::get_shared("b").is_null());
+	CHECK(ResourceResolutionContext::get_shared("a") == a);
+	CHECK(ResourceResolutionContext::get_shared("c") == c);
+	CHECK(ResourceResolutionContext::get_shared_hits() == 3);
+	CHECK(ResourceResolutionContext::get_shared_misses() == 1);
+	CHECK(ResourceResolutionContext::get_shared_evictions() == 1);
+
+	ResourceResolutionContext::clear_shared();
+	ResourceResolutionContext::reset_shared_stats();
+	GDREConfig::get_singleton()->set_setting("Exporter/Scene/shared_resource_cache_size", old_size);
+}
+
 } //namespace TestResourceLoading
 
 #endif
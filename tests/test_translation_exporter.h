@@ -0,0 +1,65 @@
+#pragma once
+
+#include "compat/optimized_translation_extractor.h"
+#include "exporters/translation_exporter.h"
+#include "tests/test_macros.h"
+#include <core/string/optimized_translation.h>
+
+namespace TestTranslationExporter {
+
+TEST_CASE("[GDSDecomp][TranslationExporter] Common prefixes and suffixes ignore leading and trailing punctuation") {
+	const HashSet<char32_t> punctuation = { '_', '.' };
+	Vector<String> keys = {
+		"__MAIN_OPTIONS_TITLE__",
+		"_MAIN_CREDITS_TITLE",
+		"..MAIN_QUIT_TITLE.",
+		"___",
+	};
+	Vector<String> prefixes;
+	Vector<String> suffixes;
+	TranslationExporter::find_common_prefixes_and_suffixes(keys, punctuation, 3, prefixes, suffixes);
+	CHECK(prefixes == Vector<String>({ "MAIN" }));
+	CHECK(suffixes == Vector<String>({ "TITLE" }));
+
+	// below the threshold, the longer parts show up too, and they are still substrings of the trimmed keys
+	TranslationExporter::find_common_prefixes_and_suffixes(keys, punctuation, 1, prefixes, suffixes);
+	CHECK(prefixes.has("MAIN_OPTIONS"));
+	CHECK(suffixes.has("QUIT_TITLE"));
+	for (const String &part : prefixes) {
+		CHECK_MESSAGE(!punctuation.has(part[0]), part.utf8().get_data());
+		CHECK_MESSAGE(!punctuation.has(part[part.length() - 1]), part.utf8().get_data());
+	}
+	for (const String &part : suffixes) {
+		CHECK_MESSAGE(!punctuation.has(part[0]), part.utf8().get_data());
+		CHECK_MESSAGE(!punctuation.has(part[part.length() - 1]), part.utf8().get_data());
+	}
+}
+
+TEST_CASE("[GDSDecomp][TranslationExporter] Optimized translation messages iterate in list order") {
+	Ref<Translation> tr;
+	tr.instantiate();
+	tr->set_locale("en");
+	for (int i = 0; i < 500; i++) {
+		// a mix of short strings, strings smaz compresses, and non-ASCII text
+		String msg = i % 3 == 0 ? vformat("msg%d", i) : (i % 3 == 1 ? vformat("This is the message for the %d key, with \"quotes\", commas\nand newlines", i) : vformat("ключ %d 日本語", i));
+		tr->add_message(vformat("KEY_%d", i), msg);
+	}
+	Ref<OptimizedTranslation> otr;
+	otr.instantiate();
+	otr->generate(tr);
+
+	Vector<String> expected = otr->get_translated_message_list();
+	Ref<OptimizedTranslationExtractor> extractor = OptimizedTranslationExtractor::create_from(otr);
+	CHECK(extractor->get_message_count() == expected.size());
+	OptimizedTranslationExtractor::MessageIterator it(extractor);
+	CharString utf8;
+	int64_t count = 0;
+	while (it.next(utf8)) {
+		REQUIRE(count < expected.size());
+		CHECK(String::utf8(utf8.get_data()) == expected[count]);
+		count++;
+	}
+	CHECK(count == expected.size());
+}
+
+} // namespace TestTranslationExporter
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/string/translation.h"
+#include "modules/regex/regex.h"
+#include "tests/test_macros.h"
+#include "utility/word_scanner.h"
+
+namespace TestWordScanner {
+
+Vector<String> create_word_scanner_corpus() {
+	Vector<String> corpus = {
+		"",
+		"KEY",
+		"KEY_",
+		"KEY_ONE",
+		"say KEY_ONE and KEY_TWO.",
+		"KEY_ONEKEY_TWO",
+		"xKEY_ONE KEY_ONEx _KEY_ONE_",
+		"tr(\"UI_MENU_START\") + tr(\"UI_MENU_QUIT\")",
+		"ключ KEY_ÜBER KEY_ok日本語 KEY_9",
+		"a.b.c-d e_f\nKEY_\tKEY_x",
+		"...___---",
+	};
+	const char32_t alphabet[] = { 'a', 'Z', '9', '_', '.', '-', ' ', '\n', 'K', 'E', 'Y', U'é', U'日', '"' };
+	uint32_t state = 12345;
+	for (int i = 0; i < 2000; i++) {
+		String s;
+		int len = i % 40;
+		for (int j = 0; j < len; j++) {
+			state = state * 1664525u + 1013904223u;
+			uint32_t r = state >> 16;
+			if (r % 9 == 0) {
+				s += "KEY_";
+			} else {
+				s += alphabet[r % (sizeof(alphabet) / sizeof(alphabet[0]))];
+			}
+		}
+		corpus.push_back(s);
+	}
+	return corpus;
+}
+
+void check_scanner_matches_regex(const String &p_prefix, const HashSet<char32_t> &p_extra, bool p_word_boundaries) {
+	String char_re = "[\\w\\d";
+	for (char32_t p : p_extra) {
+		char_re += "\\" + String::chr(p);
+	}
+	char_re += "]";
+	Ref<RegEx> re = RegEx::create_from_string(p_word_boundaries ? "\\b" + p_prefix + char_re + "+\\b" : p_prefix + char_re + "+");
+	REQUIRE(re.is_valid());
+	gdre::WordScanner scanner(p_prefix, p_extra, p_word_boundaries);
+
+	for (const String &s : create_word_scanner_corpus()) {
+		Vector<String> expected;
+		for (const Ref<RegExMatch> match : re->search_all(s)) {
+			expected.push_back(match->get_string());
+		}
+		Vector<String> got;
+		CharString utf8 = s.utf8();
+		scanner.scan(utf8.get_data(), utf8.length(), [&](const char *p_match, int64_t p_len) {
+			got.push_back(String::utf8(p_match, p_len));
+		});
+		CHECK_MESSAGE(got == expected, vformat("prefix '%s', boundaries %s, input '%s'", p_prefix, p_word_boundaries, s.c_escape()).utf8().get_data());
+	}
+}
+
+TEST_CASE("[GDSDecomp][WordScanner] Scanner finds the same spans as RegEx") {
+	const HashSet<char32_t> no_extra;
+	const HashSet<char32_t> key_punct = { '.', '-' };
+	const HashSet<char32_t> with_space = { ' ' };
+	for (const String &prefix : { String(), String("KEY_"), String("K"), String("é") }) {
+		for (bool boundaries : { false, true }) {
+			check_scanner_matches_regex(prefix, no_extra, boundaries);
+			check_scanner_matches_regex(prefix, key_punct, boundaries);
+			check_scanner_matches_regex(prefix, with_space, boundaries);
+		}
+	}
+}
+
+TEST_CASE("[GDSDecomp][WordScanner] Non-ASCII keys can be looked up from scanned spans") {
+	// the translation exporter looks up each span as a key; the span is UTF-8 and has to be decoded as such
+	Ref<Translation> translation;
+	translation.instantiate();
+	translation->add_message(String::utf8("ÜBER_START"), "Start");
+	translation->add_message(String::utf8("ÜBER_QUIT"), "Quit");
+	gdre::WordScanner scanner(String::utf8("ÜBER_"), HashSet<char32_t>(), false);
+
+	CharString utf8 = String::utf8("tr(\"ÜBER_START\") + tr(\"ÜBER_QUIT\") 日本語").utf8();
+	Vector<String> found;
+	scanner.scan(utf8.get_data(), utf8.length(), [&](const char *p_match, int64_t p_len) {
+		String key = String::utf8(p_match, p_len);
+		if (!translation->get_message(key).is_empty()) {
+			found.push_back(key);
+		}
+	});
+	REQUIRE(found.size() == 2);
+	CHECK(found[0] == String::utf8("ÜBER_START"));
+	CHECK(found[1] == String::utf8("ÜBER_QUIT"));
+}
+
+} // namespace TestWordScanner
@@ -0,0 +1,757 @@
+#include "archive_writer.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/os/time.h"
+#include "utility/common.h"
+
+#include <zlib.h>
+
+using namespace gdre;
+
+namespace {
+constexpr uint32_t ZIP_LOCAL_HEADER_SIG = 0x04034b50;
+constexpr uint32_t ZIP_CENTRAL_HEADER_SIG = 0x02014b50;
+constexpr uint32_t ZIP_END_SIG = 0x06054b50;
+constexpr uint32_t ZIP64_END_SIG = 0x06064b50;
+constexpr uint32_t ZIP64_LOCATOR_SIG = 0x07064b50;
+constexpr uint16_t ZIP_VERSION = 20;
+constexpr uint16_t ZIP64_VERSION = 45;
+constexpr uint16_t ZIP_FLAG_UTF8 = 1 << 11;
+constexpr uint16_t ZIP_EXTRA_ZIP64 = 0x0001;
+constexpr uint16_t ZIP_EXTRA_TIMESTAMP = 0x5455; // "UT", exact unix mtime
+constexpr uint16_t ZIP_TIMESTAMP_EXTRA_SIZE = 9;
+constexpr uint64_t ZIP32_MAX = 0xFFFFFFFF;
+constexpr uint64_t ZIP16_MAX = 0xFFFF;
+// entry methods; the zip ones are what ends up in the headers
+constexpr uint16_t METHOD_STORE = 0;
+constexpr uint16_t METHOD_DEFLATE = 8;
+constexpr uint16_t METHOD_ZSTD = 93;
+constexpr uint64_t TAR_BLOCK_SIZE = 512;
+// sizes from 8 GiB up don't fit in the 11 octal digits of the ustar size field
+constexpr uint64_t TAR_OCTAL_SIZE_MAX = 077777777777ULL;
+constexpr uint32_t ZSTD_SKIPPABLE_MAGIC = 0x184D2A50;
+constexpr uint64_t ZSTD_SKIPPABLE_MAX = 1ULL << 31;
+constexpr uint64_t COPY_CHUNK_SIZE = 4 * 1024 * 1024;
+
+struct ByteBuilder {
+	Vector<uint8_t> data;
+
+	void put_buffer(const void *p_src, uint64_t p_size) {
+		if (p_size == 0) {
+			return;
+		}
+		int64_t pos = data.size();
+		data.resize(pos + p_size);
+		memcpy(data.ptrw() + pos, p_src, p_size);
+	}
+	void put_16(uint16_t p_value) {
+		uint8_t buf[2];
+		encode_uint16(p_value, buf);
+		put_buffer(buf, 2);
+	}
+	void put_32(uint32_t p_value) {
+		uint8_t buf[4];
+		encode_uint32(p_value, buf);
+		put_buffer(buf, 4);
+	}
+	void put_64(uint64_t p_value) {
+		uint8_t buf[8];
+		encode_uint64(p_value, buf);
+		put_buffer(buf, 8);
+	}
+};
+
+uint64_t tar_padded_size(uint64_t p_size) {
+	return (p_size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+}
+
+void unix_time_to_dos(uint64_t p_time, uint16_t &r_time, uint16_t &r_date) {
+	Dictionary dt = Time::get_singleton()->get_datetime_dict_from_unix_time((int64_t)p_time);
+	int year = MAX((int)dt.get("year", 1980), 1980);
+	r_date = (uint16_t)(((year - 1980) << 9) | ((int)dt.get("month", 1) << 5) | (int)dt.get("day", 1));
+	r_time = (uint16_t)(((int)dt.get("hour", 0) << 11) | ((int)dt.get("minute", 0) << 5) | ((int)dt.get("second", 0) / 2));
+}
+
+Error deflate_raw(const Vector<uint8_t> &p_data, int p_level, Vector<uint8_t> &r_out) {
+	z_stream strm = {};
+	if (deflateInit2(&strm, p_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return ERR_BUG;
+	}
+	r_out.resize(deflateBound(&strm, p_data.size()));
+	strm.next_in = (Bytef *)p_data.ptr();
+	strm.next_out = r_out.ptrw();
+	// avail_in/avail_out are 32-bit, so feed large entries in pieces
+	uint64_t in_left = p_data.size();
+	uint64_t out_left = r_out.size();
+	int ret = Z_OK;
+	while (ret == Z_OK) {
+		uint32_t in_chunk = (uint32_t)MIN(in_left, (uint64_t)UINT32_MAX);
+		uint32_t out_chunk = (uint32_t)MIN(out_left, (uint64_t)UINT32_MAX);
+		strm.avail_in = in_chunk;
+		strm.avail_out = out_chunk;
+		ret = deflate(&strm, in_left == in_chunk ? Z_FINISH : Z_NO_FLUSH);
+		in_left -= in_chunk - strm.avail_in;
+		out_left -= out_chunk - strm.avail_out;
+	}
+	uint64_t written = strm.total_out;
+	deflateEnd(&strm);
+	if (ret != Z_STREAM_END) {
+		return ERR_BUG;
+	}
+	r_out.resize(written);
+	return OK;
+}
+
+Error inflate_raw(const Vector<uint8_t> &p_data, uint64_t p_size, Vector<uint8_t> &r_out) {
+	z_stream strm = {};
+	if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+		return ERR_BUG;
+	}
+	r_out.resize(p_size);
+	strm.next_in = (Bytef *)p_data.ptr();
+	strm.next_out = r_out.ptrw();
+	uint64_t in_left = p_data.size();
+	uint64_t out_left = p_size;
+	int ret = Z_OK;
+	while (ret == Z_OK) {
+		uint32_t in_chunk = (uint32_t)MIN(in_left, (uint64_t)UINT32_MAX);
+		uint32_t out_chunk = (uint32_t)MIN(out_left, (uint64_t)UINT32_MAX);
+		strm.avail_in = in_chunk;
+		strm.avail_out = out_chunk;
+		ret = inflate(&strm, Z_NO_FLUSH);
+		in_left -= in_chunk - strm.avail_in;
+		out_left -= out_chunk - strm.avail_out;
+		if (ret == Z_OK && in_chunk == strm.avail_in && out_chunk == strm.avail_out) {
+			break; // no progress, truncated input
+		}
+	}
+	inflateEnd(&strm);
+	ERR_FAIL_COND_V(ret != Z_STREAM_END || out_left != 0, ERR_FILE_CORRUPT);
+	return OK;
+}
+
+Error compress_zstd_frame(const uint8_t *p_src, uint64_t p_size, Vector<uint8_t> &r_out) {
+	r_out.resize(Compression::get_max_compressed_buffer_size(p_size, Compression::MODE_ZSTD));
+	int64_t written = Compression::compress(r_out.ptrw(), p_src, p_size, Compression::MODE_ZSTD);
+	ERR_FAIL_COND_V(written <= 0, ERR_BUG);
+	r_out.resize(written);
+	return OK;
+}
+
+void write_octal(char *p_dst, size_t p_len, uint64_t p_value) {
+	// zero-padded, NUL-terminated
+	p_dst[p_len - 1] = 0;
+	for (int64_t i = p_len - 2; i >= 0; i--) {
+		p_dst[i] = '0' + (p_value & 7);
+		p_value >>= 3;
+	}
+}
+
+void write_tar_size(char *p_dst, uint64_t p_size) {
+	if (p_size <= TAR_OCTAL_SIZE_MAX) {
+		write_octal(p_dst, 12, p_size);
+		return;
+	}
+	// GNU base-256: high bit set on the first byte, big-endian value in the rest
+	memset(p_dst, 0, 12);
+	p_dst[0] = (char)0x80;
+	for (int i = 11; i >= 4; i--) {
+		p_dst[i] = (char)(p_size & 0xFF);
+		p_size >>= 8;
+	}
+}
+} // namespace
+
+ArchiveWriter::Format ArchiveWriter::get_format_for_path(const String &p_path) {
+	String lower = p_path.to_lower();
+	if (lower.ends_with(".zip")) {
+		return FORMAT_ZIP;
+	}
+	if (lower.ends_with(".tar")) {
+		return FORMAT_TAR;
+	}
+	if (lower.ends_with(".tar.zst") || lower.ends_with(".tzst")) {
+		return FORMAT_TAR_ZSTD;
+	}
+	return FORMAT_NONE;
+}
+
+Error ArchiveWriter::open(const String &p_path, int p_compression_level) {
+	ERR_FAIL_COND_V_MSG(file.is_valid(), ERR_ALREADY_IN_USE, "Archive is already open");
+	format = get_format_for_path(p_path);
+	ERR_FAIL_COND_V_MSG(format == FORMAT_NONE, ERR_FILE_UNRECOGNIZED, "Unsupported archive format: " + p_path);
+	// only used for zip; .tar.zst uses the engine's zstd level
+	compression_level = CLAMP(p_compression_level, 0, 9);
+	Error err = gdre::ensure_dir(p_path.get_base_dir());
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to create directory for " + p_path);
+	// read back through the same handle for read_entry and renames
+	file = FileAccess::open(p_path, FileAccess::WRITE_READ, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err, "Failed to open " + p_path + " for writing");
+	closing = false;
+	failed = false;
+	write_pos = 0;
+	appender = memnew(Thread);
+	appender->start(_appender_func, this);
+	return OK;
+}
+
+Error ArchiveWriter::_compress_entry(const Vector<uint8_t> &p_data, Entry *p_entry) const {
+	p_entry->size = p_data.size();
+	p_entry->method = METHOD_STORE;
+	if (format == FORMAT_ZIP) {
+		p_entry->crc = crc32(0L, Z_NULL, 0);
+		// crc32 takes a 32-bit length
+		for (uint64_t pos = 0; pos < p_entry->size; pos += UINT32_MAX) {
+			uint32_t len = (uint32_t)MIN(p_entry->size - pos, (uint64_t)UINT32_MAX);
+			p_entry->crc = crc32(p_entry->crc, p_data.ptr() + pos, len);
+		}
+		if (compression_level > 0 && p_data.size() > 0) {
+			Vector<uint8_t> compressed;
+			if (deflate_raw(p_data, compression_level, compressed) == OK && compressed.size() < p_data.size()) {
+				p_entry->stored = compressed;
+				p_entry->method = METHOD_DEFLATE;
+			}
+		}
+	} else if (format == FORMAT_TAR_ZSTD) {
+		// the tar padding is part of the last frame, so the decompressed stream is a plain tar
+		uint64_t padded_size = tar_padded_size(p_entry->size);
+		uint64_t frame_count = (padded_size + ZSTD_FRAME_SIZE - 1) / ZSTD_FRAME_SIZE;
+		Vector<uint8_t> compressed;
+		compressed.resize(frame_count * Compression::get_max_compressed_buffer_size(ZSTD_FRAME_SIZE, Compression::MODE_ZSTD));
+		uint64_t compressed_size = 0;
+		Vector<uint8_t> tail;
+		for (uint64_t pos = 0; pos < padded_size; pos += ZSTD_FRAME_SIZE) {
+			uint64_t len = MIN(ZSTD_FRAME_SIZE, padded_size - pos);
+			const uint8_t *src = p_data.ptr() + pos;
+			if (pos + len > p_entry->size) {
+				tail.resize(len);
+				memset(tail.ptrw(), 0, len);
+				memcpy(tail.ptrw(), src, p_entry->size - pos);
+				src = tail.ptr();
+			}
+			int64_t written = Compression::compress(compressed.ptrw() + compressed_size, src, len, Compression::MODE_ZSTD);
+			ERR_FAIL_COND_V_MSG(written <= 0, ERR_BUG, "Failed to compress " + p_entry->name);
+			p_entry->frames.push_back((uint32_t)written);
+			compressed_size += written;
+		}
+		compressed.resize(compressed_size);
+		p_entry->stored = compressed;
+		p_entry->method = METHOD_ZSTD;
+	}
+	if (p_entry->method == METHOD_STORE) {
+		// plain tar padding is written by the appender
+		p_entry->stored = p_data;
+	}
+	p_entry->stored_size = p_entry->stored.size();
+	return OK;
+}
+
+Error ArchiveWriter::_queue_entry(Entry *p_entry, uint32_t *r_id) {
+	MutexLock lock(mutex);
+	while (pending_bytes > MAX_PENDING_BYTES && !failed) {
+		space_cv.wait(lock);
+	}
+	if (failed || closing) {
+		String name = p_entry->name;
+		memdelete(p_entry);
+		ERR_FAIL_V_MSG(ERR_FILE_CANT_WRITE, "Archive writer is not accepting entries, not adding " + name);
+	}
+	uint32_t id = entries.size();
+	entries.push_back(p_entry);
+	queue.push_back(id);
+	pending_bytes += p_entry->stored.size();
+	queue_cv.notify_one();
+	if (r_id) {
+		*r_id = id;
+	}
+	return OK;
+}
+
+Error ArchiveWriter::add_entry(const String &p_name, const Vector<uint8_t> &p_data, uint64_t p_modified_time, uint32_t *r_id) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_UNCONFIGURED, "Archive is not open");
+	Entry *entry = memnew(Entry);
+	entry->name = p_name.trim_prefix("/");
+	entry->modified_time = p_modified_time;
+	Error err = _compress_entry(p_data, entry);
+	if (err != OK) {
+		memdelete(entry);
+		return err;
+	}
+	return _queue_entry(entry, r_id);
+}
+
+Error ArchiveWriter::_read_stored(uint64_t p_offset, uint64_t p_size, Vector<uint8_t> &r_data) {
+	r_data.resize(p_size);
+	MutexLock lock(file_mutex);
+	ERR_FAIL_COND_V(file.is_null(), ERR_FILE_CANT_READ);
+	file->seek(p_offset);
+	ERR_FAIL_COND_V_MSG(file->get_buffer(r_data.ptrw(), p_size) != p_size, ERR_FILE_CANT_READ, "Failed to read back an archive entry");
+	return OK;
+}
+
+Error ArchiveWriter::read_entry(uint32_t p_id, Vector<uint8_t> &r_data) {
+	Vector<uint8_t> stored;
+	LocalVector<uint32_t> frames;
+	uint64_t size = 0;
+	uint64_t data_offset = 0;
+	uint64_t stored_size = 0;
+	uint16_t method = METHOD_STORE;
+	bool appended = false;
+	{
+		MutexLock lock(mutex);
+		ERR_FAIL_UNSIGNED_INDEX_V(p_id, entries.size(), ERR_INVALID_PARAMETER);
+		const Entry *entry = entries[p_id];
+		appended = entry->appended;
+		if (!appended) {
+			stored = entry->stored;
+		}
+		frames = entry->frames;
+		size = entry->size;
+		data_offset = entry->data_offset;
+		stored_size = entry->stored_size;
+		method = entry->method;
+	}
+	if (appended) {
+		Error err = _read_stored(data_offset, stored_size, stored);
+		ERR_FAIL_COND_V(err != OK, err);
+	}
+	if (method == METHOD_DEFLATE) {
+		return inflate_raw(stored, size, r_data);
+	}
+	if (method == METHOD_ZSTD) {
+		uint64_t padded_size = tar_padded_size(size);
+		r_data.resize(padded_size);
+		uint64_t src_pos = 0;
+		uint64_t dst_pos = 0;
+		for (uint32_t frame_size : frames) {
+			uint64_t len = MIN(ZSTD_FRAME_SIZE, padded_size - dst_pos);
+			int64_t read = Compression::decompress(r_data.ptrw() + dst_pos, len, stored.ptr() + src_pos, frame_size, Compression::MODE_ZSTD);
+			ERR_FAIL_COND_V_MSG(read != (int64_t)len, ERR_FILE_CORRUPT, "Failed to decompress an archive entry");
+			src_pos += frame_size;
+			dst_pos += len;
+		}
+		r_data.resize(size);
+		return OK;
+	}
+	r_data = stored;
+	return OK;
+}
+
+Error ArchiveWriter::rename_entry(uint32_t p_id, const String &p_new_name, uint32_t *r_new_id) {
+	Entry *copy = nullptr;
+	bool appended = false;
+	uint64_t data_offset = 0;
+	{
+		MutexLock lock(mutex);
+		ERR_FAIL_UNSIGNED_INDEX_V(p_id, entries.size(), ERR_INVALID_PARAMETER);
+		Entry *entry = entries[p_id];
+		ERR_FAIL_COND_V(entry->dead, ERR_FILE_NOT_FOUND);
+		if (!entry->taken) {
+			entry->name = p_new_name.trim_prefix("/");
+			*r_new_id = p_id;
+			return OK;
+		}
+		// the header is already being written; re-add the stored bytes under the new name
+		copy = memnew(Entry);
+		copy->name = p_new_name.trim_prefix("/");
+		copy->frames = entry->frames;
+		copy->size = entry->size;
+		copy->stored_size = entry->stored_size;
+		copy->modified_time = entry->modified_time;
+		copy->crc = entry->crc;
+		copy->method = entry->method;
+		appended = entry->appended;
+		if (appended) {
+			data_offset = entry->data_offset;
+		} else {
+			copy->stored = entry->stored;
+		}
+	}
+	if (appended) {
+		Error err = _read_stored(data_offset, copy->stored_size, copy->stored);
+		if (err != OK) {
+			memdelete(copy);
+			return err;
+		}
+	}
+	Error err = _queue_entry(copy, r_new_id);
+	ERR_FAIL_COND_V(err != OK, err);
+	remove_entry(p_id);
+	return OK;
+}
+
+void ArchiveWriter::remove_entry(uint32_t p_id) {
+	MutexLock lock(mutex);
+	ERR_FAIL_UNSIGNED_INDEX(p_id, entries.size());
+	entries[p_id]->dead = true;
+}
+
+void ArchiveWriter::_appender_func(void *p_userdata) {
+	((ArchiveWriter *)p_userdata)->_appender_loop();
+}
+
+void ArchiveWriter::_appender_loop() {
+	static const uint8_t padding[TAR_BLOCK_SIZE] = {};
+	LocalVector<Entry *> batch;
+	LocalVector<uint64_t> offsets;
+	while (true) {
+		{
+			MutexLock lock(mutex);
+			while (queue.is_empty() && !closing) {
+				queue_cv.wait(lock);
+			}
+			if (queue.is_empty() && closing) {
+				return;
+			}
+			uint64_t dropped_bytes = 0;
+			for (uint32_t id : queue) {
+				Entry *entry = entries[id];
+				if (entry->dead) {
+					// removed before it was ever written
+					dropped_bytes += entry->stored.size();
+					entry->stored = Vector<uint8_t>();
+					continue;
+				}
+				entry->taken = true;
+				batch.push_back(entry);
+			}
+			queue.clear();
+			if (dropped_bytes > 0) {
+				pending_bytes -= dropped_bytes;
+				space_cv.notify_all();
+			}
+		}
+		{
+			// taken entries' names and stored bytes don't change anymore, so they're read without the lock
+			MutexLock file_lock(file_mutex);
+			file->seek(write_pos);
+			for (Entry *entry : batch) {
+				offsets.push_back(file->get_position());
+				if (!failed) {
+					Vector<uint8_t> header = _make_header(entry);
+					if (header.is_empty() || !file->store_buffer(header.ptr(), header.size())) {
+						failed = true;
+					}
+				}
+				offsets.push_back(file->get_position());
+				if (!failed && !file->store_buffer(entry->stored.ptr(), entry->stored.size())) {
+					failed = true;
+				}
+				if (!failed && format == FORMAT_TAR) {
+					uint64_t rem = entry->stored_size % TAR_BLOCK_SIZE;
+					if (rem && !file->store_buffer(padding, TAR_BLOCK_SIZE - rem)) {
+						failed = true;
+					}
+				}
+			}
+			write_pos = file->get_position();
+		}
+		MutexLock lock(mutex);
+		uint64_t written_bytes = 0;
+		for (uint32_t i = 0; i < batch.size(); i++) {
+			Entry *entry = batch[i];
+			written_bytes += entry->stored.size();
+			if (!failed) {
+				entry->offset = offsets[i * 2];
+				entry->data_offset = offsets[i * 2 + 1];
+				entry->appended = true;
+				entry->stored = Vector<uint8_t>();
+			}
+		}
+		batch.clear();
+		offsets.clear();
+		pending_bytes -= written_bytes;
+		space_cv.notify_all();
+	}
+}
+
+Vector<uint8_t> ArchiveWriter::_make_tar_header(const CharString &p_name, uint64_t p_size, uint64_t p_modified_time, char p_type) const {
+	Vector<uint8_t> block;
+	block.resize(TAR_BLOCK_SIZE);
+	char *header = (char *)block.ptrw();
+	memset(header, 0, TAR_BLOCK_SIZE);
+	memcpy(header, p_name.get_data(), MIN((size_t)p_name.length(), (size_t)100));
+	write_octal(header + 100, 8, 0644);
+	write_octal(header + 108, 8, 0);
+	write_octal(header + 116, 8, 0);
+	write_tar_size(header + 124, p_size);
+	write_octal(header + 136, 12, p_modified_time);
+	memset(header + 148, ' ', 8);
+	header[156] = p_type;
+	memcpy(header + 257, "ustar", 6);
+	memcpy(header + 263, "00", 2);
+	uint32_t checksum = 0;
+	for (size_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+		checksum += (uint8_t)header[i];
+	}
+	write_octal(header + 148, 7, checksum);
+	header[155] = ' ';
+	return block;
+}
+
+Vector<uint8_t> ArchiveWriter::_make_header(const Entry *p_entry) const {
+	CharString name = p_entry->name.utf8();
+	if (format == FORMAT_ZIP) {
+		ERR_FAIL_COND_V_MSG((uint64_t)name.length() > ZIP16_MAX, Vector<uint8_t>(), "Name too long for a zip entry: " + p_entry->name);
+		uint16_t dos_time;
+		uint16_t dos_date;
+		unix_time_to_dos(p_entry->modified_time, dos_time, dos_date);
+		bool zip64 = p_entry->size >= ZIP32_MAX || p_entry->stored_size >= ZIP32_MAX;
+		ByteBuilder header;
+		header.put_32(ZIP_LOCAL_HEADER_SIG);
+		header.put_16(zip64 ? ZIP64_VERSION : ZIP_VERSION);
+		header.put_16(ZIP_FLAG_UTF8);
+		header.put_16(p_entry->method);
+		header.put_16(dos_time);
+		header.put_16(dos_date);
+		header.put_32(p_entry->crc);
+		header.put_32(zip64 ? ZIP32_MAX : p_entry->stored_size);
+		header.put_32(zip64 ? ZIP32_MAX : p_entry->size);
+		header.put_16(name.length());
+		header.put_16((zip64 ? 20 : 0) + ZIP_TIMESTAMP_EXTRA_SIZE);
+		header.put_buffer(name.get_data(), name.length());
+		if (zip64) {
+			header.put_16(ZIP_EXTRA_ZIP64);
+			header.put_16(16);
+			header.put_64(p_entry->size);
+			header.put_64(p_entry->stored_size);
+		}
+		header.put_16(ZIP_EXTRA_TIMESTAMP);
+		header.put_16(5);
+		header.put_buffer("\x01", 1); // mtime present
+		header.put_32((uint32_t)MIN(p_entry->modified_time, ZIP32_MAX));
+		return header.data;
+	}
+
+	ByteBuilder header;
+	if (name.length() > 100) {
+		// GNU long name record, understood by every tar we care about
+		header.put_buffer(_make_tar_header(CharString("././@LongLink"), name.length() + 1, 0, 'L').ptr(), TAR_BLOCK_SIZE);
+		Vector<uint8_t> long_name;
+		long_name.resize(tar_padded_size(name.length() + 1));
+		memset(long_name.ptrw(), 0, long_name.size());
+		memcpy(long_name.ptrw(), name.get_data(), name.length());
+		header.put_buffer(long_name.ptr(), long_name.size());
+	}
+	header.put_buffer(_make_tar_header(name, p_entry->size, p_entry->modified_time, '0').ptr(), TAR_BLOCK_SIZE);
+	if (format == FORMAT_TAR_ZSTD) {
+		Vector<uint8_t> frame;
+		ERR_FAIL_COND_V(compress_zstd_frame(header.data.ptr(), header.data.size(), frame) != OK, Vector<uint8_t>());
+		return frame;
+	}
+	return header.data;
+}
+
+LocalVector<ArchiveWriter::Entry *> ArchiveWriter::_get_appended_entries() const {
+	LocalVector<Entry *> appended;
+	for (Entry *entry : entries) {
+		if (entry->appended) {
+			appended.push_back(entry);
+		}
+	}
+	appended.sort_custom<EntryOffsetComparator>();
+	return appended;
+}
+
+uint64_t ArchiveWriter::_get_entry_end(const Entry *p_entry) const {
+	if (format == FORMAT_TAR) {
+		return p_entry->data_offset + tar_padded_size(p_entry->stored_size);
+	}
+	return p_entry->data_offset + p_entry->stored_size;
+}
+
+Error ArchiveWriter::_write_zip_central_directory() {
+	// removed and renamed entries are left out; their bytes stay behind as unreferenced data
+	LocalVector<Entry *> live;
+	for (Entry *entry : _get_appended_entries()) {
+		if (!entry->dead) {
+			live.push_back(entry);
+		}
+	}
+	file->seek(write_pos);
+	uint64_t cd_start = write_pos;
+	ByteBuilder cd;
+	for (const Entry *entry : live) {
+		CharString name = entry->name.utf8();
+		uint16_t dos_time;
+		uint16_t dos_date;
+		unix_time_to_dos(entry->modified_time, dos_time, dos_date);
+		bool big_uncompressed = entry->size >= ZIP32_MAX;
+		bool big_compressed = entry->stored_size >= ZIP32_MAX;
+		bool big_offset = entry->offset >= ZIP32_MAX;
+		uint16_t zip64_size = (big_uncompressed + big_compressed + big_offset) * 8;
+		bool zip64 = zip64_size > 0;
+		cd.put_32(ZIP_CENTRAL_HEADER_SIG);
+		cd.put_16((3 << 8) | ZIP64_VERSION); // made by unix
+		cd.put_16(zip64 ? ZIP64_VERSION : ZIP_VERSION);
+		cd.put_16(ZIP_FLAG_UTF8);
+		cd.put_16(entry->method);
+		cd.put_16(dos_time);
+		cd.put_16(dos_date);
+		cd.put_32(entry->crc);
+		cd.put_32(big_compressed ? ZIP32_MAX : entry->stored_size);
+		cd.put_32(big_uncompressed ? ZIP32_MAX : entry->size);
+		cd.put_16(name.length());
+		cd.put_16((zip64 ? zip64_size + 4 : 0) + ZIP_TIMESTAMP_EXTRA_SIZE);
+		cd.put_16(0); // comment
+		cd.put_16(0); // disk number
+		cd.put_16(0); // internal attributes
+		cd.put_32(0100644u << 16); // external attributes: regular file, rw-r--r--
+		cd.put_32(big_offset ? ZIP32_MAX : entry->offset);
+		cd.put_buffer(name.get_data(), name.length());
+		if (zip64) {
+			cd.put_16(ZIP_EXTRA_ZIP64);
+			cd.put_16(zip64_size);
+			if (big_uncompressed) {
+				cd.put_64(entry->size);
+			}
+			if (big_compressed) {
+				cd.put_64(entry->stored_size);
+			}
+			if (big_offset) {
+				cd.put_64(entry->offset);
+			}
+		}
+		cd.put_16(ZIP_EXTRA_TIMESTAMP);
+		cd.put_16(5);
+		cd.put_buffer("\x01", 1);
+		cd.put_32((uint32_t)MIN(entry->modified_time, ZIP32_MAX));
+		if (cd.data.size() >= (int64_t)COPY_CHUNK_SIZE) {
+			ERR_FAIL_COND_V(!file->store_buffer(cd.data.ptr(), cd.data.size()), ERR_FILE_CANT_WRITE);
+			cd.data.clear();
+		}
+	}
+	ERR_FAIL_COND_V(!file->store_buffer(cd.data.ptr(), cd.data.size()), ERR_FILE_CANT_WRITE);
+	uint64_t cd_end = file->get_position();
+	uint64_t cd_size = cd_end - cd_start;
+	uint64_t count = live.size();
+	ByteBuilder end;
+	if (count >= ZIP16_MAX || cd_size >= ZIP32_MAX || cd_start >= ZIP32_MAX) {
+		end.put_32(ZIP64_END_SIG);
+		end.put_64(44);
+		end.put_16((3 << 8) | ZIP64_VERSION);
+		end.put_16(ZIP64_VERSION);
+		end.put_32(0); // this disk
+		end.put_32(0); // central directory disk
+		end.put_64(count);
+		end.put_64(count);
+		end.put_64(cd_size);
+		end.put_64(cd_start);
+		end.put_32(ZIP64_LOCATOR_SIG);
+		end.put_32(0);
+		end.put_64(cd_end);
+		end.put_32(1);
+	}
+	end.put_32(ZIP_END_SIG);
+	end.put_16(0);
+	end.put_16(0);
+	end.put_16(MIN(count, ZIP16_MAX));
+	end.put_16(MIN(count, ZIP16_MAX));
+	end.put_32(MIN(cd_size, ZIP32_MAX));
+	end.put_32(MIN(cd_start, ZIP32_MAX));
+	end.put_16(0); // comment
+	ERR_FAIL_COND_V(!file->store_buffer(end.data.ptr(), end.data.size()), ERR_FILE_CANT_WRITE);
+	return OK;
+}
+
+Error ArchiveWriter::_finish_tar() {
+	// tar has no way to skip a record, so live entries after a removed one are moved down over it
+	uint64_t dst = 0;
+	Vector<uint8_t> buf;
+	for (const Entry *entry : _get_appended_entries()) {
+		uint64_t end = _get_entry_end(entry);
+		if (entry->dead) {
+			continue;
+		}
+		if (entry->offset != dst) {
+			if (buf.is_empty()) {
+				buf.resize(COPY_CHUNK_SIZE);
+			}
+			for (uint64_t pos = entry->offset; pos < end;) {
+				uint64_t len = MIN(COPY_CHUNK_SIZE, end - pos);
+				file->seek(pos);
+				ERR_FAIL_COND_V(file->get_buffer(buf.ptrw(), len) != len, ERR_FILE_CANT_READ);
+				file->seek(dst + (pos - entry->offset));
+				ERR_FAIL_COND_V(!file->store_buffer(buf.ptr(), len), ERR_FILE_CANT_WRITE);
+				pos += len;
+			}
+		}
+		dst += end - entry->offset;
+	}
+	// two zero blocks mark the end of a tar archive
+	static const uint8_t end_blocks[TAR_BLOCK_SIZE * 2] = {};
+	file->seek(dst);
+	ERR_FAIL_COND_V(!file->store_buffer(end_blocks, TAR_BLOCK_SIZE * 2), ERR_FILE_CANT_WRITE);
+	file->flush();
+	return file->resize(dst + TAR_BLOCK_SIZE * 2);
+}
+
+Error ArchiveWriter::_finish_tar_zstd() {
+	// removed entries become zstd skippable frames, so decompressing yields a tar without them
+	for (const Entry *entry : _get_appended_entries()) {
+		if (!entry->dead) {
+			continue;
+		}
+		uint64_t end = _get_entry_end(entry);
+		for (uint64_t pos = entry->offset; pos < end;) {
+			uint64_t len = MIN(end - pos, ZSTD_SKIPPABLE_MAX);
+			if (end - pos - len > 0 && end - pos - len < 8) {
+				len -= 8; // leave room for the next frame's header
+			}
+			file->seek(pos);
+			ERR_FAIL_COND_V(!file->store_32(ZSTD_SKIPPABLE_MAGIC) || !file->store_32((uint32_t)(len - 8)), ERR_FILE_CANT_WRITE);
+			pos += len;
+		}
+	}
+	static const uint8_t end_blocks[TAR_BLOCK_SIZE * 2] = {};
+	Vector<uint8_t> frame;
+	Error err = compress_zstd_frame(end_blocks, TAR_BLOCK_SIZE * 2, frame);
+	ERR_FAIL_COND_V(err != OK, err);
+	file->seek(write_pos);
+	ERR_FAIL_COND_V(!file->store_buffer(frame.ptr(), frame.size()), ERR_FILE_CANT_WRITE);
+	return OK;
+}
+
+Error ArchiveWriter::close() {
+	if (file.is_null()) {
+		return OK;
+	}
+	{
+		MutexLock lock(mutex);
+		closing = true;
+		queue_cv.notify_all();
+	}
+	appender->wait_to_finish();
+	memdelete(appender);
+	appender = nullptr;
+	Error err = failed ? ERR_FILE_CANT_WRITE : OK;
+	if (err == OK) {
+		switch (format) {
+			case FORMAT_ZIP:
+				err = _write_zip_central_directory();
+				break;
+			case FORMAT_TAR:
+				err = _finish_tar();
+				break;
+			case FORMAT_TAR_ZSTD:
+				err = _finish_tar_zstd();
+				break;
+			default:
+				break;
+		}
+	}
+	file->close();
+	file.unref();
+	for (Entry *entry : entries) {
+		memdelete(entry);
+	}
+	entries.clear();
+	queue.clear();
+	pending_bytes = 0;
+	return err;
+}
+
+ArchiveWriter::~ArchiveWriter() {
+	close();
+}
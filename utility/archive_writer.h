@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/io/file_access.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/vector.h"
+
+#include <atomic>
+
+// Writes a .zip, .tar or .tar.zst archive from many threads at once.
+// Entries are compressed on the thread that adds them; a single appender thread writes them into the
+// archive in completion order. Until the archive is closed, entries can be read back, renamed and removed.
+namespace gdre {
+
+class ArchiveWriter {
+public:
+	enum Format {
+		FORMAT_NONE,
+		FORMAT_ZIP,
+		FORMAT_TAR,
+		FORMAT_TAR_ZSTD,
+	};
+
+	static constexpr uint32_t INVALID_ID = UINT32_MAX;
+	// add_entry blocks while more than this many compressed bytes are waiting for the appender.
+	static constexpr uint64_t MAX_PENDING_BYTES = 256 * 1024 * 1024;
+	// .tar.zst entries are split into independent zstd frames of at most this many bytes, so that
+	// the compressor's int sizes are never exceeded and entries can be read back one frame at a time.
+	static constexpr uint64_t ZSTD_FRAME_SIZE = 16 * 1024 * 1024;
+
+private:
+	struct Entry {
+		String name;
+		Vector<uint8_t> stored; // the bytes that follow the entry's header; dropped once appended
+		LocalVector<uint32_t> frames; // .tar.zst: compressed size of each data frame
+		uint64_t size = 0;
+		uint64_t stored_size = 0;
+		uint64_t modified_time = 0;
+		uint64_t offset = 0; // start of the entry's header(s) in the archive
+		uint64_t data_offset = 0;
+		uint32_t crc = 0;
+		uint16_t method = 0;
+		bool taken = false; // picked up by the appender; the name can no longer change in place
+		bool appended = false;
+		bool dead = false;
+	};
+
+	struct EntryOffsetComparator {
+		bool operator()(const Entry *p_a, const Entry *p_b) const { return p_a->offset < p_b->offset; }
+	};
+
+	Format format = FORMAT_NONE;
+	int compression_level = 6;
+	Ref<FileAccess> file;
+	Thread *appender = nullptr;
+	BinaryMutex mutex;
+	// the appender writes and read_entry reads through the same handle
+	BinaryMutex file_mutex;
+	ConditionVariable queue_cv;
+	ConditionVariable space_cv;
+	LocalVector<Entry *> entries;
+	LocalVector<uint32_t> queue;
+	uint64_t pending_bytes = 0;
+	uint64_t write_pos = 0;
+	bool closing = false;
+	std::atomic<bool> failed = false;
+
+	static void _appender_func(void *p_userdata);
+	void _appender_loop();
+	Error _compress_entry(const Vector<uint8_t> &p_data, Entry *p_entry) const;
+	Error _queue_entry(Entry *p_entry, uint32_t *r_id);
+	Error _read_stored(uint64_t p_offset, uint64_t p_size, Vector<uint8_t> &r_data);
+	LocalVector<Entry *> _get_appended_entries() const;
+	uint64_t _get_entry_end(const Entry *p_entry) const;
+	Vector<uint8_t> _make_header(const Entry *p_entry) const;
+	Vector<uint8_t> _make_tar_header(const CharString &p_name, uint64_t p_size, uint64_t p_modified_time, char p_type) const;
+	Error _write_zip_central_directory();
+	Error _finish_tar();
+	Error _finish_tar_zstd();
+
+public:
+	static Format get_format_for_path(const String &p_path);
+	static bool is_archive_path(const String &p_path) { return get_format_for_path(p_path) != FORMAT_NONE; }
+
+	Error open(const String &p_path, int p_compression_level = 6);
+	bool is_open() const { return file.is_valid(); }
+	Format get_format() const { return format; }
+
+	// All of the below are thread-safe. Names are paths inside the archive, using '/' separators.
+	Error add_entry(const String &p_name, const Vector<uint8_t> &p_data, uint64_t p_modified_time = 0, uint32_t *r_id = nullptr);
+	Error read_entry(uint32_t p_id, Vector<uint8_t> &r_data);
+	// Entries already written keep their compressed bytes; they are copied under the new name without recompressing.
+	Error rename_entry(uint32_t p_id, const String &p_new_name, uint32_t *r_new_id);
+	void remove_entry(uint32_t p_id);
+
+	Error close();
+
+	ArchiveWriter() {}
+	~ArchiveWriter();
+};
+
+} // namespace gdre
@@ -2,6 +2,8 @@
 #include "bytecode/bytecode_base.h"
 #include "compat/variant_decoder_compat.h"
 #include "external/tga/tga.h"
+#include "utility/file_access_archive.h"
+#include "utility/gdre_config.h"
 #include "utility/glob.h"
 
 #include "core/error/error_list.h"
@@ -11,9 +13,27 @@
 #include "core/io/http_client.h"
 #include "core/io/image.h"
 #include "core/io/missing_resource.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "modules/zip/zip_reader.h"
 #include "vtracer/vtracer.h"
 
+#if defined(WINDOWS_ENABLED)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(UNIX_ENABLED)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 Vector<String> gdre::get_recursive_dir_list(const String &p_dir, const Vector<String> &wildcards, const bool absolute, const String &rel) {
 	Vector<String> ret;
 	Error err;
@@ -346,7 +366,7 @@ Error gdre::save_image_as_tga(const String &p_path, const Ref<Image> &p_img) {
 	return OK;
 }
 
-Error gdre::save_image_as_svg(const String &p_path, const Ref<Image> &p_img) {
+Error gdre::save_image_as_svg_vtracer(const String &p_path, const Ref<Image> &p_img) {
 	VTracerConfig config;
 	vtracer_set_default_config(&config);
 	// this config converts the raster image to a vector image with a box for each pixel
@@ -386,6 +406,195 @@ Error gdre::save_image_as_svg(const String &p_path, const Ref<Image> &p_img) {
 	return OK;
 }
 
+namespace {
+// UTF-8 output buffer for the SVG writer; avoids building intermediate Strings for every element
+class SVGBuffer {
+	LocalVector<uint8_t> data;
+
+public:
+	_FORCE_INLINE_ void put(const char *p_str) {
+		while (*p_str) {
+			data.push_back(*p_str++);
+		}
+	}
+
+	_FORCE_INLINE_ void put_uint(uint32_t p_val) {
+		char buf[10];
+		int len = 0;
+		do {
+			buf[len++] = '0' + (p_val % 10);
+			p_val /= 10;
+		} while (p_val);
+		while (len) {
+			data.push_back(buf[--len]);
+		}
+	}
+
+	_FORCE_INLINE_ void put_hex_byte(uint8_t p_val) {
+		static constexpr char hex[] = "0123456789abcdef";
+		data.push_back(hex[p_val >> 4]);
+		data.push_back(hex[p_val & 0xF]);
+	}
+
+	void put_fill(uint32_t p_rgba) {
+		put(" fill=\"#");
+		put_hex_byte(p_rgba >> 24);
+		put_hex_byte(p_rgba >> 16);
+		put_hex_byte(p_rgba >> 8);
+		put("\"");
+		uint8_t alpha = p_rgba & 0xFF;
+		if (alpha != 255) {
+			// 3 decimal places are enough to round-trip 8-bit alpha
+			uint32_t milli = (alpha * 1000 + 127) / 255;
+			put(" fill-opacity=\"0.");
+			data.push_back('0' + (milli / 100) % 10);
+			data.push_back('0' + (milli / 10) % 10);
+			data.push_back('0' + milli % 10);
+			put("\"");
+		}
+	}
+
+	const uint8_t *ptr() const { return data.ptr(); }
+	uint32_t size() const { return data.size(); }
+	void reserve(uint32_t p_size) { data.reserve(p_size); }
+};
+
+struct SVGRect {
+	uint32_t x = 0;
+	uint32_t y = 0;
+	uint32_t w = 0;
+	uint32_t h = 0;
+};
+} //namespace
+
+// Merges horizontal runs of identical pixels, extends them downwards into rectangles while the run
+// below has the same span and color, and then emits one element per color.
+Error gdre::save_image_as_svg_pixel_runs(const String &p_path, const Ref<Image> &p_img) {
+	Ref<Image> img = p_img->duplicate();
+	GDRE_ERR_DECOMPRESS_OR_FAIL(img);
+	if (img->get_format() != Image::FORMAT_RGBA8) {
+		img->convert(Image::FORMAT_RGBA8);
+	}
+	const uint32_t width = img->get_width();
+	const uint32_t height = img->get_height();
+	const Vector<uint8_t> data = img->get_data();
+	const uint8_t *pixels = data.ptr();
+	auto get_rgba = [&](uint32_t x, uint32_t y) -> uint32_t {
+		const uint8_t *p = pixels + (y * width + x) * 4;
+		return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+	};
+
+	// rectangles still open at the previous row, ordered by x; disjoint, so they can be matched with a two-pointer walk
+	struct OpenRect {
+		SVGRect rect;
+		uint32_t color;
+	};
+	LocalVector<OpenRect> open;
+	LocalVector<OpenRect> next_open;
+	HashMap<uint32_t, LocalVector<SVGRect>> rects_by_color;
+	LocalVector<uint32_t> color_order;
+	auto close_rect = [&](const OpenRect &r) {
+		auto it = rects_by_color.find(r.color);
+		if (it == rects_by_color.end()) {
+			color_order.push_back(r.color);
+			it = rects_by_color.insert(r.color, LocalVector<SVGRect>());
+		}
+		it->value.push_back(r.rect);
+	};
+
+	for (uint32_t y = 0; y < height; y++) {
+		next_open.clear();
+		uint32_t open_idx = 0;
+		uint32_t x = 0;
+		while (x < width) {
+			uint32_t color = get_rgba(x, y);
+			uint32_t run_end = x + 1;
+			while (run_end < width && get_rgba(run_end, y) == color) {
+				run_end++;
+			}
+			// fully transparent pixels are left out
+			if ((color & 0xFF) != 0) {
+				while (open_idx < open.size() && open[open_idx].rect.x < x) {
+					close_rect(open[open_idx++]);
+				}
+				if (open_idx < open.size() && open[open_idx].rect.x == x && open[open_idx].rect.w == run_end - x && open[open_idx].color == color) {
+					OpenRect r = open[open_idx++];
+					r.rect.h++;
+					next_open.push_back(r);
+				} else {
+					next_open.push_back({ { x, y, run_end - x, 1 }, color });
+				}
+			}
+			x = run_end;
+		}
+		while (open_idx < open.size()) {
+			close_rect(open[open_idx++]);
+		}
+		SWAP(open, next_open);
+	}
+	for (const OpenRect &r : open) {
+		close_rect(r);
+	}
+
+	SVGBuffer buf;
+	buf.reserve(1024 + rects_by_color.size() * 48);
+	buf.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+	buf.put_uint(width);
+	buf.put("\" height=\"");
+	buf.put_uint(height);
+	buf.put("\" viewBox=\"0 0 ");
+	buf.put_uint(width);
+	buf.put(" ");
+	buf.put_uint(height);
+	buf.put("\" shape-rendering=\"crispEdges\">\n");
+	for (uint32_t color : color_order) {
+		const LocalVector<SVGRect> &rects = rects_by_color[color];
+		if (rects.size() == 1) {
+			const SVGRect &r = rects[0];
+			buf.put("<rect x=\"");
+			buf.put_uint(r.x);
+			buf.put("\" y=\"");
+			buf.put_uint(r.y);
+			buf.put("\" width=\"");
+			buf.put_uint(r.w);
+			buf.put("\" height=\"");
+			buf.put_uint(r.h);
+			buf.put("\"");
+		} else {
+			buf.put("<path d=\"");
+			for (const SVGRect &r : rects) {
+				buf.put("M");
+				buf.put_uint(r.x);
+				buf.put(" ");
+				buf.put_uint(r.y);
+				buf.put("h");
+				buf.put_uint(r.w);
+				buf.put("v");
+				buf.put_uint(r.h);
+				buf.put("h-");
+				buf.put_uint(r.w);
+				buf.put("z");
+			}
+			buf.put("\"");
+		}
+		buf.put_fill(color);
+		buf.put("/>\n");
+	}
+	buf.put("</svg>\n");
+
+	Ref<FileAccess> fa = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(fa.is_null(), ERR_FILE_CANT_WRITE, "Failed to open file for writing: " + p_path);
+	fa->store_buffer(buf.ptr(), buf.size());
+	return OK;
+}
+
+Error gdre::save_image_as_svg(const String &p_path, const Ref<Image> &p_img) {
+	if (GDREConfig::get_singleton()->get_setting("Exporter/Image/use_vtracer_for_svg", false)) {
+		return save_image_as_svg_vtracer(p_path, p_img);
+	}
+	return save_image_as_svg_pixel_runs(p_path, p_img);
+}
+
 void gdre::get_strings_from_variant(const Variant &p_var, Vector<String> &r_strings, const String &engine_version) {
 	if (p_var.get_type() == Variant::STRING || p_var.get_type() == Variant::STRING_NAME) {
 		r_strings.push_back(p_var);
@@ -440,31 +649,79 @@ void gdre::get_strings_from_variant(const Variant &p_var, Vector<String> &r_stri
 	}
 }
 
-Error gdre::unzip_file_to_dir(const String &zip_path, const String &output_dir) {
-	Ref<ZIPReader> zip;
-	zip.instantiate();
-
-	Error err = zip->open(zip_path);
-	if (err != OK) {
-		return err;
+namespace {
+struct UnzipTaskData {
+	String zip_path;
+	String output_dir;
+	String zip_subdir;
+	Vector<String> entries;
+	uint32_t bands = 1;
+	std::atomic<bool> failed = false;
+
+	void extract_band(uint32_t p_band, void *p_userdata) {
+		Ref<ZIPReader> zip;
+		zip.instantiate();
+		if (zip->open(zip_path) != OK) {
+			failed = true;
+			return;
+		}
+		for (int64_t i = p_band; i < entries.size(); i += bands) {
+			const String &file = entries[i];
+			auto data = zip->read_file(file, true);
+			if (data.size() == 0) {
+				continue;
+			}
+			String out_path = output_dir.path_join(file.trim_prefix(zip_subdir));
+			gdre::ensure_dir(out_path.get_base_dir());
+			Ref<FileAccess> fa = FileAccess::open(out_path, FileAccess::WRITE);
+			if (fa.is_null()) {
+				continue;
+			}
+			fa->store_buffer(data.ptr(), data.size());
+			fa->close();
+		}
+		zip->close();
 	}
-	auto files = zip->get_files();
-	for (int i = 0; i < files.size(); i++) {
-		auto file = files[i];
-		auto data = zip->read_file(file, true);
-		if (data.size() == 0) {
-			continue;
+};
+} // namespace
+
+Error gdre::unzip_file_to_dir(const String &zip_path, const String &output_dir, const String &p_zip_subdir) {
+	UnzipTaskData task;
+	// match whole path components only, so "addons/foo" doesn't also pick up "addons/foobar/"
+	String zip_subdir = p_zip_subdir;
+	if (!zip_subdir.is_empty() && !zip_subdir.ends_with("/")) {
+		zip_subdir += "/";
+	}
+	{
+		Ref<ZIPReader> zip;
+		zip.instantiate();
+		Error err = zip->open(zip_path);
+		if (err != OK) {
+			return err;
 		}
-		String out_path = output_dir.path_join(file);
-		ensure_dir(out_path.get_base_dir());
-		Ref<FileAccess> fa = FileAccess::open(out_path, FileAccess::WRITE);
-		if (fa.is_null()) {
-			continue;
+		for (const String &file : zip->get_files()) {
+			if (file.begins_with(zip_subdir) && !file.ends_with("/")) {
+				task.entries.push_back(file);
+			}
 		}
-		fa->store_buffer(data.ptr(), data.size());
-		fa->close();
+		zip->close();
 	}
-	return OK;
+	if (task.entries.is_empty()) {
+		return OK;
+	}
+	task.zip_path = zip_path;
+	task.output_dir = output_dir;
+	task.zip_subdir = zip_subdir;
+	constexpr uint32_t MIN_ENTRIES_PER_BAND = 16;
+	bool single_threaded = GDREConfig::get_singleton()->get_setting("force_single_threaded", false);
+	task.bands = single_threaded ? 1 : CLAMP((uint32_t)task.entries.size() / MIN_ENTRIES_PER_BAND, 1u, (uint32_t)OS::get_singleton()->get_processor_count());
+	if (task.bands == 1) {
+		task.extract_band(0, nullptr);
+	} else {
+		WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(&task, &UnzipTaskData::extract_band, (void *)nullptr, task.bands, -1, true, SNAME("gdre::unzip_file_to_dir"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	}
+	return task.failed ? ERR_FILE_CANT_OPEN : OK;
 }
 
 String gdre::get_md5(const String &dir, bool ignore_code_signature) {
@@ -1056,6 +1313,87 @@ bool gdre::store_var_compat(Ref<FileAccess> f, const Variant &p_var, int ver_maj
 	return f->store_32(uint32_t(len)) && f->store_buffer(buff);
 }
 
+Error gdre::copy_file_contents(Ref<FileAccess> p_src, Ref<FileAccess> p_dst, uint64_t p_length) {
+	ERR_FAIL_COND_V(p_src.is_null() || p_dst.is_null(), ERR_INVALID_PARAMETER);
+	constexpr uint64_t CHUNK_SIZE = 1024 * 1024;
+	Vector<uint8_t> buf;
+	buf.resize(MIN(p_length, CHUNK_SIZE));
+	uint8_t *w = buf.ptrw();
+	while (p_length > 0) {
+		uint64_t to_read = MIN(p_length, CHUNK_SIZE);
+		uint64_t read = p_src->get_buffer(w, to_read);
+		if (read == 0) {
+			break;
+		}
+		ERR_FAIL_COND_V(!p_dst->store_buffer(w, read), ERR_FILE_CANT_WRITE);
+		p_length -= read;
+	}
+	return OK;
+}
+
+Error gdre::write_file_get_modified_time(const String &p_path, const Vector<uint8_t> &p_data, uint64_t &r_modified_time) {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	String rel;
+	if (output && output->get_rel_path(p_path, rel)) {
+		return output->write_file(rel, p_data, &r_modified_time);
+	}
+#if defined(WINDOWS_ENABLED) || defined(UNIX_ENABLED)
+	if (p_path.is_absolute_path() && !p_path.begins_with("res://") && !p_path.begins_with("user://")) {
+		const uint8_t *ptr = p_data.ptr();
+		uint64_t remaining = p_data.size();
+#if defined(WINDOWS_ENABLED)
+		HANDLE handle = CreateFileW((LPCWSTR)p_path.replace("/", "\\").utf16().get_data(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		ERR_FAIL_COND_V_MSG(handle == INVALID_HANDLE_VALUE, ERR_FILE_CANT_OPEN, "Failed to open " + p_path + " for writing");
+		while (remaining > 0) {
+			DWORD written = 0;
+			if (!WriteFile(handle, ptr, (DWORD)MIN(remaining, (uint64_t)(1 << 30)), &written, nullptr) || written == 0) {
+				CloseHandle(handle);
+				ERR_FAIL_V_MSG(ERR_FILE_CANT_WRITE, "Failed to write " + p_path);
+			}
+			ptr += written;
+			remaining -= written;
+		}
+		// NTFS may bump the write time again when the handle is closed; setting it explicitly on the handle stops that
+		FILETIME ft;
+		GetSystemTimeAsFileTime(&ft);
+		bool set = SetFileTime(handle, nullptr, nullptr, &ft);
+		CloseHandle(handle);
+		ERR_FAIL_COND_V_MSG(!set, ERR_FILE_CANT_WRITE, "Failed to set the modification time of " + p_path);
+		uint64_t ticks = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+		r_modified_time = (ticks - 116444736000000000ULL) / 10000000ULL;
+#else
+		CharString path_utf8 = p_path.utf8();
+		int fd = ::open(path_utf8.get_data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		ERR_FAIL_COND_V_MSG(fd < 0, ERR_FILE_CANT_OPEN, "Failed to open " + p_path + " for writing");
+		while (remaining > 0) {
+			ssize_t written = ::write(fd, ptr, MIN(remaining, (uint64_t)(1 << 30)));
+			if (written <= 0) {
+				::close(fd);
+				ERR_FAIL_V_MSG(ERR_FILE_CANT_WRITE, "Failed to write " + p_path);
+			}
+			ptr += written;
+			remaining -= written;
+		}
+		struct stat st;
+		bool got_stat = ::fstat(fd, &st) == 0;
+		::close(fd);
+		ERR_FAIL_COND_V_MSG(!got_stat, ERR_FILE_CANT_READ, "Failed to stat " + p_path);
+		r_modified_time = st.st_mtime;
+#endif
+		return OK;
+	}
+#endif
+	// virtual res:// and user:// paths have no native handle; these are stat'ed after the write instead
+	Error err;
+	{
+		Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(f.is_null(), err, "Failed to open " + p_path + " for writing");
+		ERR_FAIL_COND_V_MSG(!f->store_buffer(p_data), ERR_FILE_CANT_WRITE, "Failed to write " + p_path);
+	}
+	r_modified_time = FileAccess::get_modified_time(p_path);
+	return OK;
+}
+
 void GDRECommon::_bind_methods() {
 	//	ClassDB::bind_static_method("GLTFCamera", D_METHOD("from_node", "camera_node"), &GLTFCamera::from_node);
 
@@ -1064,6 +1402,8 @@ void GDRECommon::_bind_methods() {
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("ensure_dir", "dir"), &gdre::ensure_dir);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("save_image_as_tga", "path", "img"), &gdre::save_image_as_tga);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("save_image_as_svg", "path", "img"), &gdre::save_image_as_svg);
+	ClassDB::bind_static_method("GDRECommon", D_METHOD("save_image_as_svg_pixel_runs", "path", "img"), &gdre::save_image_as_svg_pixel_runs);
+	ClassDB::bind_static_method("GDRECommon", D_METHOD("save_image_as_svg_vtracer", "path", "img"), &gdre::save_image_as_svg_vtracer);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("save_image_as_bmp", "path", "img"), &gdre::save_image_as_bmp);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("get_md5", "dir", "ignore_code_signature"), &gdre::get_md5);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("get_md5_for_dir", "dir", "ignore_code_signature"), &gdre::get_md5_for_dir);
@@ -1075,4 +1415,7 @@ void GDRECommon::_bind_methods() {
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("split_multichar", "str", "splitters", "allow_empty", "maxsplit"), &gdre::_split_multichar);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("rsplit_multichar", "str", "splitters", "allow_empty", "maxsplit"), &gdre::_rsplit_multichar);
 	ClassDB::bind_static_method("GDRECommon", D_METHOD("copy_dir", "src", "dst"), &gdre::copy_dir);
+	ClassDB::bind_static_method("GDRECommon", D_METHOD("is_archive_path", "path"), &ArchiveOutput::is_archive_path);
+	ClassDB::bind_static_method("GDRECommon", D_METHOD("begin_archive_output", "archive_path", "compression_level"), &ArchiveOutput::begin, DEFVAL(6));
+	ClassDB::bind_static_method("GDRECommon", D_METHOD("end_archive_output"), &ArchiveOutput::end);
 }
\ No newline at end of file
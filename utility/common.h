@@ -18,17 +18,25 @@ Error ensure_dir(const String &dst_dir);
 Error save_image_as_bmp(const String &p_path, const Ref<Image> &p_img);
 Error save_image_as_tga(const String &p_path, const Ref<Image> &p_img);
 Error save_image_as_svg(const String &p_path, const Ref<Image> &p_img);
+Error save_image_as_svg_pixel_runs(const String &p_path, const Ref<Image> &p_img);
+Error save_image_as_svg_vtracer(const String &p_path, const Ref<Image> &p_img);
 void get_strings_from_variant(const Variant &p_var, Vector<String> &r_strings, const String &engine_version = "");
 Error decompress_image(const Ref<Image> &img);
 String get_md5(const String &dir, bool ignore_code_signature = false);
 String get_md5_for_dir(const String &dir, bool ignore_code_signature = false);
-Error unzip_file_to_dir(const String &zip_path, const String &output_dir);
+// Extracts the entries under p_zip_subdir (all entries if empty) straight into output_dir, with p_zip_subdir stripped
+// from their paths. Entries are inflated in parallel, each worker using its own reader.
+Error unzip_file_to_dir(const String &zip_path, const String &output_dir, const String &p_zip_subdir = "");
 Error wget_sync(const String &p_url, Vector<uint8_t> &response, int retries = 5, float *p_progress = nullptr, bool *p_cancelled = nullptr);
 Error download_file_sync(const String &url, const String &output_path, float *p_progress = nullptr, bool *p_cancelled = nullptr);
 Error rimraf(const String &dir);
 bool dir_is_empty(const String &dir);
 Error touch_file(const String &path);
 bool store_var_compat(Ref<FileAccess> f, const Variant &p_var, int ver_major, bool p_full_objects = false);
+// Copies up to p_length bytes from the current position of p_src to p_dst in large chunks.
+Error copy_file_contents(Ref<FileAccess> p_src, Ref<FileAccess> p_dst, uint64_t p_length);
+// Writes p_data to p_path and returns the file's modification time, read from the write handle before it is closed.
+Error write_file_get_modified_time(const String &p_path, const Vector<uint8_t> &p_data, uint64_t &r_modified_time);
 
 String num_scientific(double p_num);
 String num_scientific(float p_num);
@@ -0,0 +1,204 @@
+#include "export_report_model.h"
+
+#include "core/templates/sort_array.h"
+#include "utility/import_exporter.h"
+
+ExportReportModel::Section *ExportReportModel::_get_section(const String &p_section) {
+	const uint32_t *idx = section_indices.getptr(p_section);
+	return idx ? &sections[*idx] : nullptr;
+}
+
+const ExportReportModel::Section *ExportReportModel::_get_section(const String &p_section) const {
+	const uint32_t *idx = section_indices.getptr(p_section);
+	return idx ? &sections[*idx] : nullptr;
+}
+
+ExportReportModel::Section *ExportReportModel::_get_or_add_section(const String &p_section) {
+	Section *section = _get_section(p_section);
+	if (!section) {
+		section_indices[p_section] = sections.size();
+		sections.push_back(Section());
+		section = &sections[sections.size() - 1];
+		section->name = p_section;
+	}
+	return section;
+}
+
+void ExportReportModel::add_entry(const String &p_section, const String &p_path, const String &p_target, const String &p_importer) {
+	Section *section = _get_or_add_section(p_section);
+	section->entries.push_back({ p_path, p_target, p_importer });
+	section->importer_counts[p_importer]++;
+	const Entry &entry = section->entries[section->entries.size() - 1];
+	if (_entry_matches(*section, entry)) {
+		section->view.push_back(section->entries.size() - 1);
+		section->sorted = false;
+	}
+}
+
+void ExportReportModel::set_report(const Ref<ImportExporterReport> &p_report) {
+	clear();
+	ERR_FAIL_COND(p_report.is_null());
+	auto add_reports = [&](const String &p_section, const Vector<Ref<ExportReport>> &p_reports) {
+		for (const Ref<ExportReport> &rep : p_reports) {
+			if (rep.is_null()) {
+				continue;
+			}
+			Ref<ImportInfo> iinfo = rep->get_import_info();
+			add_entry(p_section, iinfo.is_valid() ? iinfo->get_path() : rep->get_source_path(), rep->get_new_source_path(), iinfo.is_valid() ? iinfo->get_importer() : String());
+		}
+	};
+	auto add_paths = [&](const String &p_section, const Vector<String> &p_paths) {
+		for (const String &path : p_paths) {
+			add_entry(p_section, path, path);
+		}
+	};
+	// same order as get_report_sections
+	add_reports("failed", p_report->failed);
+	add_reports("not_converted", p_report->not_converted);
+	add_paths("failed_scripts", p_report->failed_scripts);
+	add_reports("lossy_imports", p_report->lossy_imports);
+	add_reports("failed_rewrite_md", p_report->failed_rewrite_md);
+	add_paths("failed_plugin_cfg_create", p_report->failed_plugin_cfg_create);
+	add_paths("failed_gdnative_copy", p_report->failed_gdnative_copy);
+	add_reports("failed_rewrite_md5", p_report->failed_rewrite_md5);
+	add_reports("rewrote_metadata", p_report->rewrote_metadata);
+	// get_report_sections always has these two, even when empty
+	_get_or_add_section("success");
+	add_reports("success", p_report->success);
+	_get_or_add_section("decompiled_scripts");
+	add_paths("decompiled_scripts", p_report->decompiled_scripts);
+}
+
+void ExportReportModel::clear() {
+	sections.clear();
+	section_indices.clear();
+}
+
+PackedStringArray ExportReportModel::get_sections() const {
+	PackedStringArray ret;
+	for (const Section &section : sections) {
+		ret.push_back(section.name);
+	}
+	return ret;
+}
+
+int64_t ExportReportModel::get_section_size(const String &p_section) const {
+	const Section *section = _get_section(p_section);
+	return section ? section->entries.size() : 0;
+}
+
+Dictionary ExportReportModel::get_importer_counts(const String &p_section) const {
+	Dictionary ret;
+	const Section *section = _get_section(p_section);
+	if (section) {
+		for (const auto &E : section->importer_counts) {
+			ret[E.key] = E.value;
+		}
+	}
+	return ret;
+}
+
+bool ExportReportModel::_entry_matches(const Section &p_section, const Entry &p_entry) {
+	if (!p_section.importer_filter.is_empty() && p_entry.importer != p_section.importer_filter) {
+		return false;
+	}
+	if (p_section.filter.is_empty()) {
+		return true;
+	}
+	return p_entry.path.containsn(p_section.filter) || p_entry.target.containsn(p_section.filter);
+}
+
+void ExportReportModel::_rebuild_view(Section &p_section) {
+	p_section.view.clear();
+	for (uint32_t i = 0; i < p_section.entries.size(); i++) {
+		if (_entry_matches(p_section, p_section.entries[i])) {
+			p_section.view.push_back(i);
+		}
+	}
+	p_section.sorted = false;
+}
+
+void ExportReportModel::set_filter(const String &p_section, const String &p_text, const String &p_importer) {
+	Section *section = _get_section(p_section);
+	ERR_FAIL_NULL_MSG(section, "No such report section: " + p_section);
+	if (section->filter == p_text && section->importer_filter == p_importer) {
+		return;
+	}
+	section->filter = p_text;
+	section->importer_filter = p_importer;
+	_rebuild_view(*section);
+	if (section->sort_requested) {
+		sort(p_section, section->sort_column, section->sort_ascending);
+	}
+}
+
+struct ExportReportEntryComparator {
+	const String *keys = nullptr;
+	bool ascending = true;
+
+	_FORCE_INLINE_ bool operator()(uint32_t a, uint32_t b) const {
+		// ties keep entry order, so the sort is stable
+		int cmp = keys[a].naturalnocasecmp_to(keys[b]);
+		if (cmp == 0) {
+			return a < b;
+		}
+		return ascending ? cmp < 0 : cmp > 0;
+	}
+};
+
+void ExportReportModel::sort(const String &p_section, Column p_column, bool p_ascending) {
+	Section *section = _get_section(p_section);
+	ERR_FAIL_NULL_MSG(section, "No such report section: " + p_section);
+	if (section->sorted && section->sort_column == p_column && section->sort_ascending == p_ascending) {
+		return;
+	}
+	section->sort_column = p_column;
+	section->sort_ascending = p_ascending;
+	section->sort_requested = true;
+	// gather the sort keys once so the comparator doesn't chase through the entries
+	LocalVector<String> keys;
+	keys.resize(section->entries.size());
+	for (uint32_t idx : section->view) {
+		const Entry &entry = section->entries[idx];
+		keys[idx] = p_column == COLUMN_PATH ? entry.path : (p_column == COLUMN_IMPORTER ? entry.importer : entry.target);
+	}
+	SortArray<uint32_t, ExportReportEntryComparator> sorter;
+	sorter.compare.keys = keys.ptr();
+	sorter.compare.ascending = p_ascending;
+	sorter.sort(section->view.ptr(), section->view.size());
+	section->sorted = true;
+}
+
+int64_t ExportReportModel::get_view_size(const String &p_section) const {
+	const Section *section = _get_section(p_section);
+	return section ? section->view.size() : 0;
+}
+
+Array ExportReportModel::get_rows(const String &p_section, int64_t p_from, int64_t p_count) const {
+	Array ret;
+	const Section *section = _get_section(p_section);
+	ERR_FAIL_NULL_V_MSG(section, ret, "No such report section: " + p_section);
+	int64_t end = MIN(p_from + p_count, (int64_t)section->view.size());
+	for (int64_t i = MAX(p_from, 0); i < end; i++) {
+		const Entry &entry = section->entries[section->view[i]];
+		ret.push_back(PackedStringArray({ entry.target, entry.path, entry.importer }));
+	}
+	return ret;
+}
+
+void ExportReportModel::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_entry", "section", "path", "target", "importer"), &ExportReportModel::add_entry, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("set_report", "report"), &ExportReportModel::set_report);
+	ClassDB::bind_method(D_METHOD("clear"), &ExportReportModel::clear);
+	ClassDB::bind_method(D_METHOD("get_sections"), &ExportReportModel::get_sections);
+	ClassDB::bind_method(D_METHOD("get_section_size", "section"), &ExportReportModel::get_section_size);
+	ClassDB::bind_method(D_METHOD("get_importer_counts", "section"), &ExportReportModel::get_importer_counts);
+	ClassDB::bind_method(D_METHOD("set_filter", "section", "text", "importer"), &ExportReportModel::set_filter, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("sort", "section", "column", "ascending"), &ExportReportModel::sort, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_view_size", "section"), &ExportReportModel::get_view_size);
+	ClassDB::bind_method(D_METHOD("get_rows", "section", "from", "count"), &ExportReportModel::get_rows);
+
+	BIND_ENUM_CONSTANT(COLUMN_TARGET);
+	BIND_ENUM_CONSTANT(COLUMN_PATH);
+	BIND_ENUM_CONSTANT(COLUMN_IMPORTER);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+class ImportExporterReport;
+
+// Flat, indexed view of an ImportExporterReport for the GUI.
+// Entries are grouped by report section (the same keys as ImportExporterReport::get_report_sections) and
+// counted per importer as they are added. Filtering and sorting only rebuild a per-section index, so the GUI
+// can fetch just the rows it is about to show instead of creating a TreeItem for every exported file.
+class ExportReportModel : public RefCounted {
+	GDCLASS(ExportReportModel, RefCounted);
+
+public:
+	enum Column {
+		COLUMN_TARGET,
+		COLUMN_PATH,
+		COLUMN_IMPORTER,
+	};
+
+private:
+	struct Entry {
+		String path;
+		String target;
+		String importer;
+	};
+
+	struct Section {
+		String name;
+		LocalVector<Entry> entries;
+		HashMap<String, int64_t> importer_counts;
+		// indexes into entries that pass the filter, in display order
+		LocalVector<uint32_t> view;
+		String filter;
+		String importer_filter;
+		Column sort_column = COLUMN_TARGET;
+		bool sort_ascending = true;
+		bool sort_requested = false;
+		bool sorted = false;
+	};
+
+	LocalVector<Section> sections;
+	HashMap<String, uint32_t> section_indices;
+
+	Section *_get_section(const String &p_section);
+	const Section *_get_section(const String &p_section) const;
+	Section *_get_or_add_section(const String &p_section);
+	static bool _entry_matches(const Section &p_section, const Entry &p_entry);
+	static void _rebuild_view(Section &p_section);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void add_entry(const String &p_section, const String &p_path, const String &p_target, const String &p_importer = "");
+	void set_report(const Ref<ImportExporterReport> &p_report);
+	void clear();
+
+	PackedStringArray get_sections() const;
+	int64_t get_section_size(const String &p_section) const;
+	Dictionary get_importer_counts(const String &p_section) const;
+
+	// Case-insensitive substring match on the path or the target; an empty p_importer matches every importer.
+	void set_filter(const String &p_section, const String &p_text, const String &p_importer = "");
+	void sort(const String &p_section, Column p_column, bool p_ascending = true);
+
+	int64_t get_view_size(const String &p_section) const;
+	// Each row is [target, path, importer].
+	Array get_rows(const String &p_section, int64_t p_from, int64_t p_count) const;
+};
+
+VARIANT_ENUM_CAST(ExportReportModel::Column);
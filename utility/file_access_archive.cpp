@@ -0,0 +1,459 @@
+#include "file_access_archive.h"
+
+#include "core/os/os.h"
+#include "utility/file_access_gdre.h"
+
+ArchiveOutput *ArchiveOutput::singleton = nullptr;
+
+String ArchiveOutput::normalize_path(const String &p_path) {
+	String path = p_path.replace("\\", "/");
+	// FileAccessWindows::fix_path adds the long path prefix
+	if (path.begins_with("//?/")) {
+		path = path.substr(4);
+	}
+	return path.simplify_path();
+}
+
+Error ArchiveOutput::begin(const String &p_archive_path, int p_compression_level) {
+	ERR_FAIL_COND_V_MSG(singleton, ERR_ALREADY_IN_USE, "Already writing to archive " + singleton->root);
+	String path = normalize_path(p_archive_path);
+	ERR_FAIL_COND_V_MSG(path.is_relative_path(), ERR_INVALID_PARAMETER, "Archive path must be absolute: " + p_archive_path);
+	ArchiveOutput *output = memnew(ArchiveOutput);
+	Error err = output->writer.open(path, p_compression_level);
+	if (err != OK) {
+		memdelete(output);
+		return err;
+	}
+	output->root = path;
+	output->root_prefix = path + "/";
+	output->dirs.insert("", HashSet<String>());
+	err = GDREPackedData::set_archive_output_access(true);
+	if (err != OK) {
+		output->writer.close();
+		memdelete(output);
+		ERR_FAIL_V_MSG(err, "Archive output is not supported on this platform");
+	}
+	singleton = output;
+	return OK;
+}
+
+Error ArchiveOutput::end() {
+	ERR_FAIL_COND_V_MSG(!singleton, ERR_UNCONFIGURED, "Not writing to an archive");
+	ArchiveOutput *output = singleton;
+	GDREPackedData::set_archive_output_access(false);
+	singleton = nullptr;
+	Error err = output->writer.close();
+	String root = output->root;
+	memdelete(output);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to finish writing " + root);
+	return OK;
+}
+
+bool ArchiveOutput::get_rel_path(const String &p_path, String &r_rel, bool p_include_root) const {
+	String path = normalize_path(p_path);
+	if (path == root) {
+		r_rel = "";
+		return p_include_root;
+	}
+	if (!path.begins_with(root_prefix)) {
+		return false;
+	}
+	r_rel = path.substr(root_prefix.length());
+	return true;
+}
+
+void ArchiveOutput::_add_dir(const String &p_rel) {
+	if (dirs.has(p_rel)) {
+		return;
+	}
+	dirs.insert(p_rel, HashSet<String>());
+	String parent = p_rel.get_base_dir();
+	_add_dir(parent);
+	dirs[parent].insert(p_rel.get_file());
+}
+
+void ArchiveOutput::_remove_child(const String &p_rel) {
+	HashSet<String> *children = dirs.getptr(p_rel.get_base_dir());
+	if (children) {
+		children->erase(p_rel.get_file());
+	}
+}
+
+bool ArchiveOutput::file_exists(const String &p_rel) const {
+	MutexLock lock(mutex);
+	return files.has(p_rel);
+}
+
+bool ArchiveOutput::dir_exists(const String &p_rel) const {
+	MutexLock lock(mutex);
+	return dirs.has(p_rel);
+}
+
+uint64_t ArchiveOutput::get_modified_time(const String &p_rel) const {
+	MutexLock lock(mutex);
+	const FileEntry *entry = files.getptr(p_rel);
+	return entry ? entry->modified_time : 0;
+}
+
+int64_t ArchiveOutput::get_file_size(const String &p_rel) const {
+	MutexLock lock(mutex);
+	const FileEntry *entry = files.getptr(p_rel);
+	return entry ? (int64_t)entry->size : -1;
+}
+
+void ArchiveOutput::list_dir(const String &p_rel, List<String> &r_files, List<String> &r_dirs) const {
+	MutexLock lock(mutex);
+	const HashSet<String> *children = dirs.getptr(p_rel);
+	if (!children) {
+		return;
+	}
+	for (const String &name : *children) {
+		if (dirs.has(p_rel.path_join(name))) {
+			r_dirs.push_back(name);
+		} else {
+			r_files.push_back(name);
+		}
+	}
+}
+
+Error ArchiveOutput::read_file(const String &p_rel, Vector<uint8_t> &r_data) {
+	uint32_t id;
+	{
+		MutexLock lock(mutex);
+		const FileEntry *entry = files.getptr(p_rel);
+		if (!entry) {
+			return ERR_FILE_NOT_FOUND;
+		}
+		id = entry->id;
+	}
+	return writer.read_entry(id, r_data);
+}
+
+Error ArchiveOutput::write_file(const String &p_rel, const Vector<uint8_t> &p_data, uint64_t *r_modified_time) {
+	ERR_FAIL_COND_V(p_rel.is_empty(), ERR_INVALID_PARAMETER);
+	uint64_t modified_time = (uint64_t)OS::get_singleton()->get_unix_time();
+	uint32_t id;
+	// compress outside of the lock
+	Error err = writer.add_entry(p_rel, p_data, modified_time, &id);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to write " + root.path_join(p_rel));
+
+	MutexLock lock(mutex);
+	if (dirs.has(p_rel)) {
+		writer.remove_entry(id);
+		ERR_FAIL_V_MSG(ERR_ALREADY_EXISTS, "Can't write a file over a directory: " + root.path_join(p_rel));
+	}
+	FileEntry *existing = files.getptr(p_rel);
+	if (existing) {
+		writer.remove_entry(existing->id);
+	}
+	FileEntry &entry = files[p_rel];
+	entry.id = id;
+	entry.size = p_data.size();
+	entry.modified_time = modified_time;
+	String parent = p_rel.get_base_dir();
+	_add_dir(parent);
+	dirs[parent].insert(p_rel.get_file());
+	if (r_modified_time) {
+		*r_modified_time = modified_time;
+	}
+	return OK;
+}
+
+Error ArchiveOutput::make_dir(const String &p_rel) {
+	MutexLock lock(mutex);
+	if (dirs.has(p_rel) || files.has(p_rel)) {
+		return ERR_ALREADY_EXISTS;
+	}
+	_add_dir(p_rel);
+	return OK;
+}
+
+Error ArchiveOutput::remove(const String &p_rel) {
+	MutexLock lock(mutex);
+	const FileEntry *entry = files.getptr(p_rel);
+	if (entry) {
+		writer.remove_entry(entry->id);
+		files.erase(p_rel);
+		_remove_child(p_rel);
+		return OK;
+	}
+	const HashSet<String> *children = dirs.getptr(p_rel);
+	if (!children) {
+		return ERR_FILE_NOT_FOUND;
+	}
+	if (p_rel.is_empty() || !children->is_empty()) {
+		return FAILED;
+	}
+	dirs.erase(p_rel);
+	_remove_child(p_rel);
+	return OK;
+}
+
+Error ArchiveOutput::_rename_file(const String &p_from, const String &p_to) {
+	if (dirs.has(p_to)) {
+		return ERR_ALREADY_EXISTS;
+	}
+	FileEntry entry = files[p_from];
+	uint32_t new_id;
+	Error err = writer.rename_entry(entry.id, p_to, &new_id);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to rename " + root.path_join(p_from));
+	// like the OS rename, the target is replaced
+	const FileEntry *existing = files.getptr(p_to);
+	if (existing) {
+		writer.remove_entry(existing->id);
+	}
+	entry.id = new_id;
+	files.erase(p_from);
+	_remove_child(p_from);
+	files[p_to] = entry;
+	String parent = p_to.get_base_dir();
+	_add_dir(parent);
+	dirs[parent].insert(p_to.get_file());
+	return OK;
+}
+
+Error ArchiveOutput::rename(const String &p_from, const String &p_to) {
+	MutexLock lock(mutex);
+	if (p_from == p_to) {
+		return OK;
+	}
+	if (files.has(p_from)) {
+		return _rename_file(p_from, p_to);
+	}
+	if (p_from.is_empty() || !dirs.has(p_from)) {
+		return ERR_FILE_NOT_FOUND;
+	}
+	if (p_to.is_empty() || p_to.begins_with(p_from + "/") || dirs.has(p_to) || files.has(p_to)) {
+		return ERR_ALREADY_EXISTS;
+	}
+	String prefix = p_from + "/";
+	Vector<String> moved_dirs;
+	for (const KeyValue<String, HashSet<String>> &E : dirs) {
+		if (E.key == p_from || E.key.begins_with(prefix)) {
+			moved_dirs.push_back(E.key);
+		}
+	}
+	Vector<String> moved_files;
+	for (const KeyValue<String, FileEntry> &E : files) {
+		if (E.key.begins_with(prefix)) {
+			moved_files.push_back(E.key);
+		}
+	}
+	for (const String &dir : moved_dirs) {
+		HashSet<String> children = dirs[dir];
+		dirs.erase(dir);
+		dirs.insert(p_to + dir.substr(p_from.length()), children);
+	}
+	_remove_child(p_from);
+	String parent = p_to.get_base_dir();
+	_add_dir(parent);
+	dirs[parent].insert(p_to.get_file());
+	for (const String &file : moved_files) {
+		Error err = _rename_file(file, p_to + file.substr(p_from.length()));
+		ERR_FAIL_COND_V(err != OK, err);
+	}
+	return OK;
+}
+
+FileAccessArchive::~FileAccessArchive() {
+	close();
+}
+
+Error FileAccessArchive::open_archive_file(const String &p_path, const String &p_rel, int p_mode_flags) {
+	close();
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	ERR_FAIL_NULL_V(output, ERR_UNCONFIGURED);
+	path = p_path;
+	rel_path = p_rel;
+	mode = p_mode_flags & FileAccess::WRITE_READ;
+	data = Vector<uint8_t>();
+	pos = 0;
+	eof = false;
+	error = OK;
+	dirty = false;
+	loaded = false;
+	if (mode == FileAccess::WRITE || mode == FileAccess::WRITE_READ) {
+		if (output->dir_exists(p_rel)) {
+			return ERR_FILE_CANT_OPEN;
+		}
+		// truncated; committed on close even if nothing is written
+		loaded = true;
+		dirty = true;
+		length = 0;
+	} else {
+		int64_t size = output->get_file_size(p_rel);
+		if (size < 0) {
+			return ERR_FILE_NOT_FOUND;
+		}
+		length = size;
+	}
+	is_opened = true;
+	return OK;
+}
+
+Error FileAccessArchive::open_internal(const String &p_path, int p_mode_flags) {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	String rel;
+	if (!output || !output->get_rel_path(p_path, rel)) {
+		return ERR_FILE_NOT_FOUND;
+	}
+	return open_archive_file(output->get_root().path_join(rel), rel, p_mode_flags);
+}
+
+bool FileAccessArchive::_ensure_loaded() const {
+	if (loaded) {
+		return true;
+	}
+	// reading only decompresses when the contents are actually needed, not for exists/size checks
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	Error err = output ? output->read_file(rel_path, data) : ERR_UNCONFIGURED;
+	if (err != OK) {
+		error = err;
+		ERR_FAIL_V_MSG(false, "Failed to read " + path + " back from the archive");
+	}
+	loaded = true;
+	return true;
+}
+
+void FileAccessArchive::_commit() {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	dirty = false;
+	if (!output || output->write_file(rel_path, data) != OK) {
+		error = ERR_FILE_CANT_WRITE;
+		ERR_FAIL_MSG("Failed to write " + path + " to the archive");
+	}
+}
+
+bool FileAccessArchive::is_open() const {
+	return is_opened;
+}
+
+void FileAccessArchive::seek(uint64_t p_position) {
+	ERR_FAIL_COND_MSG(!is_opened, "File must be opened before use.");
+	pos = p_position;
+	eof = false;
+}
+
+void FileAccessArchive::seek_end(int64_t p_position) {
+	ERR_FAIL_COND_MSG(!is_opened, "File must be opened before use.");
+	seek(length + p_position);
+}
+
+uint64_t FileAccessArchive::get_position() const {
+	return pos;
+}
+
+uint64_t FileAccessArchive::get_length() const {
+	return length;
+}
+
+bool FileAccessArchive::eof_reached() const {
+	return eof;
+}
+
+uint8_t FileAccessArchive::get_8() const {
+	uint8_t byte = 0;
+	get_buffer(&byte, 1);
+	return byte;
+}
+
+uint64_t FileAccessArchive::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
+	ERR_FAIL_COND_V_MSG(!is_opened, 0, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(!(mode & FileAccess::READ), 0, "File not opened for reading: " + path);
+	if (!_ensure_loaded()) {
+		return 0;
+	}
+	uint64_t available = pos < length ? length - pos : 0;
+	uint64_t read = MIN(p_length, available);
+	if (read < p_length) {
+		eof = true;
+	}
+	if (read > 0) {
+		memcpy(p_dst, data.ptr() + pos, read);
+	}
+	pos += read;
+	return read;
+}
+
+Error FileAccessArchive::get_error() const {
+	if (error != OK) {
+		return error;
+	}
+	return eof ? ERR_FILE_EOF : OK;
+}
+
+Error FileAccessArchive::resize(int64_t p_length) {
+	ERR_FAIL_COND_V_MSG(!is_opened, ERR_FILE_CLOSED, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(!(mode & FileAccess::WRITE), ERR_FILE_CANT_WRITE, "File not opened for writing: " + path);
+	if (!_ensure_loaded()) {
+		return error;
+	}
+	data.resize(p_length);
+	length = p_length;
+	dirty = true;
+	return OK;
+}
+
+void FileAccessArchive::flush() {
+	if (is_opened && dirty) {
+		_commit();
+	}
+}
+
+bool FileAccessArchive::store_8(uint8_t p_dest) {
+	return store_buffer(&p_dest, 1);
+}
+
+bool FileAccessArchive::store_buffer(const uint8_t *p_src, uint64_t p_length) {
+	ERR_FAIL_COND_V_MSG(!is_opened, false, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(!(mode & FileAccess::WRITE), false, "File not opened for writing: " + path);
+	if (!_ensure_loaded()) {
+		return false;
+	}
+	if (pos + p_length > length) {
+		data.resize(pos + p_length);
+		length = pos + p_length;
+	}
+	if (p_length > 0) {
+		memcpy(data.ptrw() + pos, p_src, p_length);
+	}
+	pos += p_length;
+	dirty = true;
+	return true;
+}
+
+bool FileAccessArchive::file_exists(const String &p_name) {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	String rel;
+	return output && output->get_rel_path(p_name, rel) && output->file_exists(rel);
+}
+
+void FileAccessArchive::close() {
+	if (!is_opened) {
+		return;
+	}
+	if (dirty) {
+		_commit();
+	}
+	is_opened = false;
+	loaded = false;
+	data = Vector<uint8_t>();
+}
+
+int64_t FileAccessArchive::_get_size(const String &p_file) {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	String rel;
+	if (!output || !output->get_rel_path(p_file, rel)) {
+		return -1;
+	}
+	return output->get_file_size(rel);
+}
+
+uint64_t FileAccessArchive::_get_modified_time(const String &p_file) {
+	ArchiveOutput *output = ArchiveOutput::get_singleton();
+	String rel;
+	if (!output || !output->get_rel_path(p_file, rel)) {
+		return 0;
+	}
+	return output->get_modified_time(rel);
+}
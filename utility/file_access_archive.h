@@ -0,0 +1,446 @@
+#pragma once
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/list.h"
+#include "utility/archive_writer.h"
+
+// Recovery output that goes into a .zip/.tar/.tar.zst instead of a directory.
+// While it's active, every path under the archive's own path (e.g. "/out/game.zip/project.godot") is a
+// virtual file inside the archive. The redirecting FileAccess/DirAccess classes below send those paths here,
+// so the dumper and exporters write through it without knowing; every other path goes to the OS.
+class ArchiveOutput {
+	struct FileEntry {
+		uint32_t id = gdre::ArchiveWriter::INVALID_ID;
+		uint64_t size = 0;
+		uint64_t modified_time = 0;
+	};
+
+	// only changed by begin()/end(), which run while nothing else is using the filesystem
+	static ArchiveOutput *singleton;
+
+	String root;
+	String root_prefix;
+	gdre::ArchiveWriter writer;
+	mutable BinaryMutex mutex;
+	HashMap<String, FileEntry> files;
+	// relative dir ("" is the archive root) -> names of the files and dirs directly in it
+	HashMap<String, HashSet<String>> dirs;
+
+	void _add_dir(const String &p_rel);
+	void _remove_child(const String &p_rel);
+	Error _rename_file(const String &p_from, const String &p_to);
+
+	ArchiveOutput() {}
+
+public:
+	static Error begin(const String &p_archive_path, int p_compression_level = 6);
+	static Error end();
+	static ArchiveOutput *get_singleton() { return singleton; }
+	static bool is_active() { return singleton != nullptr; }
+	static bool is_archive_path(const String &p_path) { return gdre::ArchiveWriter::is_archive_path(p_path); }
+	static String normalize_path(const String &p_path);
+
+	String get_root() const { return root; }
+	// p_path must be absolute. The archive root itself is only accepted when p_include_root is set (i.e. as a directory).
+	bool get_rel_path(const String &p_path, String &r_rel, bool p_include_root = false) const;
+
+	bool file_exists(const String &p_rel) const;
+	bool dir_exists(const String &p_rel) const;
+	uint64_t get_modified_time(const String &p_rel) const;
+	int64_t get_file_size(const String &p_rel) const;
+	void list_dir(const String &p_rel, List<String> &r_files, List<String> &r_dirs) const;
+
+	Error read_file(const String &p_rel, Vector<uint8_t> &r_data);
+	// Compresses on the calling thread. r_modified_time is the time recorded for the entry.
+	Error write_file(const String &p_rel, const Vector<uint8_t> &p_data, uint64_t *r_modified_time = nullptr);
+	Error make_dir(const String &p_rel);
+	Error remove(const String &p_rel);
+	Error rename(const String &p_from, const String &p_to);
+};
+
+// An in-memory file inside the archive. The contents are read from the archive on first access and handed back
+// to it, compressed on the writing thread, on flush() or close().
+class FileAccessArchive : public FileAccess {
+	GDSOFTCLASS(FileAccessArchive, FileAccess);
+	String path;
+	String rel_path;
+	mutable Vector<uint8_t> data;
+	mutable bool loaded = false;
+	mutable bool eof = false;
+	mutable Error error = OK;
+	uint64_t length = 0;
+	mutable uint64_t pos = 0;
+	int mode = 0;
+	bool is_opened = false;
+	bool dirty = false;
+
+	bool _ensure_loaded() const;
+	void _commit();
+
+public:
+	Error open_archive_file(const String &p_path, const String &p_rel, int p_mode_flags);
+
+	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
+	virtual bool is_open() const override;
+	virtual String get_path() const override { return path; }
+	virtual String get_path_absolute() const override { return path; }
+
+	virtual void seek(uint64_t p_position) override;
+	virtual void seek_end(int64_t p_position = 0) override;
+	virtual uint64_t get_position() const override;
+	virtual uint64_t get_length() const override;
+
+	virtual bool eof_reached() const override;
+
+	virtual uint8_t get_8() const override;
+	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+
+	virtual Error get_error() const override;
+
+	virtual Error resize(int64_t p_length) override;
+	virtual void flush() override;
+	virtual bool store_8(uint8_t p_dest) override;
+	virtual bool store_buffer(const uint8_t *p_src, uint64_t p_length) override;
+
+	virtual bool file_exists(const String &p_name) override;
+
+	virtual void close() override;
+	virtual uint64_t _get_access_time(const String &p_file) override { return _get_modified_time(p_file); }
+	virtual int64_t _get_size(const String &p_file) override;
+
+	virtual uint64_t _get_modified_time(const String &p_file) override;
+	virtual BitField<FileAccess::UnixPermissionFlags> _get_unix_permissions(const String &p_file) override { return 0644; }
+	virtual Error _set_unix_permissions(const String &p_file, BitField<FileAccess::UnixPermissionFlags> p_permissions) override { return OK; }
+
+	virtual bool _get_hidden_attribute(const String &p_file) override { return false; }
+	virtual Error _set_hidden_attribute(const String &p_file, bool p_hidden) override { return ERR_UNAVAILABLE; }
+	virtual bool _get_read_only_attribute(const String &p_file) override { return false; }
+	virtual Error _set_read_only_attribute(const String &p_file, bool p_ro) override { return ERR_UNAVAILABLE; }
+
+	FileAccessArchive() {}
+	~FileAccessArchive();
+};
+
+// Wraps an OS FileAccess; paths inside an active ArchiveOutput are opened as FileAccessArchive instead.
+template <class T>
+class FileAccessArchiveRedirect : public T {
+	static_assert(std::is_base_of<FileAccess, T>::value, "T must derive from FileAccess");
+
+	Ref<FileAccessArchive> archive_file;
+
+	bool _get_archive_rel_path(const String &p_path, String &r_rel) const {
+		ArchiveOutput *output = ArchiveOutput::get_singleton();
+		return output && output->get_rel_path(this->fix_path(p_path), r_rel);
+	}
+
+protected:
+	virtual uint64_t _get_modified_time(const String &p_file) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return ArchiveOutput::get_singleton()->get_modified_time(rel);
+		}
+		return T::_get_modified_time(p_file);
+	}
+	virtual uint64_t _get_access_time(const String &p_file) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return ArchiveOutput::get_singleton()->get_modified_time(rel);
+		}
+		return T::_get_access_time(p_file);
+	}
+	virtual int64_t _get_size(const String &p_file) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return ArchiveOutput::get_singleton()->get_file_size(rel);
+		}
+		return T::_get_size(p_file);
+	}
+	virtual BitField<FileAccess::UnixPermissionFlags> _get_unix_permissions(const String &p_file) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return 0644;
+		}
+		return T::_get_unix_permissions(p_file);
+	}
+	virtual Error _set_unix_permissions(const String &p_file, BitField<FileAccess::UnixPermissionFlags> p_permissions) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return OK; // archive entries are always written as rw-r--r--
+		}
+		return T::_set_unix_permissions(p_file, p_permissions);
+	}
+	virtual bool _get_hidden_attribute(const String &p_file) override {
+		String rel;
+		return !_get_archive_rel_path(p_file, rel) && T::_get_hidden_attribute(p_file);
+	}
+	virtual Error _set_hidden_attribute(const String &p_file, bool p_hidden) override {
+		String rel;
+		return _get_archive_rel_path(p_file, rel) ? ERR_UNAVAILABLE : T::_set_hidden_attribute(p_file, p_hidden);
+	}
+	virtual bool _get_read_only_attribute(const String &p_file) override {
+		String rel;
+		return !_get_archive_rel_path(p_file, rel) && T::_get_read_only_attribute(p_file);
+	}
+	virtual Error _set_read_only_attribute(const String &p_file, bool p_ro) override {
+		String rel;
+		return _get_archive_rel_path(p_file, rel) ? ERR_UNAVAILABLE : T::_set_read_only_attribute(p_file, p_ro);
+	}
+
+public:
+	virtual Error open_internal(const String &p_path, int p_mode_flags) override {
+		archive_file.unref();
+		String rel;
+		if (_get_archive_rel_path(p_path, rel)) {
+			archive_file.instantiate();
+			return archive_file->open_archive_file(ArchiveOutput::get_singleton()->get_root().path_join(rel), rel, p_mode_flags);
+		}
+		return T::open_internal(p_path, p_mode_flags);
+	}
+	virtual bool is_open() const override { return archive_file.is_valid() ? archive_file->is_open() : T::is_open(); }
+	virtual String get_path() const override { return archive_file.is_valid() ? archive_file->get_path() : T::get_path(); }
+	virtual String get_path_absolute() const override { return archive_file.is_valid() ? archive_file->get_path_absolute() : T::get_path_absolute(); }
+
+	virtual void seek(uint64_t p_position) override {
+		if (archive_file.is_valid()) {
+			archive_file->seek(p_position);
+			return;
+		}
+		T::seek(p_position);
+	}
+	virtual void seek_end(int64_t p_position = 0) override {
+		if (archive_file.is_valid()) {
+			archive_file->seek_end(p_position);
+			return;
+		}
+		T::seek_end(p_position);
+	}
+	virtual uint64_t get_position() const override { return archive_file.is_valid() ? archive_file->get_position() : T::get_position(); }
+	virtual uint64_t get_length() const override { return archive_file.is_valid() ? archive_file->get_length() : T::get_length(); }
+
+	virtual bool eof_reached() const override { return archive_file.is_valid() ? archive_file->eof_reached() : T::eof_reached(); }
+
+	virtual uint8_t get_8() const override {
+		if (archive_file.is_valid()) {
+			uint8_t byte = 0;
+			archive_file->get_buffer(&byte, 1);
+			return byte;
+		}
+		return T::get_8();
+	}
+	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override {
+		return archive_file.is_valid() ? archive_file->get_buffer(p_dst, p_length) : T::get_buffer(p_dst, p_length);
+	}
+
+	virtual Error get_error() const override { return archive_file.is_valid() ? archive_file->get_error() : T::get_error(); }
+
+	virtual Error resize(int64_t p_length) override { return archive_file.is_valid() ? archive_file->resize(p_length) : T::resize(p_length); }
+	virtual void flush() override {
+		if (archive_file.is_valid()) {
+			archive_file->flush();
+			return;
+		}
+		T::flush();
+	}
+	virtual bool store_8(uint8_t p_dest) override { return archive_file.is_valid() ? archive_file->store_buffer(&p_dest, 1) : T::store_8(p_dest); }
+	virtual bool store_buffer(const uint8_t *p_src, uint64_t p_length) override {
+		return archive_file.is_valid() ? archive_file->store_buffer(p_src, p_length) : T::store_buffer(p_src, p_length);
+	}
+
+	virtual bool file_exists(const String &p_name) override {
+		String rel;
+		if (_get_archive_rel_path(p_name, rel)) {
+			return ArchiveOutput::get_singleton()->file_exists(rel);
+		}
+		return T::file_exists(p_name);
+	}
+
+	virtual void close() override {
+		if (archive_file.is_valid()) {
+			archive_file->close();
+			return;
+		}
+		T::close();
+	}
+};
+
+// Wraps an OS DirAccess; paths inside an active ArchiveOutput are served from the archive's virtual tree.
+template <class T>
+class DirAccessArchiveRedirect : public T {
+	static_assert(std::is_base_of<DirAccess, T>::value, "T must derive from DirAccess");
+
+	bool in_archive = false;
+	String archive_dir;
+	bool listing_archive = false;
+	List<String> list_dirs;
+	List<String> list_files;
+	bool cdir = false;
+
+	String _get_abs_path(const String &p_path) const {
+		String path = this->fix_path(p_path);
+		if (path.is_relative_path()) {
+			path = get_current_dir().path_join(path);
+		}
+		return path;
+	}
+
+	bool _get_archive_rel_path(const String &p_path, String &r_rel) const {
+		ArchiveOutput *output = ArchiveOutput::get_singleton();
+		return output && output->get_rel_path(_get_abs_path(p_path), r_rel, true);
+	}
+
+	// the OS implementation can't resolve relative paths against a virtual current dir
+	String _get_os_path(const String &p_path) const {
+		return in_archive ? _get_abs_path(p_path).simplify_path() : p_path;
+	}
+
+public:
+	virtual Error list_dir_begin() override {
+		listing_archive = in_archive && ArchiveOutput::is_active();
+		if (!listing_archive) {
+			return T::list_dir_begin();
+		}
+		list_dirs.clear();
+		list_files.clear();
+		ArchiveOutput::get_singleton()->list_dir(archive_dir, list_files, list_dirs);
+		return OK;
+	}
+	virtual String get_next() override {
+		if (!listing_archive) {
+			return T::get_next();
+		}
+		if (list_dirs.size()) {
+			cdir = true;
+			String d = list_dirs.front()->get();
+			list_dirs.pop_front();
+			return d;
+		} else if (list_files.size()) {
+			cdir = false;
+			String f = list_files.front()->get();
+			list_files.pop_front();
+			return f;
+		}
+		return String();
+	}
+	virtual bool current_is_dir() const override { return listing_archive ? cdir : T::current_is_dir(); }
+	virtual bool current_is_hidden() const override { return listing_archive ? false : T::current_is_hidden(); }
+	virtual void list_dir_end() override {
+		if (!listing_archive) {
+			T::list_dir_end();
+			return;
+		}
+		listing_archive = false;
+		list_dirs.clear();
+		list_files.clear();
+	}
+
+	virtual Error change_dir(String p_dir) override {
+		String rel;
+		if (_get_archive_rel_path(p_dir, rel)) {
+			if (!ArchiveOutput::get_singleton()->dir_exists(rel)) {
+				return ERR_INVALID_PARAMETER;
+			}
+			in_archive = true;
+			archive_dir = rel;
+			return OK;
+		}
+		if (!in_archive) {
+			return T::change_dir(p_dir);
+		}
+		Error err = T::change_dir(_get_os_path(p_dir));
+		if (err == OK) {
+			in_archive = false;
+		}
+		return err;
+	}
+	virtual String get_current_dir(bool p_include_drive = true) const override {
+		if (in_archive && ArchiveOutput::is_active()) {
+			return ArchiveOutput::get_singleton()->get_root().path_join(archive_dir);
+		}
+		return T::get_current_dir(p_include_drive);
+	}
+
+	virtual Error make_dir(String p_dir) override {
+		String rel;
+		if (_get_archive_rel_path(p_dir, rel)) {
+			return ArchiveOutput::get_singleton()->make_dir(rel);
+		}
+		return T::make_dir(_get_os_path(p_dir));
+	}
+
+	virtual bool file_exists(String p_file) override {
+		String rel;
+		if (_get_archive_rel_path(p_file, rel)) {
+			return ArchiveOutput::get_singleton()->file_exists(rel);
+		}
+		return T::file_exists(_get_os_path(p_file));
+	}
+	virtual bool dir_exists(String p_dir) override {
+		String rel;
+		if (_get_archive_rel_path(p_dir, rel)) {
+			return ArchiveOutput::get_singleton()->dir_exists(rel);
+		}
+		return T::dir_exists(_get_os_path(p_dir));
+	}
+	virtual bool is_readable(String p_dir) override {
+		String rel;
+		return _get_archive_rel_path(p_dir, rel) || T::is_readable(_get_os_path(p_dir));
+	}
+	virtual bool is_writable(String p_dir) override {
+		String rel;
+		return _get_archive_rel_path(p_dir, rel) || T::is_writable(_get_os_path(p_dir));
+	}
+
+	virtual Error copy(const String &p_from, const String &p_to, int p_chmod_flags = -1) override {
+		String rel;
+		if (_get_archive_rel_path(p_from, rel) || _get_archive_rel_path(p_to, rel)) {
+			// the generic copy goes through FileAccess, which is redirected as well
+			return DirAccess::copy(_get_abs_path(p_from), _get_abs_path(p_to), p_chmod_flags);
+		}
+		return T::copy(_get_os_path(p_from), _get_os_path(p_to), p_chmod_flags);
+	}
+
+	virtual Error rename(String p_path, String p_new_path) override {
+		String from_rel;
+		String to_rel;
+		bool from_archive = _get_archive_rel_path(p_path, from_rel);
+		bool to_archive = _get_archive_rel_path(p_new_path, to_rel);
+		if (from_archive && to_archive) {
+			return ArchiveOutput::get_singleton()->rename(from_rel, to_rel);
+		}
+		if (!from_archive && !to_archive) {
+			return T::rename(_get_os_path(p_path), _get_os_path(p_new_path));
+		}
+		// moving a file into or out of the archive
+		Error err = copy(p_path, p_new_path);
+		ERR_FAIL_COND_V(err != OK, err);
+		return remove(p_path);
+	}
+	virtual Error remove(String p_path) override {
+		String rel;
+		if (_get_archive_rel_path(p_path, rel)) {
+			return ArchiveOutput::get_singleton()->remove(rel);
+		}
+		return T::remove(_get_os_path(p_path));
+	}
+
+	virtual bool is_link(String p_file) override {
+		String rel;
+		return !_get_archive_rel_path(p_file, rel) && T::is_link(_get_os_path(p_file));
+	}
+	virtual String read_link(String p_file) override {
+		String rel;
+		return _get_archive_rel_path(p_file, rel) ? p_file : T::read_link(_get_os_path(p_file));
+	}
+	virtual Error create_link(String p_source, String p_target) override {
+		String rel;
+		if (_get_archive_rel_path(p_target, rel)) {
+			// links can't be stored; copy the target's contents instead
+			return copy(p_source, p_target);
+		}
+		return T::create_link(_get_os_path(p_source), _get_os_path(p_target));
+	}
+};
@@ -3,12 +3,15 @@
 //
 
 #include "file_access_gdre.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "file_access_apk.h"
+#include "file_access_archive.h"
 #include "gdre_packed_source.h"
 #include "gdre_settings.h"
 #include "packed_file_info.h"
 #include "utility/common.h"
+#include "utility/gdre_config.h"
 
 bool DirSource::try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
 	if (!DirAccess::exists(p_path)) {
@@ -28,8 +31,11 @@ bool DirSource::try_open_pack(const String &p_path, bool p_replace_files, uint64
 	pckinfo.instantiate();
 	pckinfo->init(p_path, Ref<GodotVer>(memnew(GodotVer)), 1, 0, 0, pa.size(), GDRESettings::PackInfo::DIR);
 	GDRESettings::get_singleton()->add_pack_info(pckinfo);
+	GDREPackedData::get_singleton()->reserve_files(pa.size());
 	for (auto &path : pa) {
-		GDREPackedData::get_singleton()->add_path(p_path, path, 1, 0, MD5_EMPTY, this, p_replace_files, false, false);
+		// The folder is snapshotted once: existence and listing queries are answered from the table afterwards,
+		// the same as for a PCK. Sizes aren't part of the directory walk, so each is stat'ed on its first query.
+		GDREPackedData::get_singleton()->add_path(p_path, path, 1, GDREPackedData::SIZE_UNKNOWN, MD5_EMPTY, this, p_replace_files, false, false);
 	}
 	return true;
 }
@@ -45,55 +51,256 @@ Ref<FileAccess> DirSource::get_file(const String &p_path, PackedData::PackedFile
 	return nullptr;
 }
 
-Error GDREPackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
+thread_local GDREPackedData::StagedPack *GDREPackedData::staging = nullptr;
+thread_local GDREPackedData::FileTableListener *GDREPackedData::listener = nullptr;
+
+void GDREPackedData::_ensure_sources() {
 	if (sources.is_empty()) {
 		sources.push_back(memnew(GDREPackedSource));
 		sources.push_back(memnew(APKArchive));
 	}
+}
+
+Error GDREPackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
+	_ensure_sources();
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
 			// need to set the default file access to use our own
 			set_disabled(false);
 			// set_default_file_access();
+			if (listener) {
+				listener->files_merged();
+			}
 			return OK;
 		}
 	}
 	return ERR_FILE_UNRECOGNIZED;
 }
 
+void GDREPackedData::_read_staged_pack(uint32_t p_idx, StagedPack *p_packs) {
+	StagedPack &pack = p_packs[p_idx];
+	if (!pack.src) {
+		return;
+	}
+	staging = &pack;
+	pack.opened = pack.src->try_open_pack(pack.path, pack.replace_files, 0);
+	staging = nullptr;
+}
+
+void GDREPackedData::set_thread_listener(FileTableListener *p_listener) {
+	listener = p_listener;
+}
+
+bool GDREPackedData::stage_pack_info(const Ref<RefCounted> &p_pack_info) {
+	if (!staging) {
+		return false;
+	}
+	staging->pack_infos.push_back(p_pack_info);
+	return true;
+}
+
+Error GDREPackedData::add_packs(const Vector<String> &p_paths, bool p_replace_files, String *r_failed_path) {
+	_ensure_sources();
+	// Only PCKs and executables are read concurrently. The zip reader keeps its own table of entries that later
+	// archives override, so archives are still opened one at a time, in order, during the merge.
+	LocalVector<StagedPack> packs;
+	packs.resize(p_paths.size());
+	for (int i = 0; i < p_paths.size(); i++) {
+		packs[i].path = p_paths[i];
+		packs[i].replace_files = p_replace_files;
+		String ext = p_paths[i].get_extension().to_lower();
+		if (ext != "zip" && ext != "apk") {
+			packs[i].src = sources[0];
+		}
+	}
+	if (packs.size() <= 1 || GDREConfig::get_singleton()->get_setting("force_single_threaded", false)) {
+		for (uint32_t i = 0; i < packs.size(); i++) {
+			_read_staged_pack(i, packs.ptr());
+		}
+	} else {
+		WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(
+				this, &GDREPackedData::_read_staged_pack, packs.ptr(), packs.size(), -1, true, SNAME("GDREPackedData::add_packs"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	}
+
+	for (StagedPack &pack : packs) {
+		if (!pack.src) {
+			Error err = add_pack(pack.path, p_replace_files, 0);
+			if (err != OK) {
+				if (r_failed_path) {
+					*r_failed_path = pack.path;
+				}
+				return err;
+			}
+			continue;
+		}
+		if (!pack.opened) {
+			if (r_failed_path) {
+				*r_failed_path = pack.path;
+			}
+			return ERR_FILE_UNRECOGNIZED;
+		}
+		for (const Ref<RefCounted> &info : pack.pack_infos) {
+			GDRESettings::get_singleton()->add_pack_info(info);
+		}
+		reserve_files(pack.entries.size());
+		for (const StagedPack::Entry &entry : pack.entries) {
+			if (entry.removal) {
+				remove_path(entry.prepared.path);
+			} else {
+				_add_prepared_path(entry.pack, entry.prepared, entry.offset, entry.size, entry.md5, pack.src, pack.replace_files, entry.encrypted);
+			}
+		}
+		// drop the staged copies as we go, the merged table is the same size again
+		pack.entries.reset();
+		set_disabled(false);
+		if (listener) {
+			listener->files_merged();
+		}
+	}
+	return OK;
+}
+
 Error GDREPackedData::add_dir(const String &p_path, bool p_replace_files) {
 	if (dir_source.try_open_pack(p_path, p_replace_files, 0)) {
 		set_disabled(false);
+		if (listener) {
+			listener->files_merged();
+		}
 		return OK;
 	}
 	return ERR_FILE_CANT_OPEN;
 }
 
-void GDREPackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_pck_src) {
-	PackedData::PackedFile pf;
-	pf.encrypted = p_encrypted;
-	pf.pack = p_pkg_path;
-	pf.offset = p_ofs;
-	pf.size = p_size;
-	for (int i = 0; i < 16; i++) {
-		pf.md5[i] = p_md5[i];
-	}
-	pf.src = p_src;
-	Ref<PackedFileInfo> pf_info;
-	pf_info.instantiate();
-	String abs_path = p_path.is_relative_path() ? "res://" + p_path : p_path;
-	pf_info->init(abs_path, &pf);
+uint32_t GDREPackedData::_add_path_string(const String &p_path, uint32_t &r_len) {
+	CharString utf8 = p_path.utf8();
+	uint32_t ofs = path_arena.size();
+	r_len = utf8.length();
+	path_arena.resize(ofs + r_len);
+	memcpy(path_arena.ptr() + ofs, utf8.get_data(), r_len);
+	return ofs;
+}
+
+uint32_t GDREPackedData::_get_origin(const String &p_pack, PackSource *p_src) {
+	// files from the same pack are added consecutively, so this almost always hits the last entry
+	for (int64_t i = (int64_t)file_origins.size() - 1; i >= 0; i--) {
+		if (file_origins[i].src == p_src && file_origins[i].pack == p_pack) {
+			return i;
+		}
+	}
+	file_origins.push_back({ p_pack, p_src });
+	return file_origins.size() - 1;
+}
+
+String GDREPackedData::_get_record_path(const FileRecord &p_record) const {
+	return String::utf8(path_arena.ptr() + p_record.path_ofs, p_record.path_len);
+}
+
+String GDREPackedData::_get_record_raw_path(const FileRecord &p_record) const {
+	return String::utf8(path_arena.ptr() + p_record.raw_path_ofs, p_record.raw_path_len);
+}
+
+void GDREPackedData::_fill_packed_file(const FileRecord &p_record, PackedData::PackedFile &r_pf) const {
+	const FileOrigin &origin = file_origins[p_record.origin];
+	r_pf.pack = origin.pack;
+	r_pf.src = origin.src;
+	r_pf.offset = p_record.offset;
+	r_pf.size = p_record.size;
+	r_pf.encrypted = p_record.flags & FILE_ENCRYPTED;
+	memcpy(r_pf.md5, p_record.md5, 16);
+}
+
+Ref<PackedFileInfo> GDREPackedData::_make_file_info(uint32_t p_idx) const {
+	const FileRecord &p_record = file_records[p_idx];
+	Ref<PackedFileInfo> info;
+	info.instantiate();
+	info->record_index = p_idx;
+	info->table_generation = table_generation;
+	_fill_packed_file(p_record, info->pf);
+	info->path = _get_record_path(p_record);
+	info->raw_path = p_record.raw_path_ofs == p_record.path_ofs ? info->path : _get_record_raw_path(p_record);
+	info->malformed_path = p_record.flags & FILE_MALFORMED;
+	info->md5_passed = p_record.flags & FILE_MD5_PASSED;
+	info->size_pending = p_record.flags & FILE_SIZE_PENDING;
+	return info;
+}
+
+void GDREPackedData::reserve_files(uint32_t p_count) {
+	// counts come from untrusted headers; don't let a bogus one allocate gigabytes up front
+	p_count = MIN(p_count, 1U << 22);
+	if (staging) {
+		staging->entries.reserve(p_count);
+		return;
+	}
+	uint32_t needed = file_records.size() + p_count;
+	file_records.reserve(needed);
+	file_index.reserve(needed);
+	// rough guess at the average path length; the arena grows as needed anyway
+	path_arena.reserve(path_arena.size() + p_count * 48);
+}
 
+GDREPackedData::PreparedPath GDREPackedData::_prepare_path(const String &p_path, bool p_pck_src) {
+	PreparedPath ret;
+	ret.raw_path = p_path.is_relative_path() ? "res://" + p_path : p_path;
+	ret.fixed_path = PackedFileInfo::get_fixed_path(ret.raw_path, ret.malformed);
 	// Get the fixed path if this is from a PCK source
-	String path = p_pck_src ? pf_info->get_path() : p_path.simplify_path();
+	ret.path = p_pck_src ? ret.fixed_path : p_path.simplify_path();
+	ret.pmd5 = PathMD5(ret.path.trim_prefix("res://").md5_buffer());
+	return ret;
+}
+
+void GDREPackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_pck_src) {
+	if (staging) {
+		StagedPack::Entry entry;
+		entry.prepared = _prepare_path(p_path, p_pck_src);
+		entry.pack = p_pkg_path;
+		entry.offset = p_ofs;
+		entry.size = p_size;
+		memcpy(entry.md5, p_md5, 16);
+		entry.encrypted = p_encrypted;
+		staging->entries.push_back(entry);
+		return;
+	}
+	_add_prepared_path(p_pkg_path, _prepare_path(p_path, p_pck_src), p_ofs, p_size, p_md5, p_src, p_replace_files, p_encrypted);
+}
 
-	PathMD5 pmd5(path.trim_prefix("res://").md5_buffer());
+void GDREPackedData::_add_prepared_path(const String &p_pkg_path, const PreparedPath &p_prepared, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+	const String &raw_path = p_prepared.raw_path;
+	const String &fixed_path = p_prepared.fixed_path;
+	const String &path = p_prepared.path;
+	const PathMD5 &pmd5 = p_prepared.pmd5;
+	const bool malformed = p_prepared.malformed;
 
-	bool exists = files.has(pmd5);
+	HashMap<PathMD5, uint32_t, PathMD5>::Iterator E = file_index.find(pmd5);
+	bool exists = E != file_index.end();
 
 	if (!exists || p_replace_files) {
-		files[pmd5] = pf;
-		file_map[path] = pf_info;
+		ERR_FAIL_COND_MSG(path_arena.size() + (uint64_t)raw_path.length() * 8 > UINT32_MAX, "File table path storage is full.");
+		FileRecord record;
+		record.offset = p_ofs;
+		record.size = p_size == SIZE_UNKNOWN ? 0 : p_size;
+		memcpy(record.md5, p_md5, 16);
+		record.origin = _get_origin(p_pkg_path, p_src);
+		record.flags = (p_encrypted ? FILE_ENCRYPTED : 0) | (malformed ? FILE_MALFORMED : 0) | (p_size == SIZE_UNKNOWN ? FILE_SIZE_PENDING : 0);
+		record.path_ofs = _add_path_string(fixed_path, record.path_len);
+		if (raw_path == fixed_path) {
+			record.raw_path_ofs = record.path_ofs;
+			record.raw_path_len = record.path_len;
+		} else {
+			record.raw_path_ofs = _add_path_string(raw_path, record.raw_path_len);
+		}
+		uint32_t idx = exists ? E->value : file_records.size();
+		file_infos_valid = false;
+		if (exists) {
+			// replaced files keep their position in the table
+			file_records[idx] = record;
+		} else {
+			file_index.insert(pmd5, idx);
+			file_records.push_back(record);
+		}
+		if (listener) {
+			listener->file_added(_make_file_info(idx));
+		}
 	}
 
 	if (!exists) {
@@ -125,6 +332,22 @@ void GDREPackedData::add_path(const String &p_pkg_path, const String &p_path, ui
 	}
 }
 
+void GDREPackedData::set_md5_passed(uint32_t p_record, uint64_t p_generation, bool p_passed) {
+	if (p_generation != table_generation || p_record >= file_records.size()) {
+		return;
+	}
+	FileRecord &record = file_records[p_record];
+	if (p_passed) {
+		record.flags |= FILE_MD5_PASSED;
+	} else {
+		record.flags &= ~FILE_MD5_PASSED;
+	}
+	// infos made by the loader's listener aren't the cached ones
+	if (file_infos_valid && file_infos[p_record].is_valid()) {
+		file_infos[p_record]->md5_passed = p_passed;
+	}
+}
+
 void GDREPackedData::add_pack_source(PackSource *p_source) {
 	if (p_source != nullptr) {
 		sources.push_back(p_source);
@@ -134,12 +357,12 @@ void GDREPackedData::add_pack_source(PackSource *p_source) {
 uint8_t *GDREPackedData::get_file_hash(const String &p_path) {
 	String simplified_path = p_path.simplify_path().trim_prefix("res://");
 	PathMD5 pmd5(simplified_path.md5_buffer());
-	HashMap<PathMD5, PackedData::PackedFile, PathMD5>::Iterator E = files.find(pmd5);
+	HashMap<PathMD5, uint32_t, PathMD5>::Iterator E = file_index.find(pmd5);
 	if (!E) {
 		return nullptr;
 	}
 
-	return E->value.md5;
+	return file_records[E->value].md5;
 }
 
 HashSet<String> GDREPackedData::get_file_paths() const {
@@ -165,29 +388,76 @@ GDREPackedData::GDREPackedData() {
 	root = memnew(PackedDir);
 }
 
+bool GDREPackedData::_matches_filters(const String &p_path, const Vector<String> &p_filters) {
+	if (p_filters.is_empty()) {
+		return true;
+	}
+	String file = p_path.get_file();
+	for (int j = 0; j < p_filters.size(); j++) {
+		if (file.match(p_filters[j])) {
+			return true;
+		}
+	}
+	return false;
+}
+
 Vector<Ref<PackedFileInfo>> GDREPackedData::get_file_info_list(const Vector<String> &filters) {
+	if (!file_infos_valid) {
+		file_infos.clear();
+		file_infos.resize(file_records.size());
+		for (uint32_t i = 0; i < file_records.size(); i++) {
+			if (!(file_records[i].flags & FILE_REMOVED)) {
+				file_infos[i] = _make_file_info(i);
+			}
+		}
+		file_infos_valid = true;
+	}
 	Vector<Ref<PackedFileInfo>> ret;
-	bool no_filters = !filters.size();
-	for (auto E : file_map) {
-		if (no_filters) {
-			ret.push_back(E.value);
+	ret.resize(file_records.size() - removed_count);
+	int64_t count = 0;
+	for (const Ref<PackedFileInfo> &info : file_infos) {
+		if (info.is_null()) {
 			continue;
 		}
-		for (int j = 0; j < filters.size(); j++) {
-			if (E.key.get_file().match(filters[j])) {
-				ret.push_back(E.value);
-				break;
-			}
+		if (!filters.is_empty() && !_matches_filters(info->path, filters)) {
+			continue;
+		}
+		ret.write[count++] = info;
+	}
+	ret.resize(count);
+	return ret;
+}
+
+Vector<String> GDREPackedData::get_file_list(const Vector<String> &filters) {
+	Vector<String> ret;
+	ret.resize(file_records.size() - removed_count);
+	int64_t count = 0;
+	for (const FileRecord &record : file_records) {
+		if (record.flags & FILE_REMOVED) {
+			continue;
+		}
+		String path = _get_record_path(record);
+		if (_matches_filters(path, filters)) {
+			ret.write[count++] = path;
 		}
 	}
+	ret.resize(count);
 	return ret;
 }
 
 void GDREPackedData::remove_path(const String &p_path) {
+	if (staging) {
+		StagedPack::Entry entry;
+		entry.prepared.path = p_path;
+		entry.removal = true;
+		staging->entries.push_back(entry);
+		return;
+	}
 	String simplified_path = p_path.simplify_path().trim_prefix("res://");
 
 	PathMD5 pmd5(simplified_path.md5_buffer());
-	if (!files.has(pmd5)) {
+	HashMap<PathMD5, uint32_t, PathMD5>::Iterator E = file_index.find(pmd5);
+	if (!E) {
 		return;
 	}
 
@@ -206,13 +476,17 @@ void GDREPackedData::remove_path(const String &p_path) {
 		}
 	}
 
-	if (file_map.has(p_path.simplify_path())) {
-		file_map.erase(p_path.simplify_path());
-	}
+	// the record stays in place so indices remain stable; its path bytes are reclaimed on clear()
+	file_records[E->value].flags |= FILE_REMOVED;
+	removed_count++;
+	file_infos_valid = false;
 
 	cd->files.erase(simplified_path.get_file());
 
-	files.erase(pmd5);
+	if (listener) {
+		listener->file_removed(_get_record_path(file_records[E->value]));
+	}
+	file_index.remove(E);
 }
 
 void GDREPackedData::set_disabled(bool p_disabled) {
@@ -244,32 +518,43 @@ GDREPackedData *GDREPackedData::get_singleton() {
 int64_t GDREPackedData::get_file_size(const String &p_path) {
 	String simplified_path = p_path.simplify_path().trim_prefix("res://");
 	PathMD5 pmd5(simplified_path.md5_buffer());
-	HashMap<PathMD5, PackedData::PackedFile, PathMD5>::Iterator E = files.find(pmd5);
+	HashMap<PathMD5, uint32_t, PathMD5>::Iterator E = file_index.find(pmd5);
 	if (!E) {
 		return -1; //not found
 	}
-	if (E->value.offset == 0) {
+	FileRecord &record = file_records[E->value];
+	if (record.offset == 0) {
 		return -1; //was erased
 	}
-	return E->value.size;
+	if (record.flags & FILE_SIZE_PENDING) {
+		// concurrent first queries stat the same file and store the same value
+		int64_t size = FileAccess::get_size(file_origins[record.origin].pack.path_join(simplified_path));
+		record.size = MAX(size, 0);
+		record.flags &= ~FILE_SIZE_PENDING;
+	}
+	return record.size;
 }
 
 Ref<FileAccess> GDREPackedData::try_open_path(const String &p_path) {
 	String simplified_path = p_path.simplify_path().trim_prefix("res://");
 	PathMD5 pmd5(simplified_path.md5_buffer());
-	HashMap<PathMD5, PackedData::PackedFile, PathMD5>::Iterator E = files.find(pmd5);
+	HashMap<PathMD5, uint32_t, PathMD5>::Iterator E = file_index.find(pmd5);
 	if (!E) {
 		return nullptr; //not found
 	}
-	if (E->value.offset == 0) {
+	const FileRecord &record = file_records[E->value];
+	if (record.offset == 0) {
 		return nullptr; //was erased
 	}
 
-	return E->value.src->get_file(p_path, &E->value);
+	// sources copy the PackedFile into the FileAccess they return
+	PackedData::PackedFile pf;
+	_fill_packed_file(record, pf);
+	return pf.src->get_file(p_path, &pf);
 }
 
 bool GDREPackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.simplify_path().trim_prefix("res://").md5_buffer()));
+	return file_index.has(PathMD5(p_path.simplify_path().trim_prefix("res://").md5_buffer()));
 }
 
 Ref<DirAccess> GDREPackedData::try_open_directory(const String &p_path) {
@@ -295,7 +580,7 @@ void GDREPackedData::_free_packed_dirs(GDREPackedData::PackedDir *p_dir) {
 }
 
 bool GDREPackedData::has_loaded_packs() {
-	return !sources.is_empty() && !files.is_empty();
+	return !sources.is_empty() && !file_index.is_empty();
 }
 
 // Test for the existence of project.godot or project.binary in the packed data
@@ -317,8 +602,14 @@ void GDREPackedData::_clear() {
 	set_disabled(true);
 	_free_packed_dirs(root);
 	root = memnew(PackedDir);
-	file_map.clear();
-	files.clear();
+	file_index.clear();
+	file_records.reset();
+	path_arena.reset();
+	file_origins.reset();
+	removed_count = 0;
+	file_infos.reset();
+	file_infos_valid = false;
+	table_generation++;
 }
 
 GDREPackedData::~GDREPackedData() {
@@ -963,7 +1254,7 @@ Ref<DirAccess> DirAccessGDRE::_open_filesystem() {
 	if (path == "") {
 		path = "res://";
 	}
-	Ref<DirAccessProxy<DIR_ACCESS_OS>> dir_proxy = memnew(DirAccessProxy<DIR_ACCESS_OS>);
+	Ref<DirAccessProxy<DirAccessArchiveRedirect<DIR_ACCESS_OS>>> dir_proxy = memnew(DirAccessProxy<DirAccessArchiveRedirect<DIR_ACCESS_OS>>);
 	dir_proxy->change_dir(path);
 	return dir_proxy;
 }
@@ -1006,8 +1297,24 @@ void GDREPackedData::reset_default_file_access() {
 	set_file_access_defaults = false;
 }
 
+Error GDREPackedData::set_archive_output_access(bool p_enabled) {
+#ifdef ANDROID_ENABLED
+	// the filesystem defaults on Android aren't FILE_ACCESS_OS/DIR_ACCESS_OS, so they couldn't be restored
+	return p_enabled ? ERR_UNAVAILABLE : OK;
+#else
+	if (p_enabled) {
+		FileAccess::make_default<FileAccessArchiveRedirect<FILE_ACCESS_OS>>(FileAccess::ACCESS_FILESYSTEM);
+		DirAccess::make_default<DirAccessArchiveRedirect<DIR_ACCESS_OS>>(DirAccess::ACCESS_FILESYSTEM);
+	} else {
+		FileAccess::make_default<FILE_ACCESS_OS>(FileAccess::ACCESS_FILESYSTEM);
+		DirAccess::make_default<DIR_ACCESS_OS>(DirAccess::ACCESS_FILESYSTEM);
+	}
+	return OK;
+#endif
+}
+
 Ref<FileAccess> FileAccessGDRE::_open_filesystem(const String &p_path, int p_mode_flags, Error *r_error) {
-	Ref<FileAccessProxy<FILE_ACCESS_OS>> file_proxy = memnew(FileAccessProxy<FILE_ACCESS_OS>);
+	Ref<FileAccessProxy<FileAccessArchiveRedirect<FILE_ACCESS_OS>>> file_proxy = memnew(FileAccessProxy<FileAccessArchiveRedirect<FILE_ACCESS_OS>>);
 
 	Error err = file_proxy->open_internal(p_path, p_mode_flags);
 	if (r_error) {
@@ -3,6 +3,7 @@
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_pack.h"
+#include "core/templates/local_vector.h"
 #include "utility/packed_file_info.h"
 
 class DirSource : public PackSource {
@@ -24,6 +25,18 @@ public:
 		HashSet<String> files;
 	};
 
+	// Receives changes to the file table as they are merged, on the thread doing the merge.
+	// Used to stream the file list to the GUI while the rest of the project is still loading.
+	class FileTableListener {
+	public:
+		// Called again for a file that a later pack replaces.
+		virtual void file_added(const Ref<PackedFileInfo> &p_info) = 0;
+		virtual void file_removed(const String &p_path) = 0;
+		// Called once a call to add_pack, add_packs or add_dir has finished merging.
+		virtual void files_merged() = 0;
+		virtual ~FileTableListener() {}
+	};
+
 	struct PathMD5 {
 		uint64_t a = 0;
 		uint64_t b = 0;
@@ -45,8 +58,77 @@ public:
 	};
 
 private:
-	HashMap<PathMD5, PackedData::PackedFile, PathMD5> files;
-	HashMap<String, Ref<PackedFileInfo>> file_map;
+	enum FileRecordFlags : uint8_t {
+		FILE_ENCRYPTED = 1 << 0,
+		FILE_MALFORMED = 1 << 1,
+		FILE_MD5_PASSED = 1 << 2,
+		FILE_REMOVED = 1 << 3,
+		// size wasn't known when the file was added (SIZE_UNKNOWN); read on the first size query
+		FILE_SIZE_PENDING = 1 << 4,
+	};
+
+	// Fixed-width entry in the file table; paths live in path_arena as UTF-8.
+	struct FileRecord {
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint8_t md5[16] = {};
+		uint32_t path_ofs = 0;
+		uint32_t path_len = 0;
+		// same as path_ofs/path_len unless the raw path had to be fixed
+		uint32_t raw_path_ofs = 0;
+		uint32_t raw_path_len = 0;
+		uint32_t origin = 0;
+		uint8_t flags = 0;
+	};
+
+	struct FileOrigin {
+		String pack;
+		PackSource *src = nullptr;
+	};
+
+	// The path normalization and hashing for a table entry, which doesn't depend on the table.
+	struct PreparedPath {
+		String raw_path;
+		String fixed_path;
+		String path;
+		PathMD5 pmd5;
+		bool malformed = false;
+	};
+
+	// A pack directory read on a worker thread by add_packs, merged into the table afterwards in load order.
+	struct StagedPack {
+		struct Entry {
+			PreparedPath prepared;
+			String pack;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+			uint8_t md5[16] = {};
+			bool encrypted = false;
+			bool removal = false;
+		};
+		String path;
+		PackSource *src = nullptr;
+		bool replace_files = false;
+		bool opened = false;
+		LocalVector<Entry> entries;
+		// GDRESettings::PackInfo, which can't be named here
+		Vector<Ref<RefCounted>> pack_infos;
+	};
+	static thread_local StagedPack *staging;
+	static thread_local FileTableListener *listener;
+
+	// PackedFileInfo objects are only created on request (get_file_info_list); the table itself
+	// is just these arrays and an index keyed by the path hash.
+	LocalVector<FileRecord> file_records;
+	LocalVector<char> path_arena;
+	LocalVector<FileOrigin> file_origins;
+	HashMap<PathMD5, uint32_t, PathMD5> file_index;
+	uint32_t removed_count = 0;
+	// Bumped by clear(), so infos made for an earlier table can't write to a record that reused their index.
+	uint64_t table_generation = 0;
+	// The infos handed out by get_file_info_list, by record index; rebuilt after the table changes.
+	LocalVector<Ref<PackedFileInfo>> file_infos;
+	bool file_infos_valid = false;
 
 	Vector<PackSource *> sources;
 
@@ -65,12 +147,30 @@ private:
 
 	void _clear();
 
+	uint32_t _add_path_string(const String &p_path, uint32_t &r_len);
+	static PreparedPath _prepare_path(const String &p_path, bool p_pck_src);
+	void _add_prepared_path(const String &p_pkg_path, const PreparedPath &p_prepared, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted);
+	void _ensure_sources();
+	void _read_staged_pack(uint32_t p_idx, StagedPack *p_packs);
+	uint32_t _get_origin(const String &p_pack, PackSource *p_src);
+	String _get_record_path(const FileRecord &p_record) const;
+	String _get_record_raw_path(const FileRecord &p_record) const;
+	void _fill_packed_file(const FileRecord &p_record, PackedData::PackedFile &r_pf) const;
+	Ref<PackedFileInfo> _make_file_info(uint32_t p_idx) const;
+	static bool _matches_filters(const String &p_path, const Vector<String> &p_filters);
+
 public:
+	// Passed as p_size to add_path by sources that can only get a file's size by stat'ing it (folders).
+	static constexpr uint64_t SIZE_UNKNOWN = UINT64_MAX;
+
 	void set_default_file_access();
 	void reset_default_file_access();
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, bool p_pck_src = false); // for PackSource
 	void remove_path(const String &p_path);
+	void reserve_files(uint32_t p_count);
+	// p_record and p_generation are those of the PackedFileInfo the result was checked for.
+	void set_md5_passed(uint32_t p_record, uint64_t p_generation, bool p_passed);
 	uint8_t *get_file_hash(const String &p_path);
 	HashSet<String> get_file_paths() const;
 
@@ -79,6 +179,13 @@ public:
 
 	static GDREPackedData *get_singleton();
 	Error add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
+	// Reads the directories of several packs concurrently and adds them as if add_pack had been called on each
+	// in order. On failure, r_failed_path is the first pack that couldn't be opened; packs before it stay loaded.
+	Error add_packs(const Vector<String> &p_paths, bool p_replace_files, String *r_failed_path = nullptr);
+	// Called by GDRESettings::add_pack_info; returns true if the info was held back for a staged pack.
+	bool stage_pack_info(const Ref<RefCounted> &p_pack_info);
+	// Only merges done on the calling thread are reported to the listener.
+	static void set_thread_listener(FileTableListener *p_listener);
 	Error add_dir(const String &p_path, bool p_replace_files = false);
 
 	void clear();
@@ -89,7 +196,9 @@ public:
 	_FORCE_INLINE_ Ref<DirAccess> try_open_directory(const String &p_path);
 	_FORCE_INLINE_ bool has_directory(const String &p_path);
 
+	// The same info objects are returned until the table changes.
 	Vector<Ref<PackedFileInfo>> get_file_info_list(const Vector<String> &filters = Vector<String>());
+	Vector<String> get_file_list(const Vector<String> &filters = Vector<String>());
 	static bool real_packed_data_has_pack_loaded();
 	bool has_loaded_packs();
 	String fix_res_path(const String &p_path);
@@ -98,6 +207,8 @@ public:
 	static String get_current_dir_access_class(DirAccess::AccessType p_access_type);
 	static String get_os_file_access_class_name();
 	static String get_os_dir_access_class_name();
+	// Redirects ACCESS_FILESYSTEM through the archive output (see file_access_archive.h) while it's active.
+	static Error set_archive_output_access(bool p_enabled);
 	GDREPackedData();
 	~GDREPackedData();
 };
@@ -52,6 +52,31 @@ Vector<Ref<GDREConfigSetting>> GDREConfig::_init_default_settings() {
 				"Force export multi root",
 				"Forces the export to export in multi-root mode, even if the scene is a single root",
 				false)),
+		memnew(GDREConfigSetting(
+				"Exporter/Scene/shared_resource_cache_size",
+				"Shared resource cache size",
+				"Number of relocated scene dependencies (e.g. textures) kept loaded for reuse by later scene exports; 0 disables the cache",
+				128)),
+		memnew(GDREConfigSetting(
+				"Exporter/Image/use_fast_png_encoder",
+				"Use fast PNG encoder",
+				"Opt-in: uses the built-in fast PNG encoder instead of libpng for all lossless image output. Off by default, so exported PNGs are byte-for-byte what the engine writes",
+				false)),
+		memnew(GDREConfigSetting(
+				"Exporter/Image/png_compression_effort",
+				"PNG compression effort",
+				"Compression effort for the fast PNG encoder, from 0 (uncompressed) to 9 (smallest, slowest)",
+				2)),
+		memnew(GDREConfigSetting(
+				"Exporter/Image/use_vtracer_for_svg",
+				"Use vtracer for SVG output",
+				"Traces SVG output with vtracer instead of merging identical pixel runs into rectangles; only useful for non-pixel-art images",
+				false)),
+		memnew(GDREConfigSetting(
+				"Exporter/deduplicate_output_files",
+				"Deduplicate output files",
+				"Replaces byte-identical output files with hardlinks to the first copy; editing one copy in place will change all of them",
+				false)),
 	};
 }
 
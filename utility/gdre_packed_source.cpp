@@ -402,6 +402,7 @@ bool GDREPackedSource::try_open_pack(const String &p_path, bool p_replace_files,
 	GDRESettings::get_singleton()->add_pack_info(pckinfo);
 
 	// Read the file list.
+	GDREPackedData::get_singleton()->reserve_files(file_count);
 	for (uint32_t i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -4,6 +4,7 @@
 #include "bytecode/bytecode_tester.h"
 #include "compat/resource_compat_binary.h"
 #include "compat/resource_loader_compat.h"
+#include "compat/resource_resolution_context.h"
 #include "core/error/error_list.h"
 #include "core/error/error_macros.h"
 #include "core/io/file_access.h"
@@ -12,6 +13,7 @@
 #include "modules/zip/zip_reader.h"
 #include "utility/common.h"
 #include "utility/file_access_gdre.h"
+#include "utility/gdre_config.h"
 #include "utility/gdre_logger.h"
 #include "utility/gdre_packed_source.h"
 #include "utility/gdre_version.gen.h"
@@ -21,7 +23,11 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/json.h"
+#include "core/io/marshalls.h"
+#include "core/math/random_pcg.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/object/script_language.h"
+#include "core/version.h"
 #include "modules/regex/regex.h"
 #include "servers/rendering_server.h"
 
@@ -242,7 +248,7 @@ GDRESettings::GDRESettings() {
 	logger = memnew(GDRELogger);
 	headless = !RenderingServer::get_singleton() || RenderingServer::get_singleton()->get_video_adapter_name().is_empty();
 	add_logger();
-	PluginManager::load_cache();
+	// the plugin caches are loaded by PluginManager the first time they are needed
 }
 
 GDRESettings::~GDRESettings() {
@@ -461,6 +467,28 @@ Error GDRESettings::load_pck(const String &p_path) {
 	return OK;
 }
 
+Error GDRESettings::load_pcks(const Vector<String> &p_paths) {
+	for (int i = 0; i < p_paths.size(); i++) {
+		for (const auto &pack : packs) {
+			if (pack->pack_file == p_paths[i]) {
+				return ERR_ALREADY_IN_USE;
+			}
+		}
+		if (p_paths.find(p_paths[i]) < i) {
+			return ERR_ALREADY_IN_USE;
+		}
+	}
+	// The directories are read concurrently but merged in order, so later packs still override earlier ones.
+	String failed_path;
+	Error err = GDREPackedData::get_singleton()->add_packs(p_paths, true, &failed_path);
+	if (err) {
+		ERR_FAIL_COND_V_MSG(error_encryption, ERR_PRINTER_ON_FIRE, "FATAL ERROR: Cannot open encrypted pck! (wrong key?)");
+	}
+	ERR_FAIL_COND_V_MSG(err, err, "FATAL ERROR: Can't open pack " + sanitize_home_in_path(failed_path) + "!");
+	ERR_FAIL_COND_V_MSG(!is_pack_loaded(), ERR_FILE_CANT_READ, "FATAL ERROR: loaded project pack, but didn't load files from it!");
+	return OK;
+}
+
 bool is_zip_file_pack(const String &p_path) {
 	Ref<ZIPReader> zip = memnew(ZIPReader);
 	Error err = zip->open(p_path);
@@ -498,11 +526,20 @@ String GDRESettings::sanitize_home_in_path(const String &p_path) {
 	return p_path;
 }
 
+void GDRESettings::cancel_load() {
+	load_canceled = true;
+}
+
+bool GDRESettings::is_load_canceled() const {
+	return load_canceled;
+}
+
 Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_extract) {
 	GDRELogger::clear_error_queues();
 	if (is_pack_loaded()) {
 		return ERR_ALREADY_IN_USE;
 	}
+	load_canceled = false;
 
 	if (p_paths.is_empty()) {
 		ERR_FAIL_V_MSG(ERR_FILE_NOT_FOUND, "No valid paths provided!");
@@ -513,6 +550,30 @@ Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_e
 		log_sysinfo();
 	}
 
+	const uint64_t load_start = OS::get_singleton()->get_ticks_usec();
+	uint64_t phase_start = load_start;
+	Vector<String> phase_timings;
+	auto end_phase = [&](const String &p_phase) {
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		phase_timings.push_back(vformat("  %s: %d ms", p_phase, (now - phase_start) / 1000));
+		phase_start = now;
+	};
+	// cancel_load is called from another thread; the phases themselves aren't interrupted
+	auto check_canceled = [&]() {
+		if (!load_canceled) {
+			return false;
+		}
+		unload_project();
+		print_line("Loading project canceled.");
+		return true;
+	};
+	auto print_timings = [&]() {
+		print_verbose(vformat("Loading project took %d ms", (OS::get_singleton()->get_ticks_usec() - load_start) / 1000));
+		for (const String &timing : phase_timings) {
+			print_verbose(timing);
+		}
+	};
+
 	Error err = ERR_CANT_OPEN;
 	Vector<String> pck_files = p_paths;
 	// This may be a ".app" bundle, so we need to check if it's a valid Godot app
@@ -539,9 +600,8 @@ Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_e
 		print_line("Opening file: " + sanitize_home_in_path(pck_files[0]));
 		err = load_dir(pck_files[0]);
 		ERR_FAIL_COND_V_MSG(err, err, "FATAL ERROR: Can't load project directory!");
-		load_pack_uid_cache();
-		load_pack_gdscript_cache();
 	} else {
+		Vector<String> paths_to_load;
 		for (auto path : pck_files) {
 			auto san_path = sanitize_home_in_path(path);
 			print_line("Opening file: " + san_path);
@@ -581,19 +641,24 @@ Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_e
 				path = new_path;
 				WARN_PRINT("Could not find embedded pck in EXE, found pck file, loading from: " + san_path);
 			}
-			err = load_pck(path);
-			if (err) {
-				unload_project();
-				ERR_FAIL_COND_V_MSG(err, err, "Can't load project!");
-			}
-			load_pack_uid_cache();
-			load_pack_gdscript_cache();
+			paths_to_load.push_back(path);
+		}
+		err = load_pcks(paths_to_load);
+		if (err) {
+			unload_project();
+			ERR_FAIL_COND_V_MSG(err, err, "Can't load project!");
 		}
 	}
 
 	ERR_FAIL_COND_V_MSG(!is_pack_loaded(), ERR_FILE_CANT_READ, "FATAL ERROR: loaded project pack, but didn't load files from it!");
+	end_phase("packs");
+	if (check_canceled()) {
+		return ERR_SKIP;
+	}
 	if (_cmd_line_extract) {
 		// we don't want to load the imports and project config if we're just extracting.
+		load_pack_uid_cache();
+		load_pack_gdscript_cache();
 		return OK;
 	}
 
@@ -606,18 +671,32 @@ Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_e
 				pck_zip_files.push_back(path.get_file().to_lower());
 			}
 		}
+		Vector<String> zips_to_load;
 		for (auto zip_file : zip_files) {
 			if (is_zip_file_pack(zip_file) && !pck_zip_files.has(zip_file.get_file().to_lower())) {
-				err = load_pck(zip_file);
-				if (err) {
-					unload_project();
-					ERR_FAIL_COND_V_MSG(err, err, "Can't load project!");
-				}
-				load_pack_uid_cache();
-				load_pack_gdscript_cache();
+				zips_to_load.push_back(zip_file);
+			}
+		}
+		if (!zips_to_load.is_empty()) {
+			err = load_pcks(zips_to_load);
+			if (err) {
+				unload_project();
+				ERR_FAIL_COND_V_MSG(err, err, "Can't load project!");
 			}
 		}
 	}
+	end_phase("embedded zips");
+	if (check_canceled()) {
+		return ERR_SKIP;
+	}
+
+	// Later packs override the caches of earlier ones, so they only need to be read once all packs are in.
+	load_pack_uid_cache();
+	load_pack_gdscript_cache();
+	end_phase("uid and script class caches");
+	if (check_canceled()) {
+		return ERR_SKIP;
+	}
 
 	bool invalid_ver = !has_valid_version() || current_project->suspect_version;
 
@@ -630,24 +709,73 @@ Error GDRESettings::load_project(const Vector<String> &p_paths, bool _cmd_line_e
 			ERR_FAIL_V_MSG(err, "FATAL ERROR: Can't determine engine version of project pack!");
 		}
 	}
+	end_phase("engine version");
+	if (check_canceled()) {
+		return ERR_SKIP;
+	}
 
-	err = detect_bytecode_revision(invalid_ver);
-	if (err) {
-		if (err == ERR_UNAUTHORIZED) {
-			_set_error_encryption(true);
+	// Bytecode revision detection only reads the file table; the project config and import files only need the
+	// major and minor version, which it almost never changes, so they are loaded alongside it.
+	BytecodeDetection detection;
+	detection.no_valid_version = invalid_ver;
+	const bool detect_bytecode = current_project->bytecode_revision == 0;
+	WorkerThreadPool::TaskID detection_task = WorkerThreadPool::INVALID_TASK_ID;
+	if (detect_bytecode) {
+		if (GDREConfig::get_singleton()->get_setting("force_single_threaded", false)) {
+			_detect_bytecode_revision(&detection);
+		} else {
+			detection_task = WorkerThreadPool::get_singleton()->add_template_task(this, &GDRESettings::_detect_bytecode_revision, &detection, true, SNAME("GDRESettings::detect_bytecode_revision"));
+		}
+	}
+	const uint32_t ver_major = get_ver_major();
+	const uint32_t ver_minor = get_ver_minor();
+	uint64_t config_and_imports_start = OS::get_singleton()->get_ticks_usec();
+	Error config_err = OK;
+	Error import_err = OK;
+	auto load_config_and_imports = [&]() {
+		if (pack_has_project_config()) {
+			config_err = load_project_config();
+		}
+		if (config_err == OK) {
+			import_err = load_import_files();
+		}
+	};
+	load_config_and_imports();
+	uint64_t config_and_imports_usec = OS::get_singleton()->get_ticks_usec() - config_and_imports_start;
+	if (detection_task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(detection_task);
+	}
+
+	if (detect_bytecode) {
+		err = _apply_bytecode_detection(detection);
+		if (err) {
+			if (err == ERR_UNAUTHORIZED) {
+				_set_error_encryption(true);
+			}
+			WARN_PRINT("Could not determine bytecode revision, not able to decompile scripts...");
+		}
+		if (get_ver_major() != ver_major || get_ver_minor() != ver_minor) {
+			// the bytecode says this is a different engine version; reload with the right one
+			current_project->pcfg.instantiate();
+			import_files.clear();
+			remap_iinfo.clear();
+			config_err = OK;
+			import_err = OK;
+			load_config_and_imports();
 		}
-		WARN_PRINT("Could not determine bytecode revision, not able to decompile scripts...");
 	}
 
 	if (!pack_has_project_config()) {
 		WARN_PRINT("Could not find project configuration in directory, may be a seperate resource pack...");
 	} else {
-		err = load_project_config();
-		ERR_FAIL_COND_V_MSG(err, err, "FATAL ERROR: Can't open project config!");
+		ERR_FAIL_COND_V_MSG(config_err, config_err, "FATAL ERROR: Can't open project config!");
 	}
+	ERR_FAIL_COND_V_MSG(import_err, ERR_FILE_CANT_READ, "FATAL ERROR: Could not load imported binary files!");
 
-	err = load_import_files();
-	ERR_FAIL_COND_V_MSG(err, ERR_FILE_CANT_READ, "FATAL ERROR: Could not load imported binary files!");
+	String critical_path = detection.usec > config_and_imports_usec ? "bytecode revision" : "project config and import files";
+	end_phase(vformat("bytecode revision (%d ms) alongside project config and import files (%d ms), critical path: %s",
+			detection.usec / 1000, config_and_imports_usec / 1000, critical_path));
+	print_timings();
 
 	return OK;
 }
@@ -663,9 +791,36 @@ Error GDRESettings::detect_bytecode_revision(bool p_no_valid_version) {
 	if (current_project->bytecode_revision != 0) {
 		return OK;
 	}
+	BytecodeDetection detection;
+	detection.no_valid_version = p_no_valid_version;
+	_detect_bytecode_revision(&detection);
+	return _apply_bytecode_detection(detection);
+}
+
+Error GDRESettings::_apply_bytecode_detection(const BytecodeDetection &p_detection) {
+	if (p_detection.revision_found) {
+		current_project->bytecode_revision = p_detection.revision;
+	}
+	if (p_detection.version.is_valid()) {
+		current_project->version = p_detection.version;
+	} else if (p_detection.patch >= 0) {
+		current_project->version->set_patch(p_detection.patch);
+	}
+	return p_detection.err;
+}
+
+// Doesn't modify the project, so that it can run alongside the other loading phases; the result is applied with _apply_bytecode_detection.
+void GDRESettings::_detect_bytecode_revision(BytecodeDetection *r_detection) {
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+	r_detection->err = _detect_bytecode_revision_internal(*r_detection);
+	r_detection->usec = OS::get_singleton()->get_ticks_usec() - start;
+}
+
+Error GDRESettings::_detect_bytecode_revision_internal(BytecodeDetection &r_detection) {
 	int ver_major = -1;
 	int ver_minor = -1;
-	if (has_valid_version()) {
+	const bool had_valid_version = has_valid_version();
+	if (had_valid_version) {
 		ver_major = get_ver_major();
 		ver_minor = get_ver_minor();
 	}
@@ -673,14 +828,18 @@ Error GDRESettings::detect_bytecode_revision(bool p_no_valid_version) {
 	Vector<String> encrypted_files = get_file_list({ "*.gde" });
 
 	auto guess_from_version = [&](Error fail_error = ERR_FILE_CANT_OPEN) {
+		r_detection.revision_found = true;
 		if (ver_major > 0 && ver_minor >= 0) {
 			auto decomp = GDScriptDecomp::create_decomp_for_version(current_project->version->as_text(), true);
-			ERR_FAIL_COND_V_MSG(decomp.is_null(), fail_error, "Cannot determine bytecode revision");
+			if (decomp.is_null()) {
+				r_detection.revision_found = false;
+				ERR_FAIL_V_MSG(fail_error, "Cannot determine bytecode revision");
+			}
 			print_line("Guessing bytecode revision from engine version: " + get_version_string() + " (rev 0x" + String::num_int64(decomp->get_bytecode_rev(), 16) + ")");
-			current_project->bytecode_revision = decomp->get_bytecode_rev();
+			r_detection.revision = decomp->get_bytecode_rev();
 			return OK;
 		}
-		current_project->bytecode_revision = 0;
+		r_detection.revision = 0;
 		ERR_FAIL_V_MSG(fail_error, "Cannot determine bytecode revision!");
 	};
 	if (!encrypted_files.is_empty()) {
@@ -699,7 +858,8 @@ Error GDRESettings::detect_bytecode_revision(bool p_no_valid_version) {
 		ERR_FAIL_COND_V_MSG(need_correct_patch(ver_major, ver_minor), ERR_FILE_CANT_OPEN, "Cannot determine bytecode revision: Need the correct patch version for engine version " + itos(ver_major) + "." + itos(ver_minor) + ".x!");
 		return guess_from_version(ERR_FILE_CANT_OPEN);
 	}
-	current_project->bytecode_revision = revision;
+	r_detection.revision_found = true;
+	r_detection.revision = revision;
 	auto decomp = GDScriptDecomp::create_decomp_for_commit(revision);
 	ERR_FAIL_COND_V_MSG(decomp.is_null(), ERR_FILE_CANT_OPEN, "Cannot determine bytecode revision!");
 	auto check_if_same_minor_major = [&](Ref<GodotVer> version, Ref<GodotVer> max_ver) {
@@ -708,22 +868,23 @@ Error GDRESettings::detect_bytecode_revision(bool p_no_valid_version) {
 		}
 		return true;
 	};
-	if (!has_valid_version()) {
-		current_project->version = decomp->get_godot_ver();
-		current_project->version->set_build_metadata("");
+	if (!had_valid_version) {
+		r_detection.version = decomp->get_godot_ver();
+		r_detection.version->set_build_metadata("");
 	} else {
+		const Ref<GodotVer> &current_version = current_project->version;
 		auto version = decomp->get_godot_ver();
 		if (version->is_prerelease()) {
-			current_project->version = decomp->get_max_engine_version().is_empty() ? version : decomp->get_max_godot_ver();
-		} else if (ver_major < 3 || (ver_major == 3 && ver_minor <= 1) || p_no_valid_version) { // didn't write correct patch version or did not have a correct pck version
+			r_detection.version = decomp->get_max_engine_version().is_empty() ? version : decomp->get_max_godot_ver();
+		} else if (ver_major < 3 || (ver_major == 3 && ver_minor <= 1) || r_detection.no_valid_version) { // didn't write correct patch version or did not have a correct pck version
 			auto max_version = decomp->get_max_godot_ver();
-			if (max_version.is_valid() && (check_if_same_minor_major(current_project->version, max_version))) {
-				if (max_version->get_patch() > current_project->version->get_patch()) {
-					current_project->version->set_patch(max_version->get_patch());
+			if (max_version.is_valid() && (check_if_same_minor_major(current_version, max_version))) {
+				if (max_version->get_patch() > current_version->get_patch()) {
+					r_detection.patch = max_version->get_patch();
 				}
-			} else if (check_if_same_minor_major(current_project->version, version)) {
-				if (version->get_patch() > current_project->version->get_patch()) {
-					current_project->version->set_patch(version->get_patch());
+			} else if (check_if_same_minor_major(current_version, version)) {
+				if (version->get_patch() > current_version->get_patch()) {
+					r_detection.patch = version->get_patch();
 				}
 			}
 		}
@@ -735,6 +896,69 @@ int GDRESettings::get_bytecode_revision() const {
 	return is_pack_loaded() ? current_project->bytecode_revision : 0;
 }
 
+namespace {
+// Version inference reads headers from a bounded sample first, and only scans everything if the sample disagrees.
+constexpr int VERSION_SAMPLE_SIZE = 64;
+constexpr int VERSION_SAMPLE_MIN_AGREEING = 16;
+
+Vector<String> sample_paths(const Vector<String> &p_paths, int p_count) {
+	if (p_paths.size() <= p_count) {
+		return p_paths;
+	}
+	// partial Fisher-Yates; seeded by the file count so that loading the same pack twice gives the same answer
+	Vector<String> paths = p_paths;
+	RandomPCG rng(paths.size());
+	for (int i = 0; i < p_count; i++) {
+		int j = i + rng.rand() % (paths.size() - i);
+		if (i != j) {
+			SWAP(paths.write[i], paths.write[j]);
+		}
+	}
+	paths.resize(p_count);
+	return paths;
+}
+
+// Reads the version words of a plain binary resource header without setting up a loader. Compressed resources
+// keep their header inside the compressed block, so those (and anything else that isn't "RSRC") return false.
+bool read_resource_version_words(const String &p_path, uint32_t &r_major, uint32_t &r_minor) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null()) {
+		return false;
+	}
+	uint8_t header[20];
+	if (f->get_buffer(header, 20) != 20 || memcmp(header, "RSRC", 4) != 0) {
+		return false;
+	}
+	bool big_endian = decode_uint32(&header[4]) != 0;
+	r_major = decode_uint32(&header[12]);
+	r_minor = decode_uint32(&header[16]);
+	if (big_endian) {
+		r_major = BSWAP32(r_major);
+		r_minor = BSWAP32(r_minor);
+	}
+	return true;
+}
+
+// True if every compiled script starts with the same bytecode version word.
+bool bytecode_version_words_agree(const Vector<String> &p_paths) {
+	uint32_t first = 0;
+	for (int i = 0; i < p_paths.size(); i++) {
+		Ref<FileAccess> f = FileAccess::open(p_paths[i], FileAccess::READ);
+		uint8_t header[8];
+		if (f.is_null() || f->get_buffer(header, 8) != 8 || memcmp(header, "GDSC", 4) != 0) {
+			return false;
+		}
+		uint32_t version = decode_uint32(&header[4]);
+		if (i == 0) {
+			first = version;
+		} else if (version != first) {
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace
+
 Error GDRESettings::get_version_from_bin_resources() {
 	int consistent_versions = 0;
 	int inconsistent_versions = 0;
@@ -787,7 +1011,18 @@ Error GDRESettings::get_version_from_bin_resources() {
 	};
 
 	if (!bytecode_files.is_empty()) {
-		decomps = BytecodeTester::get_possible_decomps(bytecode_files);
+		if (bytecode_files.size() > VERSION_SAMPLE_SIZE) {
+			// The version words are read first. When every script has the same one, the sample's candidates stand
+			// for the whole project; otherwise they are checked against the rest (anything that passes every file
+			// also passes the sample). An empty result still goes through the lenient fallback below.
+			bool same_bytecode_version = bytecode_version_words_agree(bytecode_files);
+			decomps = BytecodeTester::get_possible_decomps(sample_paths(bytecode_files, VERSION_SAMPLE_SIZE));
+			if (!decomps.is_empty() && !same_bytecode_version) {
+				decomps = BytecodeTester::get_passing_decomps(bytecode_files, decomps);
+			}
+		} else {
+			decomps = BytecodeTester::get_possible_decomps(bytecode_files);
+		}
 		if (decomps.is_empty()) {
 			decomps = BytecodeTester::get_possible_decomps(bytecode_files, true);
 		}
@@ -813,6 +1048,54 @@ Error GDRESettings::get_version_from_bin_resources() {
 		wildcards.push_back("*." + ext);
 	}
 	Vector<String> files = get_file_list(wildcards);
+	if (files.size() > VERSION_SAMPLE_SIZE) {
+		// The sample decides once enough of its headers agree. Any disagreement, a suspicious header, or a major
+		// version that contradicts the texture formats in the pack falls through to the full scan below.
+		int agreeing = 0;
+		bool sample_consistent = true;
+		uint32_t sample_major = 0;
+		uint32_t sample_minor = 0;
+		for (const String &path : sample_paths(files, VERSION_SAMPLE_SIZE)) {
+			bool suspicious = false;
+			uint32_t res_major = 0;
+			uint32_t res_minor = 0;
+			if (ResourceFormatLoaderCompatBinary::get_ver_major_minor(path, res_major, res_minor, suspicious) != OK) {
+				continue;
+			}
+			if (suspicious || (agreeing > 0 && (res_major != sample_major || res_minor != sample_minor))) {
+				sample_consistent = false;
+				break;
+			}
+			sample_major = res_major;
+			sample_minor = res_minor;
+			if (++agreeing >= VERSION_SAMPLE_MIN_AGREEING) {
+				break;
+			}
+		}
+		if (sample_consistent && agreeing >= VERSION_SAMPLE_MIN_AGREEING && (version_from_dir == 0 || (int)sample_major == version_from_dir)) {
+			// The full scan takes the newest version it finds, so the sample only stands in for it if nothing is newer.
+			// That is checked on the raw header words alone, which skips the loader setup the full scan pays per file.
+			bool found_newer = false;
+			for (const String &path : files) {
+				uint32_t res_major = 0;
+				uint32_t res_minor = 0;
+				if (!read_resource_version_words(path, res_major, res_minor)) {
+					bool suspicious = false;
+					if (ResourceFormatLoaderCompatBinary::get_ver_major_minor(path, res_major, res_minor, suspicious) != OK) {
+						continue;
+					}
+				}
+				if (res_major > sample_major || (res_major == sample_major && res_minor > sample_minor)) {
+					found_newer = true;
+					break;
+				}
+			}
+			if (!found_newer) {
+				current_project->version = GodotVer::create(sample_major, sample_minor, 0);
+				return OK;
+			}
+		}
+	}
 	uint64_t max = files.size();
 	bool sus_warning = false;
 	for (i = 0; i < max; i++) {
@@ -899,6 +1182,8 @@ Error GDRESettings::unload_project() {
 	error_encryption = false;
 	reset_uid_cache();
 	reset_gdscript_cache();
+	// shared dependencies are keyed by project paths
+	ResourceResolutionContext::clear_shared();
 	if (get_pack_type() == PackInfo::DIR) {
 		unload_dir();
 	}
@@ -910,6 +1195,10 @@ Error GDRESettings::unload_project() {
 
 void GDRESettings::add_pack_info(Ref<PackInfo> packinfo) {
 	ERR_FAIL_COND_MSG(!packinfo.is_valid(), "Invalid pack info!");
+	// packs read on worker threads by GDREPackedData::add_packs are added here when they're merged, in load order
+	if (GDREPackedData::get_singleton()->stage_pack_info(packinfo)) {
+		return;
+	}
 	packs.push_back(packinfo);
 	if (!current_project.is_valid()) { // only set if we don't have a current pack
 		current_project = Ref<ProjectInfo>(memnew(ProjectInfo));
@@ -1012,12 +1301,7 @@ Vector<String> GDRESettings::get_file_list(const Vector<String> &filters) {
 	if (!is_pack_loaded()) {
 		return gdre::get_recursive_dir_list("res://", filters);
 	}
-	Vector<String> ret;
-	Vector<Ref<PackedFileInfo>> flist = get_file_info_list(filters);
-	for (int i = 0; i < flist.size(); i++) {
-		ret.push_back(flist[i]->path);
-	}
-	return ret;
+	return GDREPackedData::get_singleton()->get_file_list(filters);
 }
 
 Array GDRESettings::get_file_info_array(const Vector<String> &filters) {
@@ -11,6 +11,8 @@
 #include "core/object/object.h"
 #include "core/os/thread_safe.h"
 
+#include <atomic>
+
 class GDREPackSettings : public ProjectSettings {
 	GDCLASS(GDREPackSettings, ProjectSettings);
 
@@ -171,6 +173,7 @@ private:
 	bool in_editor = false;
 	bool first_load = true;
 	bool error_encryption = false;
+	std::atomic<bool> load_canceled = false;
 	String project_path = "";
 	static GDRESettings *singleton;
 	static String exec_dir;
@@ -197,7 +200,21 @@ private:
 	Error load_pack_gdscript_cache(bool p_reset = false);
 	Error reset_gdscript_cache();
 
+	struct BytecodeDetection {
+		bool no_valid_version = false;
+		Error err = OK;
+		bool revision_found = false;
+		int revision = 0;
+		// Either a replacement version or a corrected patch number for the current one.
+		Ref<GodotVer> version;
+		int patch = -1;
+		uint64_t usec = 0;
+	};
+
 	Error detect_bytecode_revision(bool p_no_valid_version);
+	void _detect_bytecode_revision(BytecodeDetection *r_detection);
+	Error _detect_bytecode_revision_internal(BytecodeDetection &r_detection);
+	Error _apply_bytecode_detection(const BytecodeDetection &p_detection);
 
 	static constexpr bool need_correct_patch(int ver_major, int ver_minor);
 	void _do_prepop(uint32_t i, const String *plugins);
@@ -212,8 +229,12 @@ protected:
 public:
 	Error load_project(const Vector<String> &p_paths, bool cmd_line_extract = false);
 	Error load_pck(const String &p_path);
+	Error load_pcks(const Vector<String> &p_paths);
 
 	Error unload_project();
+	// Makes a load_project running on another thread stop and unload at its next phase; it returns ERR_SKIP.
+	void cancel_load();
+	bool is_load_canceled() const;
 	String get_gdre_resource_path() const;
 	String get_gdre_user_path() const;
 
@@ -4,6 +4,7 @@
 #include "bytecode/bytecode_base.h"
 #include "compat/oggstr_loader_compat.h"
 #include "compat/resource_loader_compat.h"
+#include "compat/resource_resolution_context.h"
 #include "core/error/error_list.h"
 #include "core/error/error_macros.h"
 #include "core/object/class_db.h"
@@ -15,10 +16,12 @@
 #include "utility/gdre_config.h"
 #include "utility/gdre_settings.h"
 #include "utility/glob.h"
+#include "utility/output_dedup.h"
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/os/os.h"
+#include "modules/zip/zip_reader.h"
 #include "thirdparty/minimp3/minimp3_ex.h"
 #include "utility/import_info.h"
 
@@ -48,15 +51,6 @@ Ref<ImportExporterReport> ImportExporter::get_report() {
 /**
 Sort the scenes so that they are exported last
  */
-namespace {
-static FileNoCaseComparator file_no_case_comparator;
-struct ReportComparator {
-	bool operator()(const Ref<ExportReport> &a, const Ref<ExportReport> &b) const {
-		return file_no_case_comparator(a->get_import_info()->get_source_file(), b->get_import_info()->get_source_file());
-	}
-};
-} //namespace
-
 // Error remove_remap(const String &src, const String &dst, const String &output_dir);
 Error ImportExporter::handle_auto_converted_file(const String &autoconverted_file) {
 	String prefix = autoconverted_file.replace_first("res://", "");
@@ -82,52 +76,124 @@ Error ImportExporter::remove_remap_and_autoconverted(const String &source_file,
 	return handle_auto_converted_file(autoconverted_file);
 }
 
+namespace {
+// Appends to a single UTF-8 buffer so the cache is written in one store_buffer call.
+struct FilesystemCacheWriter {
+	LocalVector<uint8_t> buffer;
+
+	void append(const char *p_str, int64_t p_len) {
+		int64_t ofs = buffer.size();
+		buffer.resize(ofs + p_len);
+		memcpy(buffer.ptr() + ofs, p_str, p_len);
+	}
+	void append(const CharString &p_str) {
+		append(p_str.get_data(), p_str.length());
+	}
+	void append(const String &p_str) {
+		append(p_str.utf8());
+	}
+	void append_literal(const char *p_str) {
+		append(p_str, strlen(p_str));
+	}
+	void append_int(int64_t p_num) {
+		char buf[24];
+		char *end = buf + sizeof(buf);
+		char *c = end;
+		uint64_t n = p_num < 0 ? -(uint64_t)p_num : p_num;
+		do {
+			*--c = '0' + (n % 10);
+			n /= 10;
+		} while (n);
+		if (p_num < 0) {
+			*--c = '-';
+		}
+		append(c, end - c);
+	}
+	void append_joined(const Vector<String> &p_strs, const char *p_sep) {
+		for (int i = 0; i < p_strs.size(); i++) {
+			if (i > 0) {
+				append_literal(p_sep);
+			}
+			append(p_strs[i]);
+		}
+	}
+};
+
+struct FilesystemCacheEntry {
+	String dir;
+	String file;
+	const ExportReport *report = nullptr;
+};
+
+struct FilesystemCacheEntryComparator {
+	_FORCE_INLINE_ bool operator()(const FilesystemCacheEntry &a, const FilesystemCacheEntry &b) const {
+		int cmp = a.dir.filenocasecmp_to(b.dir);
+		if (cmp != 0) {
+			return cmp < 0;
+		}
+		return a.file.filenocasecmp_to(b.file) < 0;
+	}
+};
+} //namespace
+
 void _save_filesystem_cache(const Vector<Ref<ExportReport>> &reports, Ref<FileAccess> p_file) {
-	String current_dir = "";
-	auto curr_time = OS::get_singleton()->get_unix_time();
-	bool is_v4_4_or_newer = get_ver_major() > 4 || (get_ver_major() == 4 && get_ver_minor() >= 4);
-	for (auto &report : reports) {
+	// Each directory header has to appear once, so the entries are sorted by directory first and then by file;
+	// sorting on the full path interleaves a directory's files with its subdirectories.
+	LocalVector<FilesystemCacheEntry> entries;
+	entries.reserve(reports.size());
+	for (const Ref<ExportReport> &report : reports) {
 		String source_file = report->get_import_info()->get_source_file();
 		String base_dir = source_file.get_base_dir();
 		if (base_dir != "res://") {
 			base_dir += "/";
 		}
-		if (base_dir != current_dir) {
-			current_dir = base_dir;
-			p_file->store_line("::" + base_dir + "::" + String::num_int64(curr_time));
-		}
+		entries.push_back({ base_dir, source_file.get_file(), report.ptr() });
+	}
+	entries.sort_custom<FilesystemCacheEntryComparator>();
 
-		// const EditorFileSystemDirectory::FileInfo *file_info = p_dir->files[i];
-		// if (!file_info->import_group_file.is_empty()) {
-		// 	group_file_cache.insert(file_info->import_group_file);
-		// }
+	bool is_v4_4_or_newer = get_ver_major() > 4 || (get_ver_major() == 4 && get_ver_minor() >= 4);
+	FilesystemCacheWriter w;
+	w.buffer.reserve(reports.size() * 192);
+	CharString curr_time = String::num_int64(OS::get_singleton()->get_unix_time()).utf8();
+	const String *current_dir = nullptr;
+	for (const FilesystemCacheEntry &entry : entries) {
+		const ExportReport *report = entry.report;
+		if (!current_dir || *current_dir != entry.dir) {
+			current_dir = &entry.dir;
+			w.append_literal("::");
+			w.append(entry.dir);
+			w.append_literal("::");
+			w.append(curr_time);
+			w.append_literal("\n");
+		}
 
-		String type = report->actual_type;
+		w.append(entry.file);
+		w.append_literal("::");
+		w.append(report->actual_type);
 		if (!report->script_class.is_empty()) {
-			type += "/" + String(report->script_class);
-		}
-
-		PackedStringArray cache_string;
-		cache_string.append(source_file.get_file());
-		cache_string.append(type);
-		cache_string.append(itos(ResourceUID::get_singleton()->text_to_id(report->get_import_info()->get_uid())));
-		cache_string.append(itos(report->modified_time));
-		cache_string.append(itos(report->import_modified_time));
-		cache_string.append(itos(1)); // TODO?
-		cache_string.append("");
-		Vector<String> parts = {
-			"",
-			"",
-			"",
-		};
+			w.append_literal("/");
+			w.append(report->script_class);
+		}
+		w.append_literal("::");
+		w.append_int(report->uid != ResourceUID::INVALID_ID ? report->uid : ResourceUID::get_singleton()->text_to_id(report->get_import_info()->get_uid()));
+		w.append_literal("::");
+		w.append_int(report->modified_time);
+		w.append_literal("::");
+		w.append_int(report->import_modified_time);
+		w.append_literal("::1::::"); // import_valid (TODO?), then an empty import_group_file
 		if (is_v4_4_or_newer) {
-			parts = { "", "", "", itos(0), itos(0), report->import_md5, String("<*>").join(report->get_import_info()->get_dest_files()) };
+			w.append_literal("<><><>0<>0<>");
+			w.append(report->import_md5);
+			w.append_literal("<>");
+			w.append_joined(report->get_import_info()->get_dest_files(), "<*>");
+		} else {
+			w.append_literal("<><>");
 		}
-		cache_string.append(String("<>").join(parts));
-		cache_string.append(String("<>").join(report->dependencies));
-
-		p_file->store_line(String("::").join(cache_string));
+		w.append_literal("::");
+		w.append_joined(report->dependencies, "<>");
+		w.append_literal("\n");
 	}
+	p_file->store_buffer(w.buffer.ptr(), w.buffer.size());
 }
 
 void save_filesystem_cache(const Vector<Ref<ExportReport>> &reports, String output_dir, bool is_partial_export) {
@@ -160,6 +226,23 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 		}
 	};
 	String new_md_path = output_dir.path_join(iinfo->get_import_md_path().replace("res://", ""));
+	// the md5 and modification time of the .import file are recorded as it's written, so it isn't read back later
+	bool recorded_import_stats = false;
+	auto save_import_file = [&]() {
+		Ref<ImportInfoModern> modern_iinfo = iinfo;
+		if (modern_iinfo.is_null()) {
+			return iinfo->save_to(new_md_path);
+		}
+		String md5;
+		uint64_t modified_time = 0;
+		Error save_err = modern_iinfo->save_to(new_md_path, md5, modified_time);
+		if (save_err == OK) {
+			report->import_md5 = md5;
+			report->import_modified_time = modified_time;
+			recorded_import_stats = true;
+		}
+		return save_err;
+	};
 
 	if (report->get_rewrote_metadata() == ExportReport::NOT_IMPORTABLE || !iinfo->is_import()) {
 		return;
@@ -167,7 +250,7 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 
 	if (err != OK) {
 		if ((err == ERR_UNAVAILABLE || err == ERR_PRINTER_ON_FIRE) && iinfo->get_ver_major() >= 4 && iinfo->is_dirty()) {
-			iinfo->save_to(new_md_path);
+			save_import_file();
 			if_err_func();
 		}
 		return;
@@ -186,7 +269,7 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 			err = rewrite_import_source(report->get_new_source_path(), iinfo);
 			if_err_func();
 		} else if (iinfo->is_dirty()) {
-			err = iinfo->save_to(new_md_path);
+			err = save_import_file();
 			if (err != OK) {
 				report->set_rewrote_metadata(ExportReport::FAILED);
 			} else if (!export_matches_source) {
@@ -195,7 +278,7 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 		}
 	} else if (iinfo->is_dirty()) {
 		if (err == OK) {
-			err = iinfo->save_to(new_md_path);
+			err = save_import_file();
 			if_err_func();
 		} else {
 			report->set_rewrote_metadata(ExportReport::NOT_IMPORTABLE);
@@ -218,19 +301,28 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 		}
 	}
 	if (!err && iinfo->get_ver_major() >= 4 && export_matches_source && report->get_rewrote_metadata() != ExportReport::NOT_IMPORTABLE) {
-		String resource_script_class;
-		List<String> deps;
 		auto path = iinfo->get_path();
-		auto res_info = ResourceCompatLoader::get_resource_info(path);
+		// exporters that already parsed the resource hand us its info and dependencies
+		auto res_info = report->resource_info.is_valid() ? report->resource_info : ResourceCompatLoader::get_resource_info(path);
 		report->actual_type = res_info.is_valid() ? res_info->type : iinfo->get_type();
 		report->script_class = res_info.is_valid() ? res_info->script_class : "";
-		ResourceCompatLoader::get_dependencies(path, &deps, false);
-		for (auto &dep : deps) {
-			report->dependencies.push_back(dep);
+		report->uid = ResourceUID::get_singleton()->text_to_id(iinfo->get_uid());
+		if (!report->dependencies_collected) {
+			List<String> deps;
+			ResourceCompatLoader::get_dependencies(path, &deps, false);
+			for (auto &dep : deps) {
+				report->dependencies.push_back(dep);
+			}
+			report->dependencies_collected = true;
+		}
+		if (!recorded_import_stats) {
+			// not rewritten by us, so the existing file has to be hashed
+			report->import_md5 = FileAccess::get_md5(new_md_path);
+			report->import_modified_time = FileAccess::get_modified_time(new_md_path);
+		}
+		if (report->modified_time <= 0) {
+			report->modified_time = FileAccess::get_modified_time(report->get_saved_path());
 		}
-		report->import_md5 = FileAccess::get_md5(new_md_path);
-		report->import_modified_time = FileAccess::get_modified_time(new_md_path);
-		report->modified_time = FileAccess::get_modified_time(report->get_saved_path());
 	}
 	if (!err && iinfo->get_ver_major() >= 4 && iinfo->get_metadata_prop().get("has_editor_variant", false)) {
 		// we need to make a copy of the resource with the editor variant
@@ -261,16 +353,24 @@ void ImportExporter::rewrite_metadata(ExportToken &token) {
 }
 
 Error ImportExporter::unzip_and_copy_addon(const Ref<ImportInfoGDExt> &iinfo, const String &zip_path) {
-	//append a random string
+	// Resolve the subtree we need from the zip's file list, then only inflate that subtree straight into the project
 	String output = output_dir;
-	String parent_tmp_dir = output_dir.path_join(".tmp").path_join(String::num_uint64(OS::get_singleton()->get_unix_time() + rand()));
-
-	String tmp_dir = parent_tmp_dir;
-	ERR_FAIL_COND_V_MSG(gdre::unzip_file_to_dir(zip_path, tmp_dir) != OK, ERR_FILE_CANT_WRITE, "Failed to unzip plugin zip to " + tmp_dir);
-	// copy the files to the output_dir
 	auto rel_gdext_path = iinfo->get_import_md_path().replace_first("res://", "");
-	Vector<String> addons = Glob::rglob(tmp_dir.path_join("**").path_join(rel_gdext_path.get_file()), true);
+	Vector<String> addons;
+	{
+		Ref<ZIPReader> zip;
+		zip.instantiate();
+		ERR_FAIL_COND_V_MSG(zip->open(zip_path) != OK, ERR_FILE_CANT_OPEN, "Failed to open plugin zip " + zip_path);
+		for (const String &file : zip->get_files()) {
+			if (file.get_file() == rel_gdext_path.get_file()) {
+				addons.push_back(file);
+			}
+		}
+		zip->close();
+	}
+	addons.sort();
 
+	String zip_subdir;
 	if (addons.size() > 0) {
 		// check if the addons directory exists
 		auto th = addons[0].simplify_path();
@@ -281,8 +381,7 @@ Error ImportExporter::unzip_and_copy_addon(const Ref<ImportInfoGDExt> &iinfo, co
 				output = output_dir.path_join("addons");
 			}
 			auto idx = th.find(rel_gdext_path);
-			auto subpath = th.substr(0, idx);
-			tmp_dir = th.substr(0, idx);
+			zip_subdir = th.substr(0, idx);
 		} else {
 			// what we are going to do is pop off the left-side parts of the rel_gdext_path until we find something that matches
 			String prefix = "";
@@ -295,7 +394,7 @@ Error ImportExporter::unzip_and_copy_addon(const Ref<ImportInfoGDExt> &iinfo, co
 					break;
 				}
 			}
-			tmp_dir = th.substr(0, th.find(suffix));
+			zip_subdir = th.substr(0, th.find(suffix));
 			output = output_dir.path_join(prefix);
 		}
 		if (addons.size() > 1) {
@@ -304,10 +403,9 @@ Error ImportExporter::unzip_and_copy_addon(const Ref<ImportInfoGDExt> &iinfo, co
 	} else {
 		ERR_FAIL_COND_V_MSG(addons.size() == 0, ERR_FILE_NOT_FOUND, "Failed to find our addon file in " + zip_path);
 	}
+	Error err = gdre::unzip_file_to_dir(zip_path, output, zip_subdir);
+	ERR_FAIL_COND_V_MSG(err != OK, ERR_FILE_CANT_WRITE, "Failed to unzip plugin files to " + output);
 	auto da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
-	Error err = da->copy_dir(tmp_dir, output);
-	ERR_FAIL_COND_V_MSG(err != OK, ERR_FILE_CANT_WRITE, "Failed to copy GodotSteam files to " + output_dir);
-	gdre::rimraf(parent_tmp_dir);
 	da->remove(zip_path);
 	return OK;
 }
@@ -336,8 +434,9 @@ void ImportExporter::_do_export(uint32_t i, ExportToken *tokens) {
 		return;
 	}
 
+	// Metadata changes stay in the ImportInfo until the metadata phase flushes them.
 	tokens[i].report = Exporter::export_resource(output_dir, tokens[i].iinfo);
-	rewrite_metadata(tokens[i]);
+	tokens[i].needs_metadata_rewrite = tokens[i].report.is_valid();
 	if (tokens[i].supports_multithread) {
 		tokens[i].report->append_error_messages(GDRELogger::get_thread_errors());
 	} else {
@@ -346,6 +445,17 @@ void ImportExporter::_do_export(uint32_t i, ExportToken *tokens) {
 	last_completed++;
 }
 
+void ImportExporter::_do_rewrite_metadata(uint32_t i, ExportToken *tokens) {
+	if (unlikely(cancelled)) {
+		return;
+	}
+	auto &token = tokens[i];
+	if (token.needs_metadata_rewrite) {
+		rewrite_metadata(token);
+		token.report->append_error_messages(GDRELogger::get_thread_errors());
+	}
+}
+
 String ImportExporter::get_export_token_description(uint32_t i, ExportToken *tokens) {
 	return tokens[i].iinfo.is_valid() ? tokens[i].iinfo->get_path() : "";
 }
@@ -415,6 +525,9 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 	reset_log();
 	ResourceCompatLoader::make_globally_available();
 	ResourceCompatLoader::set_default_gltf_load(false);
+	ResourceResolutionContext::clear_shared();
+	ResourceResolutionContext::reset_shared_stats();
+	gdre::OutputDeduplicator::reset();
 	report = Ref<ImportExporterReport>(memnew(ImportExporterReport(get_settings()->get_version_string())));
 	report->log_file_location = get_settings()->get_log_file_path();
 	ERR_FAIL_COND_V_MSG(!get_settings()->is_pack_loaded(), ERR_DOES_NOT_EXIST, "pack/dir not loaded!");
@@ -426,6 +539,20 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 		WARN_PRINT("No import files found!");
 		return OK;
 	}
+	// Cancelled exports return early; the report log must still be closed, and the last project's
+	// dependencies must not be kept alive in the shared LRU.
+	struct ExportCleanup {
+		gdre::ReportLogWriter &report_log;
+		~ExportCleanup() {
+			if (report_log.is_open()) {
+				report_log.close();
+			}
+			ResourceResolutionContext::clear_shared();
+		}
+	} cleanup{ report_log };
+	if (!report->log_file_location.is_empty()) {
+		report_log.open(report->log_file_location.get_basename() + "_export_report.jsonl");
+	}
 	bool partial_export = (_files_to_export.size() > 0 && _files_to_export.size() != get_settings()->get_file_count());
 	size_t export_files_count = partial_export ? _files_to_export.size() : _files.size();
 	const Vector<String> files_to_export = partial_export ? _files_to_export : get_settings()->get_file_list();
@@ -661,6 +788,7 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 
 	int64_t num_multithreaded_tokens = tokens.size();
 	// ***** Export resources *****
+	uint64_t export_start = OS::get_singleton()->get_ticks_msec();
 	GDRELogger::clear_error_queues();
 	if (tokens.size() > 0) {
 		last_completed = -1;
@@ -699,7 +827,48 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 	// 	print_line("Export cancelled!");
 	// 	return err;
 	// }
+	uint64_t metadata_start = OS::get_singleton()->get_ticks_msec();
+	print_verbose("Exporting resources took " + itos(metadata_start - export_start) + "ms");
+
+	// ***** Rewrite metadata *****
+	// Done as a separate pass so the .import writes don't contend with the exporters for I/O.
+	// Tokens that had to be exported on this thread have their metadata rewritten on it too.
+	GDRELogger::clear_error_queues();
+	if (tokens.size() > 0) {
+		err = TaskManager::get_singleton()->run_multithreaded_group_task(
+				this,
+				&ImportExporter::_do_rewrite_metadata,
+				tokens.ptrw(),
+				tokens.size(),
+				&ImportExporter::get_export_token_description,
+				"ImportExporter::rewrite_metadata",
+				"Rewriting import metadata...",
+				true, -1, true, pr, 0);
+		if (err != OK) {
+			print_line("Export cancelled!");
+			return err;
+		}
+	}
+	GDRELogger::clear_error_queues();
+	if (non_multithreaded_tokens.size() > 0) {
+		err = TaskManager::get_singleton()->run_task_on_current_thread(
+				this,
+				&ImportExporter::_do_rewrite_metadata,
+				non_multithreaded_tokens.ptrw(),
+				non_multithreaded_tokens.size(),
+				&ImportExporter::get_export_token_description,
+				"ImportExporter::rewrite_metadata",
+				"Rewriting import metadata...",
+				true, pr, num_multithreaded_tokens);
+		if (err != OK) {
+			print_line("Export cancelled!");
+			return err;
+		}
+	}
 	tokens.append_array(non_multithreaded_tokens);
+	uint64_t finalize_start = OS::get_singleton()->get_ticks_msec();
+	print_verbose("Rewriting import metadata took " + itos(finalize_start - metadata_start) + "ms");
+
 	pr->step("Finalizing...", tokens.size() - 1, true);
 	report->session_files_total = tokens.size();
 	// add to report
@@ -712,31 +881,25 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 		Ref<ExportReport> ret = token.report;
 		if (ret.is_null()) {
 			ERR_PRINT("Exporter returned null report for " + iinfo->get_path());
-			report->failed.push_back(ret);
+			report_log.append(ret, report->add_export_result(iinfo, ret));
 			continue;
 		}
 		err = ret->get_error();
-		if (err == ERR_SKIP) {
-			report->not_converted.push_back(ret);
-			continue;
-		} else if (err == ERR_UNAVAILABLE) {
+		if (err == ERR_UNAVAILABLE) {
 			String type = iinfo->get_type();
 			String format_type = src_ext;
 			if (ret->get_unsupported_format_type() != "") {
 				format_type = ret->get_unsupported_format_type();
 			}
 			report_unsupported_resource(type, format_type, iinfo->get_path());
-			report->not_converted.push_back(ret);
-			continue;
-		} else if (err != OK) {
-			if (iinfo->get_importer() == "script_bytecode") {
-				report->failed_scripts.push_back(iinfo->get_path());
-				if (err == ERR_UNAUTHORIZED) {
-					report->had_encryption_error = true;
-				}
+		} else if (err != OK && err != ERR_SKIP) {
+			if (iinfo->get_importer() == "script_bytecode" && err == ERR_UNAUTHORIZED) {
+				report->had_encryption_error = true;
 			}
-			report->failed.push_back(ret);
 			print_verbose("Failed to convert " + iinfo->get_type() + " resource " + iinfo->get_path());
+		}
+		if (err != OK) {
+			report_log.append(ret, report->add_export_result(iinfo, ret));
 			continue;
 		}
 		if (iinfo->get_importer() == "scene" && src_ext != "escn" && src_ext != "tscn") {
@@ -772,51 +935,39 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 		} else if (iinfo->get_importer() == "csv_translation" || iinfo->get_importer() == "translation_csv" || iinfo->get_importer() == "translation") {
 			report->translation_export_message += ret->get_message();
 		} else if (iinfo->get_importer() == "script_bytecode") {
-			report->decompiled_scripts.push_back(iinfo->get_path());
 			// 4.4 and higher have uid files for scripts that we have to recreate
 			if ((get_ver_major() == 4 && get_ver_minor() >= 4) || get_ver_major() > 4) {
 				recreate_uid_file(iinfo->get_source_file(), true, files_to_export_set);
 			}
 		}
-		// ***** Record export result *****
-		auto metadata_status = ret->get_rewrote_metadata();
-		// the following are successful exports, but we failed to rewrite metadata or write md5 files
-		if (metadata_status == ExportReport::REWRITTEN) {
-			report->rewrote_metadata.push_back(ret);
-		} else if (metadata_status == ExportReport::NOT_IMPORTABLE || metadata_status == ExportReport::FAILED) {
-			// necessary to rewrite import metadata but failed to do so
-			report->failed_rewrite_md.push_back(ret);
-		} else if (metadata_status == ExportReport::MD5_FAILED) {
-			report->failed_rewrite_md5.push_back(ret);
-		}
-		if (ret->get_loss_type() != ImportInfo::LOSSLESS) {
-			report->lossy_imports.push_back(ret);
-		}
+		// GDExtension/GDNative libraries are downloaded in the background; the export only succeeds once they're copied
+		String gdnative_copy_error;
+		bool gdnative_copy_failed = false;
 		if (iinfo->get_importer() == "gdextension" || iinfo->get_importer() == "gdnative") {
 			if (!ret->get_message().is_empty()) {
-				report->failed_gdnative_copy.push_back(ret->get_message());
+				gdnative_copy_error = ret->get_message();
 			} else if (!ret->get_saved_path().is_empty() && ret->get_download_task_id() != -1) {
 				Ref<ImportInfoGDExt> iinfo_gdext = iinfo;
 				Error err = TaskManager::get_singleton()->wait_for_download_task_completion(ret->get_download_task_id());
-				if (err != OK) {
-					report->failed_gdnative_copy.push_back(ret->get_saved_path());
-					continue;
-				}
-				if (!iinfo_gdext.is_valid()) {
+				if (err == OK && !iinfo_gdext.is_valid()) {
 					// wtf?
 					ERR_PRINT("Invalid ImportInfoGDExt");
-					report->failed_gdnative_copy.push_back(ret->get_saved_path());
-					continue;
+					err = ERR_BUG;
+				}
+				if (err == OK) {
+					err = unzip_and_copy_addon(iinfo, ret->get_saved_path());
 				}
-				err = unzip_and_copy_addon(iinfo, ret->get_saved_path());
 				if (err != OK) {
-					report->failed_gdnative_copy.push_back(ret->get_saved_path());
-					continue;
+					gdnative_copy_error = ret->get_saved_path();
+					gdnative_copy_failed = true;
 				}
 			}
 		}
-		report->success.push_back(ret);
-		success_paths.insert(iinfo->get_export_dest());
+		// ***** Record export result *****
+		report_log.append(ret, report->add_export_result(iinfo, ret, gdnative_copy_error, gdnative_copy_failed));
+		if (!gdnative_copy_failed) {
+			success_paths.insert(iinfo->get_export_dest());
+		}
 	}
 
 	// remove remaps
@@ -860,6 +1011,18 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 		}
 	}
 	pr = nullptr;
+	report->dedup_files = gdre::OutputDeduplicator::get_files_deduplicated();
+	report->dedup_bytes_saved = gdre::OutputDeduplicator::get_bytes_saved();
+	report->shared_cache_hits = ResourceResolutionContext::get_shared_hits();
+	report->shared_cache_misses = ResourceResolutionContext::get_shared_misses();
+	report->shared_cache_evictions = ResourceResolutionContext::get_shared_evictions();
+	if (report_log.is_open()) {
+		// these sections count type/format pairs and plugin folders rather than exported files
+		report_log.add_to_totals("unsupported_types", report->unsupported_types.size());
+		report_log.add_to_totals("failed_plugin_cfg_create", report->failed_plugin_cfg_create.size());
+		report->report_log_location = report_log.get_path();
+		report_log.close();
+	}
 	report->print_report();
 	ResourceCompatLoader::set_default_gltf_load(false);
 	ResourceCompatLoader::unmake_globally_available();
@@ -875,9 +1038,9 @@ Error ImportExporter::export_imports(const String &p_out_dir, const Vector<Strin
 				reports.push_back(token.report);
 			}
 		}
-		reports.sort_custom<ReportComparator>();
 		save_filesystem_cache(reports, output_dir, partial_export);
 	}
+	print_verbose("Finalizing export took " + itos(OS::get_singleton()->get_ticks_msec() - finalize_start) + "ms");
 	return OK;
 }
 
@@ -1050,6 +1213,56 @@ String ImportExporterReport::get_ver() {
 	return ver->as_text();
 }
 
+Vector<String> ImportExporterReport::add_export_result(const Ref<ImportInfo> &p_iinfo, const Ref<ExportReport> &p_report, const String &p_gdnative_copy_error, bool p_gdnative_copy_failed) {
+	Vector<String> sections;
+	auto add_to = [&](Vector<Ref<ExportReport>> &r_section, const String &p_name) {
+		r_section.push_back(p_report);
+		sections.push_back(p_name);
+	};
+	if (p_report.is_null()) {
+		add_to(failed, "failed");
+		return sections;
+	}
+	bool is_script = p_iinfo.is_valid() && p_iinfo->get_importer() == "script_bytecode";
+	Error err = p_report->get_error();
+	if (err == ERR_SKIP || err == ERR_UNAVAILABLE) {
+		add_to(not_converted, "not_converted");
+		return sections;
+	} else if (err != OK) {
+		if (is_script) {
+			failed_scripts.push_back(p_iinfo->get_path());
+			sections.push_back("failed_scripts");
+		}
+		add_to(failed, "failed");
+		return sections;
+	}
+	if (is_script) {
+		decompiled_scripts.push_back(p_iinfo->get_path());
+		sections.push_back("decompiled_scripts");
+	}
+	// the following are successful exports, but we failed to rewrite metadata or write md5 files
+	auto metadata_status = p_report->get_rewrote_metadata();
+	if (metadata_status == ExportReport::REWRITTEN) {
+		add_to(rewrote_metadata, "rewrote_metadata");
+	} else if (metadata_status == ExportReport::NOT_IMPORTABLE || metadata_status == ExportReport::FAILED) {
+		// necessary to rewrite import metadata but failed to do so
+		add_to(failed_rewrite_md, "failed_rewrite_md");
+	} else if (metadata_status == ExportReport::MD5_FAILED) {
+		add_to(failed_rewrite_md5, "failed_rewrite_md5");
+	}
+	if (p_report->get_loss_type() != ImportInfo::LOSSLESS) {
+		add_to(lossy_imports, "lossy_imports");
+	}
+	if (!p_gdnative_copy_error.is_empty()) {
+		failed_gdnative_copy.push_back(p_gdnative_copy_error);
+		sections.push_back("failed_gdnative_copy");
+	}
+	if (!p_gdnative_copy_failed) {
+		add_to(success, "success");
+	}
+	return sections;
+}
+
 Dictionary ImportExporterReport::get_totals() {
 	Dictionary totals;
 	totals["total"] = decompiled_scripts.size() + failed_scripts.size() + lossy_imports.size() + rewrote_metadata.size() + failed_rewrite_md.size() + failed_rewrite_md5.size() + failed.size() + success.size() + not_converted.size() + failed_plugin_cfg_create.size() + failed_gdnative_copy.size() + unsupported_types.size();
@@ -1066,6 +1279,11 @@ Dictionary ImportExporterReport::get_totals() {
 	totals["failed_plugin_cfg_create"] = failed_plugin_cfg_create.size();
 	totals["failed_gdnative_copy"] = failed_gdnative_copy.size();
 	totals["unsupported_types"] = unsupported_types.size();
+	totals["deduplicated_files"] = dedup_files;
+	totals["deduplicated_bytes_saved"] = dedup_bytes_saved;
+	totals["shared_resource_cache_hits"] = shared_cache_hits;
+	totals["shared_resource_cache_misses"] = shared_cache_misses;
+	totals["shared_resource_cache_evictions"] = shared_cache_evictions;
 	return totals;
 }
 
@@ -1185,6 +1403,12 @@ String ImportExporterReport::get_totals_string() {
 	report += vformat("%-40s", "Non-importable conversions: ") + itos(failed_rewrite_md.size()) + String("\n");
 	report += vformat("%-40s", "Not converted: ") + itos(not_converted.size()) + String("\n");
 	report += vformat("%-40s", "Failed conversions: ") + itos(failed.size()) + String("\n");
+	if (dedup_files > 0) {
+		report += vformat("%-40s", "Deduplicated files: ") + itos(dedup_files) + " (" + String::humanize_size(dedup_bytes_saved) + " saved)" + String("\n");
+	}
+	if (shared_cache_hits + shared_cache_misses > 0) {
+		report += vformat("%-40s", "Shared scene dependency cache: ") + vformat("%d hits, %d misses, %d evictions", shared_cache_hits, shared_cache_misses, shared_cache_evictions) + String("\n");
+	}
 	return report;
 }
 
@@ -1421,6 +1645,10 @@ String ImportExporterReport::get_log_file_location() {
 	return log_file_location;
 }
 
+String ImportExporterReport::get_report_log_location() {
+	return report_log_location;
+}
+
 Vector<String> ImportExporterReport::get_decompiled_scripts() {
 	return decompiled_scripts;
 }
@@ -1480,7 +1708,13 @@ bool ImportExporterReport::is_steam_detected() const {
 
 void ImportExporterReport::print_report() {
 	print_line("\n\n********************************EXPORT REPORT********************************" + String("\n"));
-	print_line(get_report_string());
+	// Building the full report string is slow for very large projects; the per-file log has everything.
+	if (!report_log_location.is_empty() && session_files_total > MAX_INLINE_REPORT_FILES) {
+		print_line(get_totals_string());
+		print_line("Per-file report written to " + report_log_location);
+	} else {
+		print_line(get_report_string());
+	}
 	String notes = get_session_notes_string();
 	if (!notes.is_empty()) {
 		print_line("\n\n---------------------------------IMPORTANT NOTES----------------------------------" + String("\n"));
@@ -1501,6 +1735,7 @@ void ImportExporterReport::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_session_notes_string"), &ImportExporterReport::get_session_notes_string);
 	ClassDB::bind_method(D_METHOD("get_editor_message_string"), &ImportExporterReport::get_editor_message_string);
 	ClassDB::bind_method(D_METHOD("get_log_file_location"), &ImportExporterReport::get_log_file_location);
+	ClassDB::bind_method(D_METHOD("get_report_log_location"), &ImportExporterReport::get_report_log_location);
 	ClassDB::bind_method(D_METHOD("get_decompiled_scripts"), &ImportExporterReport::get_decompiled_scripts);
 	ClassDB::bind_method(D_METHOD("get_failed_scripts"), &ImportExporterReport::get_failed_scripts);
 	ClassDB::bind_method(D_METHOD("get_successes"), &ImportExporterReport::get_successes);
@@ -5,6 +5,7 @@
 #include "exporters/export_report.h"
 #include "import_info.h"
 #include "utility/godotver.h"
+#include "utility/report_log.h"
 
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
@@ -14,11 +15,19 @@ class ImportExporter;
 class ImportExporterReport : public RefCounted {
 	GDCLASS(ImportExporterReport, RefCounted)
 	friend class ImportExporter;
+	friend class ExportReportModel;
+	static constexpr int MAX_INLINE_REPORT_FILES = 20000;
 	bool had_encryption_error = false;
 	bool godotsteam_detected = false;
 	bool exported_scenes = false;
 	int session_files_total = 0;
+	uint64_t dedup_files = 0;
+	uint64_t dedup_bytes_saved = 0;
+	uint64_t shared_cache_hits = 0;
+	uint64_t shared_cache_misses = 0;
+	uint64_t shared_cache_evictions = 0;
 	String log_file_location;
+	String report_log_location;
 	Vector<String> decompiled_scripts;
 	Vector<String> failed_scripts;
 	String translation_export_message;
@@ -43,6 +52,9 @@ public:
 		opt_lossy = lossy;
 	}
 
+	// Adds a finished export to the report sections it belongs to and returns their names, as used by get_totals.
+	// p_gdnative_copy_error is recorded in failed_gdnative_copy; p_gdnative_copy_failed also keeps it out of success.
+	Vector<String> add_export_result(const Ref<ImportInfo> &p_iinfo, const Ref<ExportReport> &p_report, const String &p_gdnative_copy_error = String(), bool p_gdnative_copy_failed = false);
 	Dictionary get_totals();
 	Dictionary get_unsupported_types();
 	Dictionary get_section_labels();
@@ -57,6 +69,7 @@ public:
 	String get_session_notes_string();
 
 	String get_log_file_location();
+	String get_report_log_location();
 	Vector<String> get_decompiled_scripts();
 	Vector<String> get_failed_scripts();
 	String get_translation_export_message();
@@ -107,10 +120,13 @@ class ImportExporter : public RefCounted {
 		Ref<ImportInfo> iinfo;
 		Ref<ExportReport> report;
 		bool supports_multithread;
+		bool needs_metadata_rewrite = false;
 	};
 
 	Ref<ImportExporterReport> report;
+	gdre::ReportLogWriter report_log;
 	void _do_export(uint32_t i, ExportToken *tokens);
+	void _do_rewrite_metadata(uint32_t i, ExportToken *tokens);
 	String get_export_token_description(uint32_t i, ExportToken *tokens);
 	Error handle_auto_converted_file(const String &autoconverted_file);
 	Error rewrite_import_source(const String &rel_dest_path, const Ref<ImportInfo> &iinfo);
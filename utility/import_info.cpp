@@ -1,6 +1,7 @@
 #include "import_info.h"
 #include "compat/resource_compat_binary.h"
 #include "compat/resource_loader_compat.h"
+#include "core/crypto/crypto_core.h"
 #include "core/error/error_list.h"
 #include "gdre_settings.h"
 #include "utility/common.h"
@@ -825,10 +826,23 @@ void ImportInfov2::set_params(Dictionary params) {
 }
 
 Error ImportInfoModern::save_to(const String &new_import_file) {
+	String md5;
+	uint64_t modified_time;
+	return save_to(new_import_file, md5, modified_time);
+}
+
+Error ImportInfoModern::save_to(const String &new_import_file, String &r_md5, uint64_t &r_modified_time) {
 	Error err = gdre::ensure_dir(new_import_file.get_base_dir());
 	ERR_FAIL_COND_V_MSG(err, err, "Failed to create directory for " + new_import_file);
-	err = cf->save(new_import_file);
-	ERR_FAIL_COND_V_MSG(err, err, "Failed to rename file " + import_md_path + ".tmp");
+	// Serialized in memory and written in one go instead of ConfigFile::save's per-line writes; the modification
+	// time comes from the write handle, so the file isn't stat'ed again
+	Vector<uint8_t> text = cf->encode_to_text().to_utf8_buffer();
+	err = gdre::write_file_get_modified_time(new_import_file, text, r_modified_time);
+	ERR_FAIL_COND_V_MSG(err, err, "Failed to write " + new_import_file);
+
+	unsigned char hash[16];
+	CryptoCore::md5(text.ptr(), text.size(), hash);
+	r_md5 = String::hex_encode_buffer(hash, 16);
 	return OK;
 }
 
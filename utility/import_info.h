@@ -233,6 +233,9 @@ public:
 	virtual void set_params(Dictionary params) override;
 
 	virtual Error save_to(const String &p_path) override;
+	// Same as save_to, but also returns the md5 of the written contents and the file's modification time
+	// without reading the file back.
+	Error save_to(const String &p_path, String &r_md5, uint64_t &r_modified_time);
 	Error save_md5_file(const String &output_dir);
 	String get_md5_file_path() const;
 
@@ -0,0 +1,187 @@
+#include "output_dedup.h"
+
+#include "core/crypto/crypto_core.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "utility/common.h"
+#include "utility/file_access_archive.h"
+#include "utility/gdre_config.h"
+
+#if defined(WINDOWS_ENABLED)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(UNIX_ENABLED)
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+#endif
+
+using namespace gdre;
+
+ParallelFlatHashMap<String, OutputDeduplicator::Entry> OutputDeduplicator::table;
+std::atomic<uint64_t> OutputDeduplicator::bytes_saved = 0;
+std::atomic<uint64_t> OutputDeduplicator::files_deduplicated = 0;
+
+bool OutputDeduplicator::is_enabled() {
+	// links are made with native calls, which can't see into archive output
+	if (ArchiveOutput::is_active()) {
+		return false;
+	}
+	return GDREConfig::get_singleton()->get_setting("Exporter/deduplicate_output_files", false);
+}
+
+void OutputDeduplicator::reset() {
+	table.clear();
+	bytes_saved = 0;
+	files_deduplicated = 0;
+}
+
+String OutputDeduplicator::_make_key(const String &p_md5, uint64_t p_size) {
+	return p_md5 + ":" + String::num_uint64(p_size);
+}
+
+bool OutputDeduplicator::_entry_still_valid(const Entry &p_entry) {
+	if (!p_entry.complete) {
+		return false;
+	}
+	Ref<FileAccess> f = FileAccess::open(p_entry.path, FileAccess::READ);
+	return f.is_valid() && f->get_length() == p_entry.size && FileAccess::get_modified_time(p_entry.path) == p_entry.modified_time;
+}
+
+Error OutputDeduplicator::_link(const String &p_existing, const String &p_new) {
+	if (!p_existing.is_absolute_path() || p_existing.begins_with("res://") || p_existing.begins_with("user://")) {
+		return ERR_UNAVAILABLE;
+	}
+	String tmp = p_new + ".dedup_tmp";
+	bool linked = false;
+#if defined(WINDOWS_ENABLED)
+	linked = CreateHardLinkW((LPCWSTR)tmp.utf16().get_data(), (LPCWSTR)p_existing.utf16().get_data(), nullptr);
+#elif defined(UNIX_ENABLED)
+	CharString existing_utf8 = p_existing.utf8();
+	CharString tmp_utf8 = tmp.utf8();
+	linked = ::link(existing_utf8.get_data(), tmp_utf8.get_data()) == 0;
+#ifdef __linux__
+	if (!linked) {
+		// different filesystem or hardlinks unsupported: try a copy-on-write clone
+		int src_fd = ::open(existing_utf8.get_data(), O_RDONLY);
+		if (src_fd >= 0) {
+			int dst_fd = ::open(tmp_utf8.get_data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (dst_fd >= 0) {
+				linked = ::ioctl(dst_fd, FICLONE, src_fd) == 0;
+				::close(dst_fd);
+				if (!linked) {
+					::unlink(tmp_utf8.get_data());
+				}
+			}
+			::close(src_fd);
+		}
+	}
+#endif
+#endif
+	if (!linked) {
+		return ERR_UNAVAILABLE;
+	}
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->rename(tmp, p_new) != OK) {
+		da->remove(tmp);
+		return ERR_FILE_CANT_WRITE;
+	}
+	return OK;
+}
+
+void OutputDeduplicator::unlink_existing(const String &p_path) {
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->file_exists(p_path)) {
+		da->remove(p_path);
+	}
+}
+
+Error OutputDeduplicator::try_link(const String &p_path, const String &p_md5, uint64_t p_size) {
+	if (!is_enabled() || p_size == 0) {
+		return ERR_UNAVAILABLE;
+	}
+	Entry existing;
+	bool found = false;
+	table.try_emplace_l(
+			_make_key(p_md5, p_size),
+			[&](auto &v) {
+				existing = v.second;
+				found = true;
+			},
+			Entry{ p_path, p_size, 0, false });
+	if (!found || existing.path == p_path || !_entry_still_valid(existing)) {
+		return ERR_DOES_NOT_EXIST;
+	}
+	gdre::ensure_dir(p_path.get_base_dir());
+	if (_link(existing.path, p_path) != OK) {
+		return ERR_UNAVAILABLE;
+	}
+	bytes_saved += p_size;
+	files_deduplicated++;
+	return OK;
+}
+
+void OutputDeduplicator::register_written(const String &p_path, const String &p_md5, uint64_t p_size) {
+	if (!is_enabled() || p_size == 0) {
+		return;
+	}
+	Entry written{ p_path, p_size, FileAccess::get_modified_time(p_path), true };
+	Entry existing;
+	bool replace = false;
+	table.try_emplace_l(
+			_make_key(p_md5, p_size),
+			[&](auto &v) {
+				if (v.second.path == p_path || !v.second.complete) {
+					// our own claim from try_link, or a claim by a writer that hasn't finished; take it over
+					v.second = written;
+				} else {
+					existing = v.second;
+					replace = true;
+				}
+			},
+			written);
+	if (!replace) {
+		return;
+	}
+	if (!_entry_still_valid(existing)) {
+		table.modify_if(_make_key(p_md5, p_size), [&](auto &v) { v.second = written; });
+		return;
+	}
+	if (_link(existing.path, p_path) == OK) {
+		bytes_saved += p_size;
+		files_deduplicated++;
+	}
+}
+
+Error OutputDeduplicator::write_file(const String &p_path, const uint8_t *p_data, uint64_t p_size) {
+	String md5;
+	if (is_enabled()) {
+		unsigned char hash[16];
+		CryptoCore::md5(p_data, p_size, hash);
+		md5 = String::hex_encode_buffer(hash, 16);
+		if (try_link(p_path, md5, p_size) == OK) {
+			return OK;
+		}
+	}
+	Error err = gdre::ensure_dir(p_path.get_base_dir());
+	ERR_FAIL_COND_V_MSG(err, err, "Failed to create directory for " + p_path);
+	unlink_existing(p_path);
+	{
+		Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(file.is_null(), !err ? ERR_FILE_CANT_WRITE : err, "Cannot open file '" + p_path + "' for writing.");
+		file->store_buffer(p_data, p_size);
+		ERR_FAIL_COND_V_MSG(file->get_error() != OK && file->get_error() != ERR_FILE_EOF, ERR_FILE_CANT_WRITE, "Failed to write " + p_path);
+	}
+	if (!md5.is_empty()) {
+		register_written(p_path, md5, p_size);
+	}
+	return OK;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/string/ustring.h"
+#include "utility/gd_parallel_hashmap.h"
+
+#include <atomic>
+
+// Replaces byte-identical output files with hardlinks (or reflinks) to the first copy written.
+// Keyed by MD5 + size; the first copy's size and mtime are re-checked before linking so that a
+// file that was rewritten since it was recorded is never linked to.
+namespace gdre {
+
+class OutputDeduplicator {
+	struct Entry {
+		String path;
+		uint64_t size = 0;
+		uint64_t modified_time = 0;
+		bool complete = false;
+	};
+
+	static ParallelFlatHashMap<String, Entry> table;
+	static std::atomic<uint64_t> bytes_saved;
+	static std::atomic<uint64_t> files_deduplicated;
+
+	static String _make_key(const String &p_md5, uint64_t p_size);
+	static bool _entry_still_valid(const Entry &p_entry);
+	static Error _link(const String &p_existing, const String &p_new);
+
+public:
+	static bool is_enabled();
+	static void reset();
+
+	// Removes an existing file at p_path. Outputs may be links to each other (also from an earlier run into the same
+	// directory), and opening one for writing would truncate every linked copy, so writers call this first.
+	static void unlink_existing(const String &p_path);
+
+	// Call before writing p_path when its contents are already known. Returns OK if p_path was created
+	// as a link to an identical earlier output and the write can be skipped; otherwise the caller
+	// writes the file and then calls register_written.
+	static Error try_link(const String &p_path, const String &p_md5, uint64_t p_size);
+	// Records a freshly written file. If an identical file was already recorded, p_path is replaced
+	// with a link to it.
+	static void register_written(const String &p_path, const String &p_md5, uint64_t p_size);
+	// Convenience for in-memory outputs: links if possible, otherwise writes p_data and records it.
+	static Error write_file(const String &p_path, const uint8_t *p_data, uint64_t p_size);
+
+	static uint64_t get_bytes_saved() { return bytes_saved; }
+	static uint64_t get_files_deduplicated() { return files_deduplicated; }
+};
+
+} // namespace gdre
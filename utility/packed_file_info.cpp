@@ -1,5 +1,7 @@
 #include "packed_file_info.h"
 
+#include "utility/file_access_gdre.h"
+
 void PackedFileInfo::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_pack"), &PackedFileInfo::get_pack);
 	ClassDB::bind_method(D_METHOD("get_path"), &PackedFileInfo::get_path);
@@ -13,11 +15,32 @@ void PackedFileInfo::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_checksum_validated"), &PackedFileInfo::is_checksum_validated);
 }
 
+void PackedFileInfo::set_md5_match(bool pass) {
+	md5_passed = pass;
+	// the file table is the source of truth; keyed by record so malformed raw paths still find theirs
+	if (GDREPackedData::get_singleton() && record_index != UINT32_MAX) {
+		GDREPackedData::get_singleton()->set_md5_passed(record_index, table_generation, pass);
+	}
+}
+
+uint64_t PackedFileInfo::get_size() {
+	if (size_pending) {
+		int64_t size = GDREPackedData::get_singleton() ? GDREPackedData::get_singleton()->get_file_size(path) : -1;
+		pf.size = MAX(size, 0);
+		size_pending = false;
+	}
+	return pf.size;
+}
+
 #define PATH_REPLACER "_"
 
 void PackedFileInfo::fix_path() {
-	path = raw_path;
-	malformed_path = false;
+	path = get_fixed_path(raw_path, malformed_path);
+}
+
+String PackedFileInfo::get_fixed_path(const String &p_raw_path, bool &r_malformed) {
+	String path = p_raw_path;
+	r_malformed = false;
 	String prefix = "";
 
 	//remove prefix first
@@ -34,63 +57,64 @@ void PackedFileInfo::fix_path() {
 
 	while (path.begins_with("~")) {
 		path = path.substr(1, path.length() - 1);
-		malformed_path = true;
+		r_malformed = true;
 	}
 
 	while (path.begins_with("/") || path.begins_with("./")) {
 		while (path.begins_with("/")) {
 			path = path.substr(1, path.length() - 1);
-			malformed_path = true;
+			r_malformed = true;
 		}
 		while (path.begins_with("./")) {
 			path = path.substr(2, path.length() - 1);
-			malformed_path = true;
+			r_malformed = true;
 		}
 	}
 
 	if (path.find("//") >= 0) {
 		path = path.replace("//", "/");
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("/./") >= 0) {
 		path = path.replace("/./", "/");
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("\\") >= 0) {
 		path = path.replace("\\", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find(":") >= 0) {
 		path = path.replace(":", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("|") >= 0) {
 		path = path.replace("|", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("?") >= 0) {
 		path = path.replace("?", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find(">") >= 0) {
 		path = path.replace(">", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("<") >= 0) {
 		path = path.replace("<", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("*") >= 0) {
 		path = path.replace("*", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 	if (path.find("\"") >= 0) {
 		path = path.replace("\"", PATH_REPLACER);
-		malformed_path = true;
+		r_malformed = true;
 	}
 
 	// add the prefix back
 	if (prefix != "") {
 		path = prefix + path;
 	}
+	return path;
 }
\ No newline at end of file
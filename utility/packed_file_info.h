@@ -13,15 +13,22 @@ class PackedFileInfo : public RefCounted {
 	friend class GDREPackedSource;
 	friend class APKArchive;
 	friend class GDREFolderSource;
+	friend class GDREPackedData;
+	friend class ProjectLoader;
 
 	String path;
 	String raw_path;
 	PackedData::PackedFile pf;
 	bool malformed_path;
 	bool md5_passed = false;
+	// folder sources only stat a file's size when it's first asked for
+	bool size_pending = false;
+	// the GDREPackedData record this was made from
+	uint32_t record_index = UINT32_MAX;
+	uint64_t table_generation = 0;
 	uint32_t flags;
 
-	void set_md5_match(bool pass) { md5_passed = pass; }
+	void set_md5_match(bool pass);
 
 public:
 	void init(const String &p_path, const PackedData::PackedFile *pfstruct) {
@@ -45,7 +52,7 @@ public:
 	String get_path() const { return path; }
 	String get_raw_path() const { return raw_path; }
 	uint64_t get_offset() const { return pf.offset; }
-	uint64_t get_size() const { return pf.size; }
+	uint64_t get_size();
 	Vector<uint8_t> get_md5() const {
 		Vector<uint8_t> ret;
 		ret.resize(16);
@@ -72,6 +79,10 @@ protected:
 
 private:
 	void fix_path();
+
+public:
+	// Returns the sanitized form of p_raw_path, as used for get_path().
+	static String get_fixed_path(const String &p_raw_path, bool &r_malformed);
 };
 
 #endif
\ No newline at end of file
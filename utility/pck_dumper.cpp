@@ -2,9 +2,11 @@
 #include "core/error/error_list.h"
 #include "gdre_settings.h"
 
+#include "core/crypto/crypto_core.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "utility/common.h"
+#include "utility/output_dedup.h"
 #include "utility/packed_file_info.h"
 
 #include <utility/gdre_standalone.h>
@@ -140,6 +142,14 @@ void PckDumper::_do_extract(uint32_t i, ExtractToken *tokens) {
 		tokens[i].err = ERR_CANT_CREATE;
 		return;
 	}
+	bool dedup = gdre::OutputDeduplicator::is_enabled();
+	// a verified index md5 lets us link a duplicate before writing a single byte
+	if (dedup && file->md5_passed && gdre::OutputDeduplicator::try_link(target_name, String::hex_encode_buffer(file->get_md5().ptr(), 16), file->get_size()) == OK) {
+		completed_cnt++;
+		print_verbose("Linked duplicate " + target_name);
+		return;
+	}
+	gdre::OutputDeduplicator::unlink_existing(target_name);
 	Ref<FileAccess> fa = FileAccess::open(target_name, FileAccess::WRITE, &err);
 	if (err || fa.is_null()) {
 		broken_cnt++;
@@ -148,14 +158,27 @@ void PckDumper::_do_extract(uint32_t i, ExtractToken *tokens) {
 		return;
 	}
 
+	CryptoCore::MD5Context md5_ctx;
+	if (dedup) {
+		md5_ctx.start();
+	}
 	int64_t rq_size = file->get_size();
 	uint8_t buf[16384];
 	while (rq_size > 0) {
 		int got = pck_f->get_buffer(buf, MIN(16384, rq_size));
 		fa->store_buffer(buf, got);
+		if (dedup && got > 0) {
+			md5_ctx.update(buf, got);
+		}
 		rq_size -= 16384;
 	}
 	fa->flush();
+	fa.unref();
+	if (dedup) {
+		unsigned char hash[16];
+		md5_ctx.finish(hash);
+		gdre::OutputDeduplicator::register_written(target_name, String::hex_encode_buffer(hash, 16), file->get_size());
+	}
 	completed_cnt++;
 	if (file->is_malformed() && file->get_raw_path() != file->get_path()) {
 		print_line("Warning: " + file->get_raw_path() + " is a malformed path!\nSaving to " + file->get_path() + " instead.");
@@ -170,6 +193,7 @@ Error PckDumper::_pck_dump_to_dir(
 	ERR_FAIL_COND_V_MSG(!GDRESettings::get_singleton()->is_pack_loaded(), ERR_DOES_NOT_EXIST,
 			"Pack not loaded!");
 	reset();
+	gdre::OutputDeduplicator::reset();
 	output_dir = dir;
 	auto files = GDRESettings::get_singleton()->get_file_info_list();
 
@@ -14,6 +14,9 @@ int PluginManager::source_count = 0;
 bool PluginManager::prepopping = false;
 HashMap<String, PluginVersion> PluginManager::plugin_version_cache;
 Mutex PluginManager::plugin_version_cache_mutex;
+std::atomic<bool> PluginManager::cache_loaded = false;
+bool PluginManager::plugin_version_cache_dirty = false;
+Mutex PluginManager::cache_load_mutex;
 
 String PluginManager::get_plugin_cache_path() {
 	// check if OS has the environment variable "GDRE_PLUGIN_CACHE_DIR" set
@@ -71,6 +74,7 @@ void PluginManager::unregister_source(Ref<PluginSource> source) {
 }
 
 PluginVersion PluginManager::get_plugin_version(const String &plugin_name, const String &version) {
+	ensure_cache_loaded();
 	Ref<PluginSource> source = get_source(plugin_name);
 	ERR_FAIL_COND_V_MSG(source.is_null(), PluginVersion(), "No source found for plugin: " + plugin_name);
 
@@ -102,6 +106,7 @@ PluginVersion PluginManager::get_plugin_version(const String &plugin_name, const
 }
 
 String PluginManager::get_plugin_download_url(const String &plugin_name, const Vector<String> &hashes) {
+	ensure_cache_loaded();
 	Ref<PluginSource> source = get_source(plugin_name);
 	ERR_FAIL_COND_V_MSG(source.is_null(), String(), "No source found for plugin: " + plugin_name);
 
@@ -170,8 +175,18 @@ String PluginManager::get_plugin_download_url(const String &plugin_name, const V
 	return "";
 }
 
+void PluginManager::ensure_cache_loaded() {
+	if (cache_loaded) {
+		return;
+	}
+	MutexLock lock(cache_load_mutex);
+	if (!cache_loaded) {
+		load_cache();
+	}
+}
+
 void PluginManager::load_cache() {
-	Dictionary d;
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
 	if (FileAccess::exists(STATIC_PLUGIN_CACHE_PATH)) {
 		load_plugin_version_cache_file(STATIC_PLUGIN_CACHE_PATH);
 	}
@@ -181,15 +196,24 @@ void PluginManager::load_cache() {
 
 	// Load PluginVersion cache
 	load_plugin_version_cache();
+	cache_loaded = true;
+	print_verbose(vformat("Loaded plugin cache in %dms", (OS::get_singleton()->get_ticks_usec() - start) / 1000));
 }
 
 void PluginManager::save_cache() {
+	// nothing was read, so nothing can have changed
+	if (!cache_loaded) {
+		return;
+	}
 	for (int i = 0; i < source_count; ++i) {
 		sources[i]->save_cache();
 	}
 
 	// Save PluginVersion cache
-	save_plugin_version_cache();
+	if (plugin_version_cache_dirty) {
+		save_plugin_version_cache();
+		plugin_version_cache_dirty = false;
+	}
 }
 
 struct PrePopToken {
@@ -217,6 +241,7 @@ struct PrePopTask {
 };
 
 void PluginManager::prepop_cache(const Vector<String> &plugin_names, bool multithread) {
+	ensure_cache_loaded();
 	prepopping = true;
 	String plugin_names_str = String(", ").join(plugin_names);
 	print_line("Prepopulating cache for " + plugin_names_str);
@@ -264,6 +289,7 @@ String PluginManager::get_cache_key(const String &plugin_source, uint64_t primar
 }
 
 PluginVersion PluginManager::get_cached_plugin_version(const String &cache_key) {
+	ensure_cache_loaded();
 	MutexLock lock(plugin_version_cache_mutex);
 	if (plugin_version_cache.has(cache_key)) {
 		return plugin_version_cache[cache_key];
@@ -272,8 +298,10 @@ PluginVersion PluginManager::get_cached_plugin_version(const String &cache_key)
 }
 
 void PluginManager::cache_plugin_version(const String &cache_key, const PluginVersion &version) {
+	ensure_cache_loaded();
 	MutexLock lock(plugin_version_cache_mutex);
 	plugin_version_cache[cache_key] = version;
+	plugin_version_cache_dirty = true;
 }
 
 PluginVersion PluginManager::populate_plugin_version_from_release(const ReleaseInfo &release_info) {
@@ -368,7 +396,15 @@ Error PluginManager::populate_plugin_version_hashes(PluginVersion &plugin_versio
 
 	print_line("Populating plugin version hashes for " + plugin_version.plugin_name + " version: " + plugin_version.release_info.version);
 	String unzupped_path = new_temp_foldr.path_join("unzipped");
-	err = gdre::unzip_file_to_dir(zip_path, unzupped_path);
+	// only the plugin's own tree is needed for hashing the binaries, skip demos and the like
+	String zip_subdir = plugin_version.base_folder;
+	for (auto &E : gdexts) {
+		if (!E.key.begins_with(zip_subdir)) {
+			zip_subdir = "";
+			break;
+		}
+	}
+	err = gdre::unzip_file_to_dir(zip_path, unzupped_path, zip_subdir);
 	if (err) {
 		close_and_remove_zip();
 		return err;
@@ -10,6 +10,8 @@
 #include "utility/plugin_info.h"
 #include "utility/plugin_source.h"
 
+#include <atomic>
+
 class PluginManager : public Object {
 	GDCLASS(PluginManager, Object)
 
@@ -23,6 +25,12 @@ private:
 	static bool prepopping;
 	static HashMap<String, PluginVersion> plugin_version_cache;
 	static Mutex plugin_version_cache_mutex;
+	// The caches are only read the first time something needs them; most CLI commands never do.
+	static std::atomic<bool> cache_loaded;
+	static bool plugin_version_cache_dirty;
+	static Mutex cache_load_mutex;
+
+	static void ensure_cache_loaded();
 
 	// Source management
 	static Ref<PluginSource> get_source(const String &plugin_name);
@@ -0,0 +1,482 @@
+#include "png_encoder.h"
+
+#include "utility/common.h"
+#include "utility/gdre_config.h"
+#include "utility/output_dedup.h"
+
+#include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+
+#include <zlib.h>
+
+namespace {
+decltype(Image::save_png_func) original_save_png_func = nullptr;
+decltype(Image::save_png_buffer_func) original_save_png_buffer_func = nullptr;
+bool hooks_installed = false;
+
+enum PNGFilter : uint8_t {
+	FILTER_NONE = 0,
+	FILTER_SUB = 1,
+	FILTER_UP = 2,
+	FILTER_AVERAGE = 3,
+	FILTER_PAETH = 4,
+};
+
+constexpr uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+constexpr size_t IDAT_CHUNK_SIZE = 1 << 20;
+constexpr size_t DEFLATE_WINDOW_SIZE = 32768;
+
+_FORCE_INLINE_ uint8_t paeth_predictor(int a, int b, int c) {
+	int p = a + b - c;
+	int pa = ABS(p - a);
+	int pb = ABS(p - b);
+	int pc = ABS(p - c);
+	if (pa <= pb && pa <= pc) {
+		return a;
+	}
+	return pb <= pc ? b : c;
+}
+
+// These loops are kept branch-free in the inner body so that they are auto-vectorized.
+void filter_row(uint8_t p_filter, const uint8_t *p_cur, const uint8_t *p_prev, uint8_t *r_out, size_t p_len, int p_bpp) {
+	switch (p_filter) {
+		case FILTER_NONE: {
+			memcpy(r_out, p_cur, p_len);
+		} break;
+		case FILTER_SUB: {
+			memcpy(r_out, p_cur, p_bpp);
+			for (size_t i = p_bpp; i < p_len; i++) {
+				r_out[i] = p_cur[i] - p_cur[i - p_bpp];
+			}
+		} break;
+		case FILTER_UP: {
+			for (size_t i = 0; i < p_len; i++) {
+				r_out[i] = p_cur[i] - p_prev[i];
+			}
+		} break;
+		case FILTER_AVERAGE: {
+			for (int i = 0; i < p_bpp; i++) {
+				r_out[i] = p_cur[i] - (p_prev[i] >> 1);
+			}
+			for (size_t i = p_bpp; i < p_len; i++) {
+				r_out[i] = p_cur[i] - (uint8_t)(((int)p_cur[i - p_bpp] + (int)p_prev[i]) >> 1);
+			}
+		} break;
+		case FILTER_PAETH: {
+			for (int i = 0; i < p_bpp; i++) {
+				r_out[i] = p_cur[i] - p_prev[i];
+			}
+			for (size_t i = p_bpp; i < p_len; i++) {
+				r_out[i] = p_cur[i] - paeth_predictor(p_cur[i - p_bpp], p_prev[i], p_prev[i - p_bpp]);
+			}
+		} break;
+		default:
+			break;
+	}
+}
+
+_FORCE_INLINE_ uint64_t filtered_row_cost(const uint8_t *p_row, size_t p_len) {
+	uint64_t sum = 0;
+	for (size_t i = 0; i < p_len; i++) {
+		sum += ABS((int)(int8_t)p_row[i]);
+	}
+	return sum;
+}
+
+struct EncodeParams {
+	int zlib_level = 1;
+	int zlib_strategy = Z_DEFAULT_STRATEGY;
+	bool adaptive_filter = false;
+	uint8_t fixed_filter = FILTER_UP;
+};
+
+EncodeParams get_params_for_effort(int p_effort) {
+	EncodeParams params;
+	if (p_effort <= 0) {
+		params.zlib_level = 0;
+		params.fixed_filter = FILTER_NONE;
+	} else if (p_effort == 1) {
+		// fpnge-style: cheap Up filter and run-length-only matching
+		params.zlib_level = 1;
+		params.zlib_strategy = Z_RLE;
+	} else if (p_effort == 2) {
+		params.zlib_level = 1;
+	} else {
+		params.zlib_level = MIN(p_effort, 9);
+		params.zlib_strategy = Z_FILTERED;
+		params.adaptive_filter = true;
+	}
+	return params;
+}
+
+struct Band {
+	int row_start = 0;
+	int row_end = 0;
+	size_t offset = 0;
+	size_t size = 0;
+	bool last = false;
+	Vector<uint8_t> deflated;
+	uint32_t adler = 1;
+	Error err = OK;
+};
+
+struct EncodeJob {
+	const uint8_t *src = nullptr;
+	uint8_t *filtered = nullptr;
+	size_t row_bytes = 0;
+	int bpp = 0;
+	EncodeParams params;
+	Vector<Band> bands;
+
+	void filter_band(uint32_t p_idx, void *p_userdata) {
+		Band &band = bands.write[p_idx];
+		Vector<uint8_t> zero_row;
+		zero_row.resize_initialized(row_bytes);
+		Vector<uint8_t> scratch;
+		if (params.adaptive_filter) {
+			scratch.resize(row_bytes * 5);
+		}
+		for (int y = band.row_start; y < band.row_end; y++) {
+			const uint8_t *cur = src + y * row_bytes;
+			const uint8_t *prev = y > 0 ? src + (y - 1) * row_bytes : zero_row.ptr();
+			uint8_t *out = filtered + y * (row_bytes + 1);
+			if (!params.adaptive_filter) {
+				out[0] = params.fixed_filter;
+				filter_row(params.fixed_filter, cur, prev, out + 1, row_bytes, bpp);
+				continue;
+			}
+			uint64_t best_cost = UINT64_MAX;
+			uint8_t best_filter = FILTER_NONE;
+			for (uint8_t f = FILTER_NONE; f <= FILTER_PAETH; f++) {
+				uint8_t *candidate = scratch.ptrw() + f * row_bytes;
+				filter_row(f, cur, prev, candidate, row_bytes, bpp);
+				uint64_t cost = filtered_row_cost(candidate, row_bytes);
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_filter = f;
+				}
+			}
+			out[0] = best_filter;
+			memcpy(out + 1, scratch.ptr() + best_filter * row_bytes, row_bytes);
+		}
+	}
+
+	void deflate_band(uint32_t p_idx, void *p_userdata) {
+		Band &band = bands.write[p_idx];
+		const uint8_t *in = filtered + band.offset;
+		band.adler = adler32(1, in, band.size);
+
+		z_stream strm = {};
+		if (deflateInit2(&strm, params.zlib_level, Z_DEFLATED, -15, 8, params.zlib_strategy) != Z_OK) {
+			band.err = ERR_CANT_CREATE;
+			return;
+		}
+		// prime the window with the tail of the previous band so that bands don't lose matches across the seam
+		if (band.offset > 0 && params.zlib_level > 0) {
+			size_t dict_size = MIN(band.offset, DEFLATE_WINDOW_SIZE);
+			deflateSetDictionary(&strm, in - dict_size, dict_size);
+		}
+		band.deflated.resize(deflateBound(&strm, band.size) + 64);
+		strm.next_in = (Bytef *)in;
+		strm.avail_in = band.size;
+		size_t written = 0;
+		int flush = band.last ? Z_FINISH : Z_SYNC_FLUSH;
+		while (true) {
+			strm.next_out = band.deflated.ptrw() + written;
+			strm.avail_out = band.deflated.size() - written;
+			int ret = deflate(&strm, flush);
+			written = band.deflated.size() - strm.avail_out;
+			if (ret == Z_STREAM_ERROR) {
+				band.err = ERR_BUG;
+				break;
+			}
+			if (band.last ? ret == Z_STREAM_END : (strm.avail_in == 0 && strm.avail_out > 0)) {
+				break;
+			}
+			band.deflated.resize(band.deflated.size() * 2);
+		}
+		deflateEnd(&strm);
+		band.deflated.resize(written);
+	}
+};
+
+class PNGWriter {
+	Vector<uint8_t> data;
+	size_t pos = 0;
+
+	_FORCE_INLINE_ void ensure(size_t p_extra) {
+		if (pos + p_extra > (size_t)data.size()) {
+			data.resize(MAX(pos + p_extra, (size_t)data.size() * 2));
+		}
+	}
+
+public:
+	PNGWriter(size_t p_reserve) {
+		data.resize(p_reserve);
+	}
+
+	void put_u32_be(uint32_t p_val) {
+		ensure(4);
+		uint8_t *w = data.ptrw() + pos;
+		w[0] = (p_val >> 24) & 0xFF;
+		w[1] = (p_val >> 16) & 0xFF;
+		w[2] = (p_val >> 8) & 0xFF;
+		w[3] = p_val & 0xFF;
+		pos += 4;
+	}
+
+	void put_bytes(const uint8_t *p_data, size_t p_len) {
+		ensure(p_len);
+		memcpy(data.ptrw() + pos, p_data, p_len);
+		pos += p_len;
+	}
+
+	void put_chunk(const char *p_type, const uint8_t *p_data, size_t p_len) {
+		put_u32_be(p_len);
+		uLong crc = crc32(0, (const Bytef *)p_type, 4);
+		put_bytes((const uint8_t *)p_type, 4);
+		if (p_len > 0) {
+			crc = crc32(crc, p_data, p_len);
+			put_bytes(p_data, p_len);
+		}
+		put_u32_be(crc);
+	}
+
+	Vector<uint8_t> finish() {
+		data.resize(pos);
+		return data;
+	}
+};
+
+bool should_run_multithreaded() {
+	return !GDREConfig::get_singleton()->get_setting("force_single_threaded", false) && OS::get_singleton()->get_processor_count() > 1;
+}
+
+} //namespace
+
+Vector<uint8_t> gdre::PNGEncoder::encode(const Ref<Image> &p_img, int p_effort, Error *r_error, PNGEncodeStats *r_stats) {
+	Error dummy;
+	if (!r_error) {
+		r_error = &dummy;
+	}
+	*r_error = ERR_INVALID_PARAMETER;
+	ERR_FAIL_COND_V(p_img.is_null() || p_img->is_empty(), Vector<uint8_t>());
+
+	Ref<Image> img = p_img;
+	if (img->is_compressed()) {
+		img = p_img->duplicate();
+		*r_error = gdre::decompress_image(img);
+		ERR_FAIL_COND_V_MSG(*r_error != OK, Vector<uint8_t>(), "Failed to decompress image for PNG encoding.");
+	}
+	uint8_t color_type;
+	int bpp;
+	switch (img->get_format()) {
+		case Image::FORMAT_L8:
+			color_type = 0;
+			bpp = 1;
+			break;
+		case Image::FORMAT_LA8:
+			color_type = 4;
+			bpp = 2;
+			break;
+		case Image::FORMAT_RGB8:
+			color_type = 2;
+			bpp = 3;
+			break;
+		case Image::FORMAT_RGBA8:
+			color_type = 6;
+			bpp = 4;
+			break;
+		default: {
+			// same conversion the engine's PNG saver does
+			img = img == p_img ? Ref<Image>(p_img->duplicate()) : img;
+			if (img->detect_alpha()) {
+				img->convert(Image::FORMAT_RGBA8);
+				color_type = 6;
+				bpp = 4;
+			} else {
+				img->convert(Image::FORMAT_RGB8);
+				color_type = 2;
+				bpp = 3;
+			}
+		} break;
+	}
+
+	const int width = img->get_width();
+	const int height = img->get_height();
+	const size_t row_bytes = (size_t)width * bpp;
+	const size_t filtered_size = (row_bytes + 1) * height;
+	// the image may have mipmaps; only the first level is encoded
+	const Vector<uint8_t> src_data = img->get_data();
+	ERR_FAIL_COND_V((size_t)src_data.size() < row_bytes * height, Vector<uint8_t>());
+
+	Vector<uint8_t> filtered;
+	filtered.resize(filtered_size);
+
+	EncodeJob job;
+	job.src = src_data.ptr();
+	job.filtered = filtered.ptrw();
+	job.row_bytes = row_bytes;
+	job.bpp = bpp;
+	job.params = get_params_for_effort(CLAMP(p_effort, MIN_EFFORT, MAX_EFFORT));
+
+	int band_count = 1;
+	bool multithreaded = filtered_size >= PARALLEL_DEFLATE_THRESHOLD && should_run_multithreaded();
+	if (multithreaded) {
+		band_count = MIN((int)(filtered_size / MIN_BAND_SIZE), OS::get_singleton()->get_processor_count() * 2);
+		band_count = CLAMP(band_count, 1, height);
+	}
+	int rows_per_band = (height + band_count - 1) / band_count;
+	for (int row = 0; row < height; row += rows_per_band) {
+		Band band;
+		band.row_start = row;
+		band.row_end = MIN(row + rows_per_band, height);
+		band.offset = (size_t)row * (row_bytes + 1);
+		band.size = (size_t)(band.row_end - band.row_start) * (row_bytes + 1);
+		job.bands.push_back(band);
+	}
+	job.bands.write[job.bands.size() - 1].last = true;
+	band_count = job.bands.size();
+
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+	if (band_count > 1) {
+		auto group_id = WorkerThreadPool::get_singleton()->add_template_group_task(&job, &EncodeJob::filter_band, (void *)nullptr, band_count, -1, true, SNAME("PNGEncoder::filter"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	} else {
+		job.filter_band(0, nullptr);
+	}
+	uint64_t filtered_time = OS::get_singleton()->get_ticks_usec();
+	// the dictionary priming reads the previous band's output, so deflating has to wait for all filtering to finish
+	if (band_count > 1) {
+		auto group_id = WorkerThreadPool::get_singleton()->add_template_group_task(&job, &EncodeJob::deflate_band, (void *)nullptr, band_count, -1, true, SNAME("PNGEncoder::deflate"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	} else {
+		job.deflate_band(0, nullptr);
+	}
+	uint64_t deflated_time = OS::get_singleton()->get_ticks_usec();
+
+	size_t deflated_size = 0;
+	uint32_t adler = 1;
+	for (const Band &band : job.bands) {
+		if (band.err != OK) {
+			*r_error = band.err;
+			ERR_FAIL_V_MSG(Vector<uint8_t>(), "Failed to deflate PNG data.");
+		}
+		deflated_size += band.deflated.size();
+		adler = adler32_combine(adler, band.adler, band.size);
+	}
+
+	// zlib header: 32K window, FLEVEL matching the compression level
+	uint8_t cmf = 0x78;
+	int level = job.params.zlib_level;
+	uint8_t flg = (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3))) << 6;
+	flg += 31 - ((cmf * 256 + flg) % 31);
+	uint8_t zlib_header[2] = { cmf, flg };
+	uint8_t zlib_trailer[4] = { uint8_t(adler >> 24), uint8_t(adler >> 16), uint8_t(adler >> 8), uint8_t(adler) };
+
+	// assemble the zlib stream; IDAT chunks are split at fixed sizes regardless of band boundaries
+	Vector<uint8_t> zdata;
+	zdata.resize(deflated_size + 6);
+	uint8_t *zw = zdata.ptrw();
+	memcpy(zw, zlib_header, 2);
+	size_t zpos = 2;
+	for (const Band &band : job.bands) {
+		memcpy(zw + zpos, band.deflated.ptr(), band.deflated.size());
+		zpos += band.deflated.size();
+	}
+	memcpy(zw + zpos, zlib_trailer, 4);
+
+	uint8_t ihdr[13];
+	ihdr[0] = (width >> 24) & 0xFF;
+	ihdr[1] = (width >> 16) & 0xFF;
+	ihdr[2] = (width >> 8) & 0xFF;
+	ihdr[3] = width & 0xFF;
+	ihdr[4] = (height >> 24) & 0xFF;
+	ihdr[5] = (height >> 16) & 0xFF;
+	ihdr[6] = (height >> 8) & 0xFF;
+	ihdr[7] = height & 0xFF;
+	ihdr[8] = 8; // bit depth
+	ihdr[9] = color_type;
+	ihdr[10] = 0; // deflate
+	ihdr[11] = 0; // adaptive filtering
+	ihdr[12] = 0; // no interlace
+
+	size_t idat_chunks = (zdata.size() + IDAT_CHUNK_SIZE - 1) / IDAT_CHUNK_SIZE;
+	PNGWriter writer(sizeof(PNG_SIGNATURE) + 25 + zdata.size() + idat_chunks * 12 + 12);
+	writer.put_bytes(PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+	writer.put_chunk("IHDR", ihdr, sizeof(ihdr));
+	for (size_t ofs = 0; ofs < (size_t)zdata.size(); ofs += IDAT_CHUNK_SIZE) {
+		writer.put_chunk("IDAT", zdata.ptr() + ofs, MIN(IDAT_CHUNK_SIZE, (size_t)zdata.size() - ofs));
+	}
+	writer.put_chunk("IEND", nullptr, 0);
+	Vector<uint8_t> ret = writer.finish();
+
+	if (r_stats) {
+		r_stats->raw_size = row_bytes * height;
+		r_stats->encoded_size = ret.size();
+		r_stats->filter_usec = filtered_time - start;
+		r_stats->deflate_usec = deflated_time - filtered_time;
+		r_stats->bands = band_count;
+	}
+	*r_error = OK;
+	return ret;
+}
+
+Error gdre::PNGEncoder::save(const String &p_path, const Ref<Image> &p_img, int p_effort) {
+	Error err;
+	Vector<uint8_t> buffer = encode(p_img, p_effort, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to encode PNG: " + p_path);
+	return OutputDeduplicator::write_file(p_path, buffer.ptr(), buffer.size());
+}
+
+bool gdre::PNGEncoder::is_fast_encoder_enabled() {
+	return GDREConfig::get_singleton()->get_setting("Exporter/Image/use_fast_png_encoder", false);
+}
+
+int gdre::PNGEncoder::get_configured_effort() {
+	int effort = GDREConfig::get_singleton()->get_setting("Exporter/Image/png_compression_effort", DEFAULT_EFFORT);
+	return CLAMP(effort, MIN_EFFORT, MAX_EFFORT);
+}
+
+Error gdre::PNGEncoder::save_image_as_png(const String &p_path, const Ref<Image> &p_img) {
+	if (!is_fast_encoder_enabled() && original_save_png_func) {
+		return original_save_png_func(p_path, p_img);
+	}
+	return save(p_path, p_img, get_configured_effort());
+}
+
+Vector<uint8_t> gdre::PNGEncoder::save_image_as_png_to_buffer(const Ref<Image> &p_img) {
+	if (!is_fast_encoder_enabled() && original_save_png_buffer_func) {
+		return original_save_png_buffer_func(p_img);
+	}
+	return encode(p_img, get_configured_effort());
+}
+
+Vector<uint8_t> gdre::PNGEncoder::encode_with_engine_saver(const Ref<Image> &p_img) {
+	auto func = hooks_installed ? original_save_png_buffer_func : Image::save_png_buffer_func;
+	ERR_FAIL_NULL_V(func, Vector<uint8_t>());
+	return func(p_img);
+}
+
+void gdre::PNGEncoder::install_image_hooks() {
+	if (hooks_installed) {
+		return;
+	}
+	original_save_png_func = Image::save_png_func;
+	original_save_png_buffer_func = Image::save_png_buffer_func;
+	Image::save_png_func = &PNGEncoder::save_image_as_png;
+	Image::save_png_buffer_func = &PNGEncoder::save_image_as_png_to_buffer;
+	hooks_installed = true;
+}
+
+void gdre::PNGEncoder::uninstall_image_hooks() {
+	if (!hooks_installed) {
+		return;
+	}
+	Image::save_png_func = original_save_png_func;
+	Image::save_png_buffer_func = original_save_png_buffer_func;
+	original_save_png_func = nullptr;
+	original_save_png_buffer_func = nullptr;
+	hooks_installed = false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/io/image.h"
+#include "core/templates/vector.h"
+
+// Fast, standards-compliant PNG encoder used in place of the engine's libpng-based saver.
+// Rows are filtered with simple fixed filters at low effort levels (fpng-style) and with
+// the libpng minimum-sum heuristic at higher levels; large images are deflated in parallel
+// row bands that are stitched into a single zlib stream (pigz-style).
+namespace gdre {
+
+struct PNGEncodeStats {
+	uint64_t raw_size = 0;
+	uint64_t encoded_size = 0;
+	uint64_t filter_usec = 0;
+	uint64_t deflate_usec = 0;
+	int bands = 0;
+};
+
+class PNGEncoder {
+public:
+	// 0 stores uncompressed, 1 is fastest (RLE + Up filter), 9 is best (adaptive filter + max zlib level).
+	static constexpr int MIN_EFFORT = 0;
+	static constexpr int MAX_EFFORT = 9;
+	static constexpr int DEFAULT_EFFORT = 2;
+	// Filtered images larger than this are deflated in parallel row bands.
+	static constexpr size_t PARALLEL_DEFLATE_THRESHOLD = 4 * 1024 * 1024;
+	static constexpr size_t MIN_BAND_SIZE = 1024 * 1024;
+
+	static Vector<uint8_t> encode(const Ref<Image> &p_img, int p_effort, Error *r_error = nullptr, PNGEncodeStats *r_stats = nullptr);
+	static Error save(const String &p_path, const Ref<Image> &p_img, int p_effort);
+
+	// Uses GDREConfig to select between this encoder and the engine's saver.
+	static bool is_fast_encoder_enabled();
+	static int get_configured_effort();
+	static Error save_image_as_png(const String &p_path, const Ref<Image> &p_img);
+	static Vector<uint8_t> save_image_as_png_to_buffer(const Ref<Image> &p_img);
+	// Always uses the engine's saver, regardless of the hooks; used for comparisons.
+	static Vector<uint8_t> encode_with_engine_saver(const Ref<Image> &p_img);
+
+	// Replaces Image::save_png_func/save_png_buffer_func so that everything going through
+	// Image::save_png (including the GLTF embedded images) uses the configured encoder.
+	static void install_image_hooks();
+	static void uninstall_image_hooks();
+};
+
+} // namespace gdre
@@ -0,0 +1,255 @@
+#include "project_loader.h"
+
+#include "core/os/os.h"
+#include "utility/gdre_config.h"
+#include "utility/gdre_settings.h"
+
+void ProjectLoader::Listener::file_added(const Ref<PackedFileInfo> &p_info) {
+	if (loader->canceled) {
+		return;
+	}
+	pending.files.push_back(p_info);
+	if (pending.files.size() >= BATCH_SIZE) {
+		loader->_push_batch(pending);
+	}
+}
+
+void ProjectLoader::Listener::file_removed(const String &p_path) {
+	if (loader->canceled) {
+		return;
+	}
+	// removals are applied before the files in the same batch, so anything added before this has to go out first
+	if (!pending.files.is_empty()) {
+		loader->_push_batch(pending);
+	}
+	pending.removed.push_back(p_path);
+}
+
+void ProjectLoader::Listener::files_merged() {
+	if (!pending.files.is_empty() || !pending.removed.is_empty()) {
+		loader->_push_batch(pending);
+	}
+	Status expected = STATUS_LOADING_FILES;
+	loader->status.compare_exchange_strong(expected, STATUS_LOADING_PROJECT);
+}
+
+void ProjectLoader::_push_batch(Batch &p_batch) {
+	// The GUI drains the queue every frame; if it falls behind, wait for it rather than drop files.
+	while (!queue.try_push(std::move(p_batch))) {
+		if (canceled) {
+			return;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+	p_batch = Batch();
+}
+
+void ProjectLoader::_load(const Vector<String> *p_paths) {
+	GDRESettings *settings = GDRESettings::get_singleton();
+	listener.loader = this;
+	GDREPackedData::set_thread_listener(&listener);
+	Error err = canceled ? ERR_SKIP : settings->load_project(*p_paths);
+	GDREPackedData::set_thread_listener(nullptr);
+	if (err == OK && canceled) {
+		settings->unload_project();
+		err = ERR_SKIP;
+	}
+	if (err != OK) {
+		load_error = err;
+		status = canceled ? STATUS_CANCELED : STATUS_FAILED;
+		return;
+	}
+	// embedded zips are merged last and may not have been flushed by a files_merged call of their own
+	listener.files_merged();
+	status = STATUS_CHECKING_MD5;
+	_check_md5_all_files();
+	status = STATUS_DONE;
+}
+
+void ProjectLoader::_check_md5_all_files() {
+	GDRESettings::PackInfo::PackType type = GDRESettings::get_singleton()->get_pack_type();
+	// same as PckDumper::check_md5_all_files; the other pack types don't store checksums
+	if (type != GDRESettings::PackInfo::PCK && type != GDRESettings::PackInfo::EXE) {
+		return;
+	}
+	Vector<Ref<PackedFileInfo>> files;
+	for (const Ref<PackedFileInfo> &file : GDRESettings::get_singleton()->get_file_info_list()) {
+		if (file->has_md5()) {
+			files.push_back(file);
+		}
+	}
+	md5_total = files.size();
+	if (files.is_empty()) {
+		return;
+	}
+	// each task checks a batch worth of files and publishes them together
+	uint32_t chunks = (files.size() + BATCH_SIZE - 1) / BATCH_SIZE;
+	if (GDREConfig::get_singleton()->get_setting("force_single_threaded", false)) {
+		for (uint32_t i = 0; i < chunks; i++) {
+			_check_md5_chunk(i, &files);
+		}
+	} else {
+		WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(
+				this, &ProjectLoader::_check_md5_chunk, &files, chunks, -1, true, SNAME("ProjectLoader::check_md5"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	}
+	if (encryption_error) {
+		GDRESettings::get_singleton()->_set_error_encryption(true);
+	}
+	md5_complete = !canceled;
+}
+
+void ProjectLoader::_check_md5_chunk(uint32_t p_idx, Vector<Ref<PackedFileInfo>> *p_files) {
+	Batch batch;
+	batch.md5_checked = true;
+	int64_t end = MIN((int64_t)(p_idx + 1) * BATCH_SIZE, p_files->size());
+	for (int64_t i = (int64_t)p_idx * BATCH_SIZE; i < end; i++) {
+		if (canceled) {
+			break;
+		}
+		Ref<PackedFileInfo> file = p_files->get(i);
+		bool passed = FileAccess::get_md5(file->get_path()) == String::md5(file->get_md5().ptr());
+		if (!passed) {
+			print_error("Checksum failed for " + file->get_path());
+			md5_broken++;
+			if (file->is_encrypted()) {
+				encryption_error = true;
+			}
+		}
+		md5_checked++;
+		batch.files.push_back(file);
+		batch.md5_passed.push_back(passed);
+	}
+	if (!batch.files.is_empty()) {
+		_push_batch(batch);
+	}
+}
+
+Error ProjectLoader::start(const Vector<String> &p_paths) {
+	if (task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		ERR_FAIL_COND_V_MSG(!is_finished(), ERR_BUSY, "A project is already being loaded.");
+		wait();
+	}
+	ERR_FAIL_COND_V_MSG(p_paths.is_empty(), ERR_FILE_NOT_FOUND, "No valid paths provided!");
+	if (GDRESettings::get_singleton()->is_pack_loaded()) {
+		GDRESettings::get_singleton()->unload_project();
+	}
+	// drop anything a previous load left behind
+	Batch batch;
+	while (queue.try_pop(batch)) {
+	}
+	listener.pending = Batch();
+	paths = p_paths;
+	canceled = false;
+	md5_complete = false;
+	encryption_error = false;
+	md5_total = 0;
+	md5_checked = 0;
+	md5_broken = 0;
+	load_error = OK;
+	status = STATUS_LOADING_FILES;
+	// The loading phases inside load_project still respect force_single_threaded; this task only keeps them off
+	// the GUI thread.
+	task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &ProjectLoader::_load, &paths, true, SNAME("ProjectLoader::load"));
+	return OK;
+}
+
+void ProjectLoader::cancel() {
+	Status current = status;
+	if (current == STATUS_IDLE || is_finished()) {
+		return;
+	}
+	canceled = true;
+	if (current < STATUS_CHECKING_MD5) {
+		GDRESettings::get_singleton()->cancel_load();
+	}
+}
+
+Error ProjectLoader::wait() {
+	if (task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+		task_id = WorkerThreadPool::INVALID_TASK_ID;
+	}
+	return load_error;
+}
+
+ProjectLoader::Status ProjectLoader::get_status() const {
+	return status;
+}
+
+bool ProjectLoader::is_finished() const {
+	Status current = status;
+	return current == STATUS_DONE || current == STATUS_CANCELED || current == STATUS_FAILED;
+}
+
+Error ProjectLoader::get_error() const {
+	return is_finished() ? load_error : OK;
+}
+
+bool ProjectLoader::is_md5_check_complete() const {
+	return md5_complete;
+}
+
+int64_t ProjectLoader::get_md5_total() const {
+	return md5_total;
+}
+
+int64_t ProjectLoader::get_md5_checked_count() const {
+	return md5_checked;
+}
+
+int64_t ProjectLoader::get_md5_broken_count() const {
+	return md5_broken;
+}
+
+bool ProjectLoader::has_pending_batches() const {
+	return !queue.was_empty();
+}
+
+Dictionary ProjectLoader::pop_batch() {
+	Dictionary ret;
+	Batch batch;
+	if (!queue.try_pop(batch)) {
+		return ret;
+	}
+	Array files;
+	files.resize(batch.files.size());
+	for (int i = 0; i < batch.files.size(); i++) {
+		if (batch.md5_checked) {
+			batch.files[i]->set_md5_match(batch.md5_passed[i]);
+		}
+		files[i] = batch.files[i];
+	}
+	ret["files"] = files;
+	ret["removed"] = batch.removed;
+	ret["md5_checked"] = batch.md5_checked;
+	return ret;
+}
+
+ProjectLoader::~ProjectLoader() {
+	cancel();
+	wait();
+}
+
+void ProjectLoader::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("start", "paths"), &ProjectLoader::start);
+	ClassDB::bind_method(D_METHOD("cancel"), &ProjectLoader::cancel);
+	ClassDB::bind_method(D_METHOD("wait"), &ProjectLoader::wait);
+	ClassDB::bind_method(D_METHOD("get_status"), &ProjectLoader::get_status);
+	ClassDB::bind_method(D_METHOD("is_finished"), &ProjectLoader::is_finished);
+	ClassDB::bind_method(D_METHOD("get_error"), &ProjectLoader::get_error);
+	ClassDB::bind_method(D_METHOD("is_md5_check_complete"), &ProjectLoader::is_md5_check_complete);
+	ClassDB::bind_method(D_METHOD("get_md5_total"), &ProjectLoader::get_md5_total);
+	ClassDB::bind_method(D_METHOD("get_md5_checked_count"), &ProjectLoader::get_md5_checked_count);
+	ClassDB::bind_method(D_METHOD("get_md5_broken_count"), &ProjectLoader::get_md5_broken_count);
+	ClassDB::bind_method(D_METHOD("has_pending_batches"), &ProjectLoader::has_pending_batches);
+	ClassDB::bind_method(D_METHOD("pop_batch"), &ProjectLoader::pop_batch);
+
+	BIND_ENUM_CONSTANT(STATUS_IDLE);
+	BIND_ENUM_CONSTANT(STATUS_LOADING_FILES);
+	BIND_ENUM_CONSTANT(STATUS_LOADING_PROJECT);
+	BIND_ENUM_CONSTANT(STATUS_CHECKING_MD5);
+	BIND_ENUM_CONSTANT(STATUS_DONE);
+	BIND_ENUM_CONSTANT(STATUS_CANCELED);
+	BIND_ENUM_CONSTANT(STATUS_FAILED);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/object/ref_counted.h"
+#include "core/object/worker_thread_pool.h"
+#include "utility/file_access_gdre.h"
+#include "utility/gd_parallel_queue.h"
+#include "utility/packed_file_info.h"
+
+#include <atomic>
+
+// Loads a project on a worker thread so the GUI can show it while it loads.
+// The file table is published in batches as each pack is merged, before the engine version, project config and
+// import files are read. Once those are loaded, the MD5 check runs and publishes every checked file again with its
+// result, which is only applied once the batch is popped. The GUI pops batches off the queue each frame for as long as its frame budget allows.
+class ProjectLoader : public RefCounted {
+	GDCLASS(ProjectLoader, RefCounted);
+
+public:
+	enum Status {
+		STATUS_IDLE,
+		STATUS_LOADING_FILES,
+		STATUS_LOADING_PROJECT,
+		STATUS_CHECKING_MD5,
+		STATUS_DONE,
+		STATUS_CANCELED,
+		STATUS_FAILED,
+	};
+
+private:
+	static constexpr int BATCH_SIZE = 256;
+	static constexpr unsigned QUEUE_SIZE = 1024;
+
+	struct Batch {
+		// a file that is already in the tree is published again when a later pack replaces it
+		Vector<Ref<PackedFileInfo>> files;
+		// applied before files
+		PackedStringArray removed;
+		bool md5_checked = false;
+		// one per file when md5_checked; applied to the file table by pop_batch, on the thread that reads it
+		Vector<bool> md5_passed;
+	};
+
+	class Listener : public GDREPackedData::FileTableListener {
+	public:
+		ProjectLoader *loader = nullptr;
+		Batch pending;
+
+		virtual void file_added(const Ref<PackedFileInfo> &p_info) override;
+		virtual void file_removed(const String &p_path) override;
+		virtual void files_merged() override;
+	};
+
+	Vector<String> paths;
+	Listener listener;
+	StaticParallelQueue<Batch, QUEUE_SIZE> queue;
+	WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	std::atomic<Status> status = STATUS_IDLE;
+	std::atomic<bool> canceled = false;
+	std::atomic<bool> md5_complete = false;
+	std::atomic<bool> encryption_error = false;
+	std::atomic<int64_t> md5_total = 0;
+	std::atomic<int64_t> md5_checked = 0;
+	std::atomic<int64_t> md5_broken = 0;
+	Error load_error = OK;
+
+	void _push_batch(Batch &p_batch);
+	void _load(const Vector<String> *p_paths);
+	void _check_md5_all_files();
+	void _check_md5_chunk(uint32_t p_idx, Vector<Ref<PackedFileInfo>> *p_files);
+
+protected:
+	static void _bind_methods();
+
+public:
+	// Unloads the current project, if there is one, and starts loading p_paths in the background.
+	Error start(const Vector<String> &p_paths);
+	// Stops the load at its next phase and unloads the project. Once the project has loaded, this only stops the MD5 check.
+	void cancel();
+	// Blocks until the background task has finished and returns the load_project error.
+	Error wait();
+
+	Status get_status() const;
+	bool is_finished() const;
+	Error get_error() const;
+
+	bool is_md5_check_complete() const;
+	int64_t get_md5_total() const;
+	int64_t get_md5_checked_count() const;
+	int64_t get_md5_broken_count() const;
+
+	bool has_pending_batches() const;
+	// Empty if nothing is queued, otherwise {"files": Array[PackedFileInfo], "removed": PackedStringArray, "md5_checked": bool}.
+	// MD5 results are recorded on the files and in the file table here, so this must be called from the main thread.
+	Dictionary pop_batch();
+
+	~ProjectLoader();
+};
+
+VARIANT_ENUM_CAST(ProjectLoader::Status);
@@ -0,0 +1,188 @@
+#include "report_log.h"
+
+#include "core/io/json.h"
+#include "utility/common.h"
+
+using namespace gdre;
+
+Dictionary ReportLogWriter::make_record(const Ref<ExportReport> &p_report, const Vector<String> &p_categories) {
+	Dictionary record;
+	record["categories"] = p_categories;
+	if (p_report.is_null()) {
+		return record;
+	}
+	Ref<ImportInfo> iinfo = p_report->get_import_info();
+	record["path"] = iinfo.is_valid() ? iinfo->get_path() : p_report->get_source_path();
+	if (iinfo.is_valid()) {
+		record["importer"] = iinfo->get_importer();
+		record["type"] = iinfo->get_type();
+	}
+	record["source_path"] = p_report->get_source_path();
+	record["new_source_path"] = p_report->get_new_source_path();
+	record["saved_path"] = p_report->get_saved_path();
+	record["error"] = (int)p_report->get_error();
+	record["message"] = p_report->get_message();
+	record["message_detail"] = p_report->get_message_detail();
+	record["error_messages"] = p_report->get_error_messages();
+	record["loss_type"] = (int)p_report->get_loss_type();
+	record["rewrote_metadata"] = (int)p_report->get_rewrote_metadata();
+	if (!p_report->get_unsupported_format_type().is_empty()) {
+		record["unsupported_format_type"] = p_report->get_unsupported_format_type();
+	}
+	return record;
+}
+
+Error ReportLogWriter::open(const String &p_path) {
+	close();
+	Error err = gdre::ensure_dir(p_path.get_base_dir());
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Failed to create directory for report log " + p_path);
+	MutexLock lock(mutex);
+	file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err == OK ? ERR_FILE_CANT_OPEN : err, "Failed to open report log " + p_path);
+	path = p_path;
+	totals.clear();
+	buffer.clear();
+	return OK;
+}
+
+void ReportLogWriter::_flush_locked() {
+	if (file.is_valid() && buffer.size() > 0) {
+		file->store_buffer(buffer.ptr(), buffer.size());
+	}
+	buffer.clear();
+}
+
+void ReportLogWriter::append(const Ref<ExportReport> &p_report, const Vector<String> &p_categories) {
+	Dictionary record = make_record(p_report, p_categories);
+	CharString line = (JSON::stringify(record, "", false) + "\n").utf8();
+
+	MutexLock lock(mutex);
+	if (file.is_null()) {
+		return;
+	}
+	for (const String &category : p_categories) {
+		totals[category]++;
+	}
+	// like ImportExporterReport::get_totals, the total is the sum of the sections, so a file in several counts several times
+	totals["total"] += p_categories.size();
+	int64_t start = buffer.size();
+	buffer.resize(start + line.length());
+	memcpy(buffer.ptr() + start, line.get_data(), line.length());
+	if ((int64_t)buffer.size() >= FLUSH_THRESHOLD) {
+		_flush_locked();
+	}
+}
+
+void ReportLogWriter::add_to_totals(const String &p_category, int64_t p_count) {
+	MutexLock lock(mutex);
+	if (file.is_null() || p_count == 0) {
+		return;
+	}
+	totals[p_category] += p_count;
+	totals["total"] += p_count;
+}
+
+Dictionary ReportLogWriter::get_totals() {
+	MutexLock lock(mutex);
+	Dictionary ret;
+	for (const auto &E : totals) {
+		ret[E.key] = E.value;
+	}
+	return ret;
+}
+
+void ReportLogWriter::close() {
+	Dictionary final_totals = get_totals();
+	MutexLock lock(mutex);
+	if (file.is_null()) {
+		return;
+	}
+	Dictionary totals_record;
+	totals_record["totals"] = final_totals;
+	CharString line = (JSON::stringify(totals_record, "", false) + "\n").utf8();
+	_flush_locked();
+	file->store_buffer((const uint8_t *)line.get_data(), line.length());
+	file->close();
+	file.unref();
+}
+
+ReportLogWriter::~ReportLogWriter() {
+	close();
+}
+
+Error ReportLogReader::open(const String &p_path) {
+	offsets.clear();
+	totals.clear();
+	Error err;
+	file = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err == OK ? ERR_FILE_CANT_OPEN : err, "Failed to open report log " + p_path);
+
+	const uint64_t len = file->get_length();
+	uint8_t chunk[64 * 1024];
+	uint64_t pos = 0;
+	bool at_line_start = true;
+	while (pos < len) {
+		uint64_t read = file->get_buffer(chunk, MIN((uint64_t)sizeof(chunk), len - pos));
+		if (read == 0) {
+			break;
+		}
+		for (uint64_t i = 0; i < read; i++) {
+			if (at_line_start) {
+				offsets.push_back(pos + i);
+			}
+			at_line_start = chunk[i] == '\n';
+		}
+		pos += read;
+	}
+	// the writer ends the log with a totals record; a log from an interrupted run just won't have one
+	if (offsets.size() > 0) {
+		Dictionary last = JSON::parse_string(_get_line(offsets.size() - 1));
+		if (last.size() == 1 && last.has("totals")) {
+			totals = last["totals"];
+			offsets.resize(offsets.size() - 1);
+		}
+	}
+	return OK;
+}
+
+String ReportLogReader::_get_line(int64_t p_idx) const {
+	uint64_t end = (uint64_t)p_idx + 1 < offsets.size() ? offsets[p_idx + 1] : file->get_length();
+	uint64_t start = offsets[p_idx];
+	Vector<uint8_t> data;
+	data.resize(end - start);
+	file->seek(start);
+	file->get_buffer(data.ptrw(), data.size());
+	return String::utf8((const char *)data.ptr(), data.size()).strip_edges(false, true);
+}
+
+int64_t ReportLogReader::get_record_count() const {
+	return offsets.size();
+}
+
+Dictionary ReportLogReader::get_record(int64_t p_idx) const {
+	ERR_FAIL_COND_V(file.is_null(), Dictionary());
+	ERR_FAIL_INDEX_V(p_idx, (int64_t)offsets.size(), Dictionary());
+	return JSON::parse_string(_get_line(p_idx));
+}
+
+Array ReportLogReader::get_records(int64_t p_from, int64_t p_count) const {
+	Array ret;
+	ERR_FAIL_COND_V(file.is_null(), ret);
+	int64_t end = MIN(p_from + p_count, (int64_t)offsets.size());
+	for (int64_t i = MAX(p_from, 0); i < end; i++) {
+		ret.push_back(get_record(i));
+	}
+	return ret;
+}
+
+Dictionary ReportLogReader::get_totals() const {
+	return totals;
+}
+
+void ReportLogReader::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open", "path"), &ReportLogReader::open);
+	ClassDB::bind_method(D_METHOD("get_record_count"), &ReportLogReader::get_record_count);
+	ClassDB::bind_method(D_METHOD("get_record", "idx"), &ReportLogReader::get_record);
+	ClassDB::bind_method(D_METHOD("get_records", "from", "count"), &ReportLogReader::get_records);
+	ClassDB::bind_method(D_METHOD("get_totals"), &ReportLogReader::get_totals);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/io/file_access.h"
+#include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "exporters/export_report.h"
+
+// JSON-lines export report: one object per exported file with its final outcome, followed by a final
+// `{"totals": {...}}` line when the writer is closed. The totals match ImportExporterReport::get_totals.
+// This lets the report be streamed to disk and read back a page at a time, instead of building one
+// Dictionary/String over every entry at the end of the run.
+namespace gdre {
+
+class ReportLogWriter {
+	static constexpr int64_t FLUSH_THRESHOLD = 256 * 1024;
+
+	Mutex mutex;
+	Ref<FileAccess> file;
+	LocalVector<uint8_t> buffer;
+	HashMap<String, int64_t> totals;
+	String path;
+
+	void _flush_locked();
+
+public:
+	static Dictionary make_record(const Ref<ExportReport> &p_report, const Vector<String> &p_categories);
+
+	Error open(const String &p_path);
+	bool is_open() const { return file.is_valid(); }
+	String get_path() const { return path; }
+
+	// Thread-safe. The record is serialized on the calling thread; only the buffer append is locked.
+	// p_categories are the ImportExporterReport sections the file was added to, with the same names as its get_totals.
+	void append(const Ref<ExportReport> &p_report, const Vector<String> &p_categories);
+	// For sections that aren't made of exported files, e.g. unsupported type/format pairs.
+	void add_to_totals(const String &p_category, int64_t p_count);
+	Dictionary get_totals();
+	// Writes the totals line and closes the file.
+	void close();
+
+	~ReportLogWriter();
+};
+
+} // namespace gdre
+
+// Indexes the line offsets of a report log so records can be fetched by index without parsing the rest.
+class ReportLogReader : public RefCounted {
+	GDCLASS(ReportLogReader, RefCounted);
+
+	Ref<FileAccess> file;
+	LocalVector<uint64_t> offsets;
+	Dictionary totals;
+
+	String _get_line(int64_t p_idx) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error open(const String &p_path);
+	int64_t get_record_count() const;
+	Dictionary get_record(int64_t p_idx) const;
+	Array get_records(int64_t p_from, int64_t p_count) const;
+	Dictionary get_totals() const;
+};
@@ -72,14 +72,13 @@ public:
 			}
 			if (runs_current_thread) {
 				run_on_current_thread();
+			} else if (!Thread::is_main_thread()) {
+				// no progress to update off the main thread (see start_internal); just help the pool finish the task
+				wait_for_task_completion_internal();
 			} else {
-				bool is_main_thread = Thread::is_main_thread();
-				if (!is_main_thread) {
-					WARN_PRINT("Waiting for group task completion on non-main thread, progress will not be updated!");
-				}
 				while (!is_done()) {
 					OS::get_singleton()->delay_usec(10000);
-					update_progress(is_main_thread);
+					update_progress(true);
 					if (is_canceled()) {
 						break;
 					}
@@ -162,7 +161,8 @@ public:
 			} else {
 				task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &GroupTaskData::regular_task_callback, userdata, high_priority, task);
 			}
-			if (progress_enabled && progress.is_null()) {
+			// progress dialogs are UI; tasks started from worker threads (e.g. a background project load) run without one
+			if (progress_enabled && progress.is_null() && Thread::is_main_thread()) {
 				progress = EditorProgressGDDC::create(nullptr, task + itos(group_id), description, elements, can_cancel);
 			}
 		}
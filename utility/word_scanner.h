@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/string/ustring.h"
+#include "core/templates/hash_set.h"
+
+#include <cstring>
+
+namespace gdre {
+
+// Finds the same spans as RegEx::search_all with `PREFIX[\w\d<extra chars>]+`, optionally wrapped in
+// `\b` anchors, but over UTF-8 bytes and without allocating.
+// \w is ASCII-only, as it is in Godot's RegEx (compiled without UCP), so bytes >= 0x80 never match the
+// character class and never count as word characters. The prefix is matched literally.
+class WordScanner {
+	CharString prefix;
+	bool word_boundaries = false;
+	bool word_chars[256] = {};
+	bool class_chars[256] = {};
+
+	_FORCE_INLINE_ bool _is_boundary(const uint8_t *s, int64_t p_len, int64_t p_pos) const {
+		bool before = p_pos > 0 && word_chars[s[p_pos - 1]];
+		bool after = p_pos < p_len && word_chars[s[p_pos]];
+		return before != after;
+	}
+
+public:
+	WordScanner() {}
+
+	WordScanner(const String &p_prefix, const HashSet<char32_t> &p_extra_chars, bool p_word_boundaries) {
+		prefix = p_prefix.utf8();
+		word_boundaries = p_word_boundaries;
+		for (int c = 0; c < 128; c++) {
+			word_chars[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+			class_chars[c] = word_chars[c];
+		}
+		for (char32_t c : p_extra_chars) {
+			if (c < 128) {
+				class_chars[c] = true;
+			}
+		}
+	}
+
+	// Calls p_callback(const char *p_match, int64_t p_match_len) for each match, leftmost first and non-overlapping.
+	template <typename F>
+	void scan(const char *p_str, int64_t p_len, F &&p_callback) const {
+		const uint8_t *s = (const uint8_t *)p_str;
+		const int64_t plen = prefix.length();
+		int64_t i = 0;
+		// a match needs at least one class character after the prefix
+		while (i + plen < p_len) {
+			if (plen > 0) {
+				const void *found = memchr(s + i, (uint8_t)prefix[0], p_len - plen - i);
+				if (!found) {
+					return;
+				}
+				i = (const uint8_t *)found - s;
+				if (memcmp(s + i, prefix.get_data(), plen) != 0) {
+					i++;
+					continue;
+				}
+			}
+			if (word_boundaries && !_is_boundary(s, p_len, i)) {
+				i++;
+				continue;
+			}
+			int64_t j = i + plen;
+			while (j < p_len && class_chars[s[j]]) {
+				j++;
+			}
+			if (word_boundaries) {
+				// greedy, then backtrack to the longest run that ends on a boundary
+				while (j > i + plen && !_is_boundary(s, p_len, j)) {
+					j--;
+				}
+			}
+			if (j > i + plen) {
+				p_callback(p_str + i, j - i);
+				i = j;
+			} else {
+				i++;
+			}
+		}
+	}
+};
+
+} // namespace gdre